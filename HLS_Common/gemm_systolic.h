@@ -0,0 +1,275 @@
+// ================================================================
+// gemm_systolic.h  (systolic PE-grid GEMM core)
+//  - Alternative to gemm_mac_tile for the same A / B tile buffers:
+//    PR x PC processing elements, each one multiply-accumulate per
+//    cycle, operands move one PE per cycle between neighbours
+//
+//  - GEMM_SA_OS (output stationary):
+//      PE(r,c) owns C elements of NBLK = (TM/PR)*(TN/PC) sub-blocks.
+//      A enters at the left edge (row r skewed by r cycles) and moves
+//      right, B enters at the top (column c skewed by c) and moves
+//      down. Step s = k*NBLK + blk reaches PE(r,c) at cycle s + r + c.
+//      The accumulators stay in the PEs across all Ktiles frames and
+//      are read out once (gemm_sa_os_drain)
+//      Cycles per frame: TK*NBLK + PR + PC - 2
+//  - GEMM_SA_WS (weight stationary):
+//      PE(r,c) holds B(kb*PR + r, jb*PC + c) for one weight block.
+//      A rows enter at the left edge and move right; the partial sum
+//      of column c flows down through the PR PEs of the column (HLS
+//      registers it between PEs inside the pipelined iteration) and
+//      leaves at the bottom into C, skewed by c cycles
+//      Cycles per frame: (TK/PR)*(TN/PC)*(TM + PC - 1)
+//
+//  - Float accumulators: an accumulator is updated at most every
+//    GEMM_SA_LAT cycles (fadd latency at the target clock), so the
+//    loops keep II=1:
+//      OS: KS = ceil(GEMM_SA_LAT / NBLK) partial sums per C element,
+//          selected by k, added in the drain
+//      WS: C(i, j) is updated once per weight block (>= TM cycles)
+//
+//  - C simulation counts the pipelined loop iterations
+//    (gemm_sa_cycle_count(), excludes pipeline fill), for checking
+//    throughput against the PE count; gemm_sa_cycles<>() is the same
+//    number in closed form
+// ================================================================
+#ifndef GEMM_SYSTOLIC_H
+#define GEMM_SYSTOLIC_H
+
+#define GEMM_SA_OS 0
+#define GEMM_SA_WS 1
+
+#ifndef GEMM_SA_LAT
+#define GEMM_SA_LAT 4       // fadd latency (cycles) at 100 MHz on xc7z020
+#endif
+
+#ifndef __SYNTHESIS__
+inline long &gemm_sa_cycle_count() {
+    static long n = 0;
+    return n;
+}
+#define GEMM_SA_TICK() (gemm_sa_cycle_count()++)
+#else
+#define GEMM_SA_TICK()
+#endif
+
+// ---- Shape constants ----
+template<int TM, int TN, int PR, int PC>
+struct gemm_sa_shape {
+    static const int BR   = TM / PR;
+    static const int BC   = TN / PC;
+    static const int NBLK = BR * BC;
+    static const int KS   = (NBLK >= GEMM_SA_LAT) ? 1 : (GEMM_SA_LAT + NBLK - 1) / NBLK;
+    // DEPENDENCE distances (class constants so the pragmas can name them)
+    static const int OS_DIST = KS * NBLK;             // OS: cycles between updates of one accumulator
+    static const int WS_DIST = BC * (TM + PC - 1);    // WS: cycles between updates of one C element
+};
+
+// Cycles of one frame (TK-deep A / B tiles), pipeline fill not included
+template<int TM, int TN, int TK, int PR, int PC, int DF>
+static inline long gemm_sa_cycles() {
+    typedef gemm_sa_shape<TM, TN, PR, PC> S;
+    return (DF == GEMM_SA_OS) ? (long)TK * S::NBLK + PR + PC - 2
+                              : (long)(TK / PR) * S::BC * (TM + PC - 1);
+}
+
+// ==============================================================
+// Output stationary
+// ==============================================================
+
+// ---- Clear the PE accumulators (before the first frame) ----
+template<int TM, int TN, int PR, int PC, typename T>
+static void gemm_sa_os_clear(
+    T acc[gemm_sa_shape<TM, TN, PR, PC>::KS][gemm_sa_shape<TM, TN, PR, PC>::NBLK][PR][PC])
+{
+    typedef gemm_sa_shape<TM, TN, PR, PC> S;
+
+    for (int q = 0; q < S::KS * S::NBLK; q++) {
+#pragma HLS PIPELINE II=1
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+                acc[q / S::NBLK][q % S::NBLK][r][c] = 0;
+            }
+        }
+    }
+}
+
+// ---- One frame: acc += A * B through the PE grid ----
+// A partitioned by PR on dim 1, B by PC on dim 2 (skewed edge reads)
+template<int TM, int TN, int TK, int PR, int PC, typename T>
+static void gemm_sa_os_frame(
+    T A[TM][TK],
+    T B[TK][TN],
+    T acc[gemm_sa_shape<TM, TN, PR, PC>::KS][gemm_sa_shape<TM, TN, PR, PC>::NBLK][PR][PC])
+{
+    typedef gemm_sa_shape<TM, TN, PR, PC> S;
+    static_assert(TM % PR == 0 && TN % PC == 0, "PE grid must divide the C tile");
+    const int STEPS = TK * S::NBLK;
+
+#pragma HLS ARRAY_PARTITION variable=A cyclic factor=PR dim=1
+#pragma HLS ARRAY_PARTITION variable=B cyclic factor=PC dim=2
+#pragma HLS ARRAY_PARTITION variable=acc complete dim=3
+#pragma HLS ARRAY_PARTITION variable=acc complete dim=4
+
+    T a_reg[PR][PC];
+    T b_reg[PR][PC];
+#pragma HLS ARRAY_PARTITION variable=a_reg complete dim=0
+#pragma HLS ARRAY_PARTITION variable=b_reg complete dim=0
+
+    for (int t = 0; t < STEPS + PR + PC - 2; t++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=acc inter RAW distance=S::OS_DIST true
+        GEMM_SA_TICK();
+
+        // ---- shift: A one PE right, B one PE down ----
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            for (int c = PC-1; c > 0; c--) {
+#pragma HLS UNROLL
+                a_reg[r][c] = a_reg[r][c-1];
+            }
+        }
+        for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+            for (int r = PR-1; r > 0; r--) {
+#pragma HLS UNROLL
+                b_reg[r][c] = b_reg[r-1][c];
+            }
+        }
+
+        // ---- edges: row r / column c inject step t - r / t - c ----
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            int s = t - r;
+            T a = 0;
+            if (s >= 0 && s < STEPS) {
+                int blk = s % S::NBLK;
+                a = A[(blk / S::BC) * PR + r][s / S::NBLK];
+            }
+            a_reg[r][0] = a;
+        }
+        for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+            int s = t - c;
+            T b = 0;
+            if (s >= 0 && s < STEPS) {
+                int blk = s % S::NBLK;
+                b = B[s / S::NBLK][(blk % S::BC) * PC + c];
+            }
+            b_reg[0][c] = b;
+        }
+
+        // ---- PEs: step t - r - c ----
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+                int s = t - r - c;
+                if (s >= 0 && s < STEPS) {
+                    int k = s / S::NBLK;
+                    acc[k % S::KS][s % S::NBLK][r][c] += a_reg[r][c] * b_reg[r][c];
+                }
+            }
+        }
+    }
+}
+
+// ---- C = sum of the KS partial accumulators, one sub-block per cycle ----
+template<int TM, int TN, int PR, int PC, typename T>
+static void gemm_sa_os_drain(
+    T acc[gemm_sa_shape<TM, TN, PR, PC>::KS][gemm_sa_shape<TM, TN, PR, PC>::NBLK][PR][PC],
+    T C[TM][TN])
+{
+    typedef gemm_sa_shape<TM, TN, PR, PC> S;
+#pragma HLS ARRAY_PARTITION variable=C cyclic factor=PR dim=1
+#pragma HLS ARRAY_PARTITION variable=C cyclic factor=PC dim=2
+
+    for (int blk = 0; blk < S::NBLK; blk++) {
+#pragma HLS PIPELINE II=1
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+                T v = acc[0][blk][r][c];
+                for (int q = 1; q < S::KS; q++) {
+#pragma HLS UNROLL
+                    v += acc[q][blk][r][c];
+                }
+                C[(blk / S::BC) * PR + r][(blk % S::BC) * PC + c] = v;
+            }
+        }
+    }
+}
+
+// ==============================================================
+// Weight stationary: C += A * B
+// ==============================================================
+template<int TM, int TN, int TK, int PR, int PC, typename T>
+static void gemm_sa_ws_frame(
+    T A[TM][TK],
+    T B[TK][TN],
+    T C[TM][TN])
+{
+    typedef gemm_sa_shape<TM, TN, PR, PC> S;
+    static_assert(TK % PR == 0 && TN % PC == 0, "PE grid must divide the B tile");
+    const int KB   = TK / PR;
+    const int JB   = S::BC;                 // = TN / PC
+    const int TB   = TM + PC - 1;           // cycles per weight block
+
+#pragma HLS ARRAY_PARTITION variable=A cyclic factor=PR dim=2
+#pragma HLS ARRAY_PARTITION variable=B cyclic factor=PR dim=1
+#pragma HLS ARRAY_PARTITION variable=B cyclic factor=PC dim=2
+#pragma HLS ARRAY_PARTITION variable=C cyclic factor=PC dim=2
+
+    T w_reg[PR][PC];
+    T a_reg[PR][PC];
+#pragma HLS ARRAY_PARTITION variable=w_reg complete dim=0
+#pragma HLS ARRAY_PARTITION variable=a_reg complete dim=0
+
+    for (int q = 0; q < KB * JB * TB; q++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=C inter RAW distance=S::WS_DIST true
+        GEMM_SA_TICK();
+
+        int blk = q / TB;
+        int t   = q % TB;
+        int kb  = blk / JB;
+        int jb  = blk % JB;
+
+        // ---- new weight block: one B(kb, jb) sub-block into the PEs ----
+        if (t == 0) {
+            for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+                for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+                    w_reg[r][c] = B[kb*PR + r][jb*PC + c];
+                }
+            }
+        }
+
+        // ---- shift A one PE right, inject row t at the left edge ----
+        for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+            for (int c = PC-1; c > 0; c--) {
+#pragma HLS UNROLL
+                a_reg[r][c] = a_reg[r][c-1];
+            }
+            a_reg[r][0] = (t < TM) ? A[t][kb*PR + r] : (T)0;
+        }
+
+        // ---- column c: partial sum down the PEs, row t - c leaves ----
+        for (int c = 0; c < PC; c++) {
+#pragma HLS UNROLL
+            T psum = 0;
+            for (int r = 0; r < PR; r++) {
+#pragma HLS UNROLL
+                psum += a_reg[r][c] * w_reg[r][c];
+            }
+            int i = t - c;
+            if (i >= 0 && i < TM) C[i][jb*PC + c] += psum;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,323 @@
+// ================================================================
+// gemm_tile.h  (shared HLS GEMM tile generator)
+//  - One template for the tile kernels that used to be hand-copied
+//    per design (gemm8_accel, gemm16_accel, gemm16_accum_axis):
+//      TM x TN output tile, TK-deep A / B tiles, KCHUNK-wide adder
+//      trees, element type T, accumulation mode, single / double
+//      buffered, W-bit AXIS
+//  - Building blocks, also used on their own (Matmul_4, Matmul_7):
+//      u32_to_f / f_to_u32     CSIM-safe float bitcast (memcpy)
+//      gemm_word<T>            T <-> 32-bit stream word
+//      gemm_tree<T, LO, CNT>   compile-time balanced adder tree over
+//                              p[LO..LO+CNT); CNT = 8 gives exactly the
+//                              old reduce8_tree order
+//      gemm_mac_tile<...>      C += A * B, one C element per cycle,
+//                              TK products per cycle in TK/KCHUNK trees
+//
+//  - gemm_tile_axis<TM, TN, TK, KCHUNK, T, ACC, DB, W>(s_in, s_out, Ktiles)
+//    complete stream kernel, inlined into a top function that owns
+//    the INTERFACE pragmas:
+//      GEMM_ACC_NONE : frame A + B          -> C = A*B          (Matmul_2)
+//      GEMM_ACC_CIN  : frame A + B + C_in   -> C = C_in + A*B   (Matmul_1)
+//      GEMM_ACC_PL   : Ktiles frames A + B  -> C = sum_k A*B    (Matmul_3)
+//    DB (GEMM_ACC_PL only): recv of frame k+1 || MAC of frame k, one
+//    DATAFLOW region of frame-looping processes with stream_of_blocks
+//    ping-pong buffers (Matmul_4 structure)
+//    Tiles are row-major, WPB = W/32 elements per beat (element l in
+//    [32l+31:32l]), so TK and TN must be multiples of WPB.
+//    C: TM*TN/WPB beats, TLAST on the last beat
+//
+//  - Cost per frame (cycles): recv (TM*TK + TK*TN) / WPB, MAC TM*TN;
+//    multipliers TK, adders TK-1 (+1 accumulate)
+//
+//  - Include path: add HLS_Common to the kernel cflags
+//    (Vitis: add_files ... -cflags "-I../HLS_Common")
+// ================================================================
+#ifndef GEMM_TILE_H
+#define GEMM_TILE_H
+
+#include <hls_stream.h>
+#include <ap_int.h>
+#include <ap_axi_sdata.h>
+#include <hls_streamofblocks.h>
+#include <cstring>
+#include <stdint.h>
+
+#define GEMM_ACC_NONE 0
+#define GEMM_ACC_CIN  1
+#define GEMM_ACC_PL   2
+
+template<int W> using axis_w = ap_axiu<W, 0, 0, 0>;
+
+// ------------------------------
+// CSIM-safe bit reinterpretation
+// ------------------------------
+static inline float u32_to_f(ap_uint<32> u) {
+#pragma HLS INLINE
+    float f;
+    uint32_t tmp = (uint32_t)u.to_uint();
+    std::memcpy(&f, &tmp, sizeof(float));
+    return f;
+}
+static inline ap_uint<32> f_to_u32(float f) {
+#pragma HLS INLINE
+    uint32_t tmp;
+    std::memcpy(&tmp, &f, sizeof(uint32_t));
+    return ap_uint<32>(tmp);
+}
+
+// ------------------------------
+// Element <-> stream word: float bit pattern, integers as int32
+// ------------------------------
+template<typename T>
+struct gemm_word {
+    static T from(ap_uint<32> u) {
+#pragma HLS INLINE
+        return (T)(int32_t)(uint32_t)u.to_uint();
+    }
+    static ap_uint<32> to(T v) {
+#pragma HLS INLINE
+        return ap_uint<32>((uint32_t)(int32_t)v);
+    }
+};
+
+template<>
+struct gemm_word<float> {
+    static float from(ap_uint<32> u) {
+#pragma HLS INLINE
+        return u32_to_f(u);
+    }
+    static ap_uint<32> to(float v) {
+#pragma HLS INLINE
+        return f_to_u32(v);
+    }
+};
+
+// ------------------------------
+// Balanced adder tree: sum of p[LO .. LO+CNT), depth ceil(log2 CNT)
+// ------------------------------
+template<typename T, int LO, int CNT>
+struct gemm_tree {
+    static T sum(const T p[]) {
+#pragma HLS INLINE
+        return gemm_tree<T, LO, CNT/2>::sum(p) + gemm_tree<T, LO + CNT/2, CNT - CNT/2>::sum(p);
+    }
+};
+
+template<typename T, int LO>
+struct gemm_tree<T, LO, 1> {
+    static T sum(const T p[]) {
+#pragma HLS INLINE
+        return p[LO];
+    }
+};
+
+// ------------------------------
+// MAC: C += A * B, KCHUNK products per tree, TK/KCHUNK trees per cycle
+// ------------------------------
+template<int TM, int TN, int TK, int KCHUNK, typename T>
+static void gemm_mac_tile(
+    T A[TM][TK],
+    T B[TK][TN],
+    T C[TM][TN])
+{
+#pragma HLS ARRAY_PARTITION variable=A complete dim=2
+#pragma HLS ARRAY_PARTITION variable=B complete dim=1
+#pragma HLS ARRAY_PARTITION variable=C complete dim=2
+    static_assert(TK % KCHUNK == 0, "KCHUNK must divide TK");
+
+    for (int i = 0; i < TM; i++) {
+        for (int j = 0; j < TN; j++) {
+#pragma HLS PIPELINE II=1
+
+            T sum = 0;
+
+            for (int kb = 0; kb < TK; kb += KCHUNK) {
+#pragma HLS UNROLL
+                T p[KCHUNK];
+#pragma HLS ARRAY_PARTITION variable=p complete
+                for (int l = 0; l < KCHUNK; l++) {
+#pragma HLS UNROLL
+                    p[l] = A[i][kb+l] * B[kb+l][j];
+                }
+                sum += gemm_tree<T, 0, KCHUNK>::sum(p);
+            }
+
+            C[i][j] += sum;
+        }
+    }
+}
+
+// ------------------------------
+// R x CL row-major tile <-> stream, WPB elements per beat
+// ------------------------------
+template<int R, int CL, int W, typename T>
+static void gemm_recv_tile(
+    hls::stream<axis_w<W> >& s_in,
+    T                        M[R][CL])
+{
+    const int WPB = W / 32;
+#pragma HLS ARRAY_PARTITION variable=M cyclic factor=WPB dim=2
+
+    for (int i = 0; i < R; i++) {
+        for (int j = 0; j < CL; j += WPB) {
+#pragma HLS PIPELINE II=1
+            axis_w<W> w = s_in.read();
+            for (int l = 0; l < WPB; l++) {
+#pragma HLS UNROLL
+                M[i][j+l] = gemm_word<T>::from(w.data.range(32*l+31, 32*l));
+            }
+        }
+    }
+}
+
+template<int R, int CL, int W, typename T>
+static void gemm_send_tile(
+    hls::stream<axis_w<W> >& s_out,
+    T                        M[R][CL])
+{
+    const int WPB = W / 32;
+
+    for (int i = 0; i < R; i++) {
+        for (int j = 0; j < CL; j += WPB) {
+#pragma HLS PIPELINE II=1
+            axis_w<W> o;
+            for (int l = 0; l < WPB; l++) {
+#pragma HLS UNROLL
+                o.data.range(32*l+31, 32*l) = gemm_word<T>::to(M[i][j+l]);
+            }
+            o.keep = -1;
+            o.strb = -1;
+            o.user = 0;
+            o.id   = 0;
+            o.dest = 0;
+            o.last = ((i == R-1) && (j == CL-WPB)) ? 1 : 0;
+            s_out.write(o);
+        }
+    }
+}
+
+// ---- One A + B frame (DATAFLOW producer in the DB kernel) ----
+template<int TM, int TN, int TK, int W, typename T>
+static void gemm_recv_frame(
+    hls::stream<axis_w<W> >& s_in,
+    T                        A[TM][TK],
+    T                        B[TK][TN])
+{
+    gemm_recv_tile<TM, TK, W, T>(s_in, A);
+    gemm_recv_tile<TK, TN, W, T>(s_in, B);
+}
+
+// ------------------------------
+// Double buffering: recv -> MAC -> send task pipeline over nframes
+// ------------------------------
+template<int TM, int TN, int TK, typename T>
+struct gemm_blocks {
+    typedef T a_t[TM][TK];
+    typedef T b_t[TK][TN];
+};
+
+template<int TM, int TN, int TK, int W, typename T>
+static void gemm_recv_frames(
+    hls::stream<axis_w<W> >&                                          s_in,
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::a_t>&  a_blocks,
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::b_t>&  b_blocks,
+    int                                                               nframes)
+{
+    for (int k = 0; k < nframes; k++) {
+        hls::write_lock<typename gemm_blocks<TM, TN, TK, T>::a_t> A(a_blocks);
+        hls::write_lock<typename gemm_blocks<TM, TN, TK, T>::b_t> B(b_blocks);
+        gemm_recv_frame<TM, TN, TK, W, T>(s_in, A, B);
+    }
+}
+
+template<int TM, int TN, int TK, int KCHUNK, typename T>
+static void gemm_mac_frames(
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::a_t>&  a_blocks,
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::b_t>&  b_blocks,
+    T                                                                 C[TM][TN],
+    int                                                               nframes)
+{
+    for (int i = 0; i < TM; i++) {
+        for (int j = 0; j < TN; j++) {
+#pragma HLS PIPELINE II=1
+            C[i][j] = 0;
+        }
+    }
+    for (int k = 0; k < nframes; k++) {
+        hls::read_lock<typename gemm_blocks<TM, TN, TK, T>::a_t> A(a_blocks);
+        hls::read_lock<typename gemm_blocks<TM, TN, TK, T>::b_t> B(b_blocks);
+        gemm_mac_tile<TM, TN, TK, KCHUNK, T>(A, B, C);
+    }
+}
+
+template<int TM, int TN, int TK, int KCHUNK, typename T, int W>
+static void gemm_db_pipeline(
+    hls::stream<axis_w<W> >& s_in,
+    hls::stream<axis_w<W> >& s_out,
+    int                      nframes)
+{
+#pragma HLS DATAFLOW
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::a_t> a_blocks;   // depth 2 = ping-pong
+    hls::stream_of_blocks<typename gemm_blocks<TM, TN, TK, T>::b_t> b_blocks;
+    T C[TM][TN];
+
+    gemm_recv_frames<TM, TN, TK, W, T>(s_in, a_blocks, b_blocks, nframes);
+    gemm_mac_frames<TM, TN, TK, KCHUNK, T>(a_blocks, b_blocks, C, nframes);
+    gemm_send_tile<TM, TN, W, T>(s_out, C);
+}
+
+// ==============================================================
+// Stream kernel generator
+// ==============================================================
+template<int TM, int TN, int TK, int KCHUNK, typename T, int ACC, bool DB, int W>
+static void gemm_tile_axis(
+    hls::stream<axis_w<W> >& s_in,
+    hls::stream<axis_w<W> >& s_out,
+    int Ktiles
+){
+#pragma HLS INLINE
+    const int WPB = W / 32;
+    static_assert(W == 32 || W == 64 || W == 128, "W must be 32, 64 or 128");
+    static_assert(TK % WPB == 0 && TN % WPB == 0, "tile rows must fill whole beats");
+    static_assert(!DB || ACC == GEMM_ACC_PL, "double buffering needs GEMM_ACC_PL");
+
+    const int nframes = (ACC == GEMM_ACC_PL) ? Ktiles : 1;
+
+    if (nframes <= 0) return;
+
+    if (DB) {
+        // ---- recv frame k+1 || MAC frame k ----
+        gemm_db_pipeline<TM, TN, TK, KCHUNK, T, W>(s_in, s_out, nframes);
+        return;
+    }
+
+    T C[TM][TN];
+#pragma HLS ARRAY_PARTITION variable=C complete dim=2
+
+    if (ACC != GEMM_ACC_CIN) {
+        for (int i = 0; i < TM; i++) {
+            for (int j = 0; j < TN; j++) {
+#pragma HLS PIPELINE II=1
+                C[i][j] = 0;
+            }
+        }
+    }
+
+    // ---- recv frame, then MAC (sequential) ----
+    T A[TM][TK];
+    T B[TK][TN];
+#pragma HLS ARRAY_PARTITION variable=A complete dim=2
+#pragma HLS ARRAY_PARTITION variable=B complete dim=1
+#pragma HLS ARRAY_PARTITION variable=B cyclic factor=4 dim=2
+
+    for (int kt = 0; kt < nframes; kt++) {
+        gemm_recv_frame<TM, TN, TK, W, T>(s_in, A, B);
+        if (ACC == GEMM_ACC_CIN) gemm_recv_tile<TM, TN, W, T>(s_in, C);
+        gemm_mac_tile<TM, TN, TK, KCHUNK, T>(A, B, C);
+    }
+
+    gemm_send_tile<TM, TN, W, T>(s_out, C);
+}
+
+#endif
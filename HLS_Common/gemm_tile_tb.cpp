@@ -0,0 +1,148 @@
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <hls_stream.h>
+#include <ap_axi_sdata.h>
+#include <ap_int.h>
+
+#include "gemm_tile.h"
+
+typedef axis_w<32> axis_t;
+
+// DUT prototypes (gemm_tile_variants.cpp)
+void gemm32_accum_axis_db(hls::stream<axis_t>& s_in, hls::stream<axis_t>& s_out, int Ktiles);
+void gemm8x32_accum_axis_db(hls::stream<axis_t>& s_in, hls::stream<axis_t>& s_out, int Ktiles);
+
+// =====================================================
+// Stream helpers: WPB elements per beat, one segment per tile
+// =====================================================
+template<int W, typename T>
+static void push_tile(hls::stream<axis_w<W> >& s, const std::vector<T>& m, int rows, int cols)
+{
+    const int WPB = W / 32;
+    for(int i=0;i<rows;i++)
+        for(int j=0;j<cols;j+=WPB){
+            axis_w<W> w;
+            for(int l=0;l<WPB;l++)
+                w.data.range(32*l+31, 32*l) = gemm_word<T>::to(m[i*cols + j+l]);
+            w.keep = -1;
+            w.strb = -1;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = (i == rows-1 && j == cols-WPB) ? 1 : 0;
+            s.write(w);
+        }
+}
+
+// Element values are small integers, so every summation order gives
+// the exact result and float / int compare bit for bit
+template<typename T>
+static std::vector<T> rand_tile(int n)
+{
+    std::vector<T> m(n);
+    for(int i=0;i<n;i++) m[i] = (T)(rand() % 9 - 4);
+    return m;
+}
+
+// =====================================================
+// One generated kernel vs CPU reference
+// (dut == 0: call gemm_tile_axis directly)
+// =====================================================
+template<int TM, int TN, int TK, int KCHUNK, typename T, int ACC, bool DB, int W>
+static bool run_case(const char *name, int Ktiles,
+                     void (*dut)(hls::stream<axis_w<W> >&, hls::stream<axis_w<W> >&, int) = 0)
+{
+    const int WPB = W / 32;
+    const int nframes = (ACC == GEMM_ACC_PL) ? Ktiles : 1;
+    hls::stream<axis_w<W> > s_in, s_out;
+    std::vector<T> ref(TM*TN, (T)0);
+
+    for(int kt=0; kt<nframes; kt++){
+        std::vector<T> A = rand_tile<T>(TM*TK), B = rand_tile<T>(TK*TN);
+        push_tile<W, T>(s_in, A, TM, TK);
+        push_tile<W, T>(s_in, B, TK, TN);
+        if (ACC == GEMM_ACC_CIN) {
+            std::vector<T> Cin = rand_tile<T>(TM*TN);
+            push_tile<W, T>(s_in, Cin, TM, TN);
+            ref = Cin;
+        }
+        for(int i=0;i<TM;i++)
+            for(int j=0;j<TN;j++)
+                for(int k=0;k<TK;k++)
+                    ref[i*TN+j] += A[i*TK+k] * B[k*TN+j];
+    }
+
+    if (dut) dut(s_in, s_out, Ktiles);
+    else     gemm_tile_axis<TM, TN, TK, KCHUNK, T, ACC, DB, W>(s_in, s_out, Ktiles);
+
+    const int beats = (nframes > 0) ? TM*TN/WPB : 0;
+    if(!s_in.empty() || (int)s_out.size() != beats){
+        std::cout << name << ": stream size mismatch (out " << s_out.size() << ")\n";
+        return false;
+    }
+
+    int bad = 0;
+    bool tlast_ok = true;
+    for(int b=0; b<beats; b++){
+        axis_w<W> o = s_out.read();
+        if((int)o.last != (b == beats-1 ? 1 : 0)) tlast_ok = false;
+        for(int l=0;l<WPB;l++)
+            if(gemm_word<T>::from(o.data.range(32*l+31, 32*l)) != ref[b*WPB + l]) bad++;
+    }
+    std::cout << name << ": " << beats << " beats, mismatches = " << bad << "\n";
+    if(!tlast_ok) std::cout << name << ": TLAST placement mismatch\n";
+    return bad == 0 && tlast_ok;
+}
+
+// gemm_tree<float, 0, 8> must keep the old reduce8_tree order bit for bit
+static bool check_tree_order()
+{
+    int bad = 0;
+    for(int t=0;t<1000;t++){
+        float p[8];
+        for(int l=0;l<8;l++) p[l] = (float)rand() / RAND_MAX * 2e3f - 1e3f;
+        float old = ((p[0]+p[1]) + (p[2]+p[3])) + ((p[4]+p[5]) + (p[6]+p[7]));
+        float gen = gemm_tree<float, 0, 8>::sum(p);
+        if (std::memcmp(&old, &gen, sizeof(float)) != 0) bad++;
+    }
+    std::cout << "gemm_tree<8> vs reduce8_tree: mismatches = " << bad << "\n";
+    return bad == 0;
+}
+
+// =====================================================
+// Main Testbench
+// =====================================================
+int main()
+{
+    std::cout << "\n===== GEMM_TILE GENERATOR CSIM TEST =====\n";
+
+    srand(5);
+    bool ok = check_tree_order();
+
+    // existing variants
+    ok &= run_case<8, 8, 8, 8, float, GEMM_ACC_CIN, false, 32>  ("gemm8 (C_in)         ", 1);
+    ok &= run_case<16,16,16, 1, float, GEMM_ACC_NONE, false, 32>("gemm16 (host accum)  ", 1);
+    ok &= run_case<16,16,16, 8, float, GEMM_ACC_PL, false, 32>  ("gemm16 accum         ", 3);
+    ok &= run_case<16,16,16, 8, float, GEMM_ACC_PL, false, 128> ("gemm16 accum x128    ", 3);
+    ok &= run_case<16,16,16, 8, float, GEMM_ACC_PL, true, 32>   ("gemm16 accum db      ", 3);
+    ok &= run_case<16,16,16, 8, float, GEMM_ACC_PL, true, 64>   ("gemm16 accum db x64  ", 2);
+
+    // new tile shapes (top functions)
+    ok &= run_case<32,32,32, 8, float, GEMM_ACC_PL, true, 32>("gemm32 db            ", 3, gemm32_accum_axis_db);
+    ok &= run_case< 8,32, 8, 8, float, GEMM_ACC_PL, true, 32>("gemm8x32 db          ", 4, gemm8x32_accum_axis_db);
+
+    // other parameters: non power-of-two tree, int32, Ktiles = 0
+    ok &= run_case<12,12,24, 6, float, GEMM_ACC_PL, true, 32>("12x12x24 KCHUNK 6    ", 2);
+    ok &= run_case<16,16,16, 16, int, GEMM_ACC_PL, false, 32>("int32 16x16 KCHUNK 16", 3);
+    ok &= run_case<16,16,16, 8, float, GEMM_ACC_PL, true, 32>("Ktiles = 0           ", 0);
+
+    if(ok)
+        std::cout << "\nPASS ✅\n";
+    else
+        std::cout << "\nFAIL ❌\n";
+
+    return 0;
+}
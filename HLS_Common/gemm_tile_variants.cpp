@@ -0,0 +1,51 @@
+// ================================================================
+// gemm_tile_variants.cpp  (extra gemm_tile_axis instances)
+//  - Same protocol as Matmul_4's fp32 32-bit stream (Ktiles frames
+//    of A + B, double buffered, C once with TLAST), other tile shapes
+//    for area / throughput sweeps:
+//
+//    top                       TM x TN x TK  fmul  recv / MAC per frame
+//    gemm32_accum_axis_db      32 x 32 x 32   32     2048 / 1024 cycles
+//    gemm8x32_accum_axis_db     8 x 32 x  8    8      320 /  256 cycles
+//    (gemm16_accum_axis_db     16 x 16 x 16   16      512 /  256 cycles)
+//
+//  - Frame = A (TM x TK) then B (TK x TN), row-major; C = TM x TN
+//  - AXI-Lite control: Ktiles
+// ================================================================
+
+#include <hls_stream.h>
+#include <ap_int.h>
+#include <ap_axi_sdata.h>
+#include <stdint.h>
+
+#include "gemm_tile.h"
+
+typedef axis_w<32> axis_t;
+
+// 32x32 tile, K 32 per frame (4 trees of 8 per cycle)
+void gemm32_accum_axis_db(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int Ktiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    gemm_tile_axis<32, 32, 32, 8, float, GEMM_ACC_PL, true, 32>(s_in, s_out, Ktiles);
+}
+
+// 8 x 32 output tile, K 8 per frame (one tree of 8 per cycle)
+void gemm8x32_accum_axis_db(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int Ktiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    gemm_tile_axis<8, 32, 8, 8, float, GEMM_ACC_PL, true, 32>(s_in, s_out, Ktiles);
+}
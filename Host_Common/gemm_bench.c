@@ -0,0 +1,212 @@
+/********************************************************************
+ * gemm_bench.c
+ *  - Samples are kept per point (GEMM_BENCH_MAX_REPS doubles) and
+ *    sorted once; no allocation, so it runs on the standalone BSP
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xparameters.h"
+#include "xtime_l.h"
+
+#include "gemm_bench.h"
+
+static const char *csv_header =
+    "tag,m,n,k,variant,reps,min_us,median_us,p95_us,p99_us,max_us,mean_us,gflops,bytes,gbps,max_abs_err";
+
+static inline double ticks_to_us(XTime c){
+    return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+}
+
+void gemm_bench_defaults(gemm_bench_cfg_t *cfg){
+    static const int sizes[] = { 32, 64, 128, 256 };
+
+    memset(cfg, 0, sizeof(*cfg));
+    memcpy(cfg->sizes, sizes, sizeof(sizes));
+    cfg->nsizes      = sizeof(sizes) / sizeof(sizes[0]);
+    cfg->variants[0] = 1;
+    cfg->nvariants   = 1;
+    cfg->warmup      = 2;
+    cfg->reps        = 20;
+    cfg->tag         = "dev";
+    cfg->csv         = "-";
+    cfg->json        = NULL;
+}
+
+// "32,64,128" -> list; -1 on an empty / non-positive / too long list
+static int parse_list(const char *s, int *list){
+    int n = 0;
+    while (*s) {
+        char *end;
+        long v = strtol(s, &end, 10);
+        if (end == s || v <= 0 || n == GEMM_BENCH_MAX_LIST) return -1;
+        list[n++] = (int)v;
+        s = (*end == ',') ? end + 1 : end;
+        if (end == s && *s) return -1;
+    }
+    return n ? n : -1;
+}
+
+int gemm_bench_parse(gemm_bench_cfg_t *cfg, int argc, char **argv){
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        int n;
+
+        if (!val) {
+            printf("bench: %s needs a value\n", opt);
+            return -1;
+        }
+        i++;
+        if (!strcmp(opt, "--sizes")) {
+            if ((n = parse_list(val, cfg->sizes)) < 0) goto bad;
+            cfg->nsizes = n;
+        } else if (!strcmp(opt, "--variants")) {
+            if ((n = parse_list(val, cfg->variants)) < 0) goto bad;
+            cfg->nvariants = n;
+        } else if (!strcmp(opt, "--warmup")) {
+            cfg->warmup = atoi(val);
+            if (cfg->warmup < 0) goto bad;
+        } else if (!strcmp(opt, "--reps")) {
+            cfg->reps = atoi(val);
+            if (cfg->reps < 1 || cfg->reps > GEMM_BENCH_MAX_REPS) goto bad;
+        } else if (!strcmp(opt, "--tag")) {
+            cfg->tag = val;
+        } else if (!strcmp(opt, "--csv")) {
+            cfg->csv = strcmp(val, "none") ? val : NULL;
+        } else if (!strcmp(opt, "--json")) {
+            cfg->json = strcmp(val, "none") ? val : NULL;
+        } else {
+            printf("bench: unknown option %s\n", opt);
+            return -1;
+        }
+        continue;
+bad:
+        printf("bench: bad value %s for %s\n", val, opt);
+        return -1;
+    }
+    return 0;
+}
+
+static int cmp_double(const void *a, const void *b){
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank: smallest sample with at least p% of the samples <= it
+static double pct(const double *sorted, int n, int p){
+    int r = (p * n + 99) / 100;
+    return sorted[(r < 1 ? 1 : r) - 1];
+}
+
+int gemm_bench_time(const gemm_bench_cfg_t *cfg, int (*run)(void *ctx), void *ctx,
+                    gemm_bench_result_t *r){
+    static double us[GEMM_BENCH_MAX_REPS];
+    int reps = (cfg->reps > GEMM_BENCH_MAX_REPS) ? GEMM_BENCH_MAX_REPS : cfg->reps;
+    double sum = 0.0;
+    int rc;
+
+    for (int i = 0; i < cfg->warmup; i++)
+        if ((rc = run(ctx)) != 0) return rc;
+
+    for (int i = 0; i < reps; i++) {
+        XTime t0, t1;
+        XTime_GetTime(&t0);
+        rc = run(ctx);
+        XTime_GetTime(&t1);
+        if (rc != 0) return rc;
+        us[i] = ticks_to_us(t1 - t0);
+        sum += us[i];
+    }
+
+    qsort(us, reps, sizeof(us[0]), cmp_double);
+    r->reps    = reps;
+    r->min_us  = us[0];
+    r->med_us  = pct(us, reps, 50);
+    r->p95_us  = pct(us, reps, 95);
+    r->p99_us  = pct(us, reps, 99);
+    r->max_us  = us[reps - 1];
+    r->mean_us = sum / reps;
+    return 0;
+}
+
+void gemm_bench_rates(gemm_bench_result_t *r){
+    double flops = 2.0 * (double)r->m * (double)r->n * (double)r->k;
+    r->gflops = flops / (r->med_us * 1e3);
+    r->gbps   = r->bytes / (r->med_us * 1e3);
+}
+
+void gemm_bench_print(const gemm_bench_result_t *r, int first){
+    if (first)
+        printf("%5s %5s %5s %3s %10s %10s %10s %10s %8s %10s %7s %9s\n",
+               "M", "N", "K", "var", "min us", "median us", "p95 us", "p99 us",
+               "GFLOPS", "MB moved", "GB/s", "max_err");
+    printf("%5d %5d %5d %3d %10.3f %10.3f %10.3f %10.3f %8.3f %10.3f %7.3f %9.6f\n",
+           r->m, r->n, r->k, r->variant, r->min_us, r->med_us, r->p95_us, r->p99_us,
+           r->gflops, r->bytes / 1e6, r->gbps, r->max_err);
+}
+
+// path "-": stdout with a line prefix, otherwise the file (stdout fallback
+// when it cannot be opened, e.g. standalone BSP)
+static FILE *report_open(const char *path, const char **prefix, const char *stdout_prefix){
+    FILE *f = NULL;
+
+    *prefix = "";
+#ifdef __linux__
+    if (strcmp(path, "-")) {
+        f = fopen(path, "w");
+        if (!f) printf("bench: cannot write %s, report on stdout\n", path);
+    }
+#endif
+    if (!f) {
+        f = stdout;
+        *prefix = stdout_prefix;
+    }
+    return f;
+}
+
+static void report_close(FILE *f, const char *path){
+    if (f != stdout) {
+        fclose(f);
+        printf("bench: wrote %s\n", path);
+    }
+}
+
+int gemm_bench_write_csv(const gemm_bench_cfg_t *cfg, const gemm_bench_result_t *r, int n){
+    const char *pre;
+    FILE *f;
+
+    if (!cfg->csv) return 0;
+    f = report_open(cfg->csv, &pre, "csv,");
+    fprintf(f, "%s%s\n", pre, csv_header);
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s%s,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.4f,%.0f,%.4f,%.6g\n",
+                pre, cfg->tag, r[i].m, r[i].n, r[i].k, r[i].variant, r[i].reps,
+                r[i].min_us, r[i].med_us, r[i].p95_us, r[i].p99_us, r[i].max_us, r[i].mean_us,
+                r[i].gflops, r[i].bytes, r[i].gbps, r[i].max_err);
+    report_close(f, cfg->csv);
+    return 0;
+}
+
+int gemm_bench_write_json(const gemm_bench_cfg_t *cfg, const gemm_bench_result_t *r, int n){
+    const char *pre;
+    FILE *f;
+
+    if (!cfg->json) return 0;
+    f = report_open(cfg->json, &pre, "json ");
+    fprintf(f, "%s{\"tag\": \"%s\", \"warmup\": %d, \"reps\": %d, \"results\": [\n",
+            pre, cfg->tag, cfg->warmup, cfg->reps);
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s  {\"m\": %d, \"n\": %d, \"k\": %d, \"variant\": %d, \"reps\": %d, "
+                "\"min_us\": %.3f, \"median_us\": %.3f, \"p95_us\": %.3f, \"p99_us\": %.3f, "
+                "\"max_us\": %.3f, \"mean_us\": %.3f, \"gflops\": %.4f, \"bytes\": %.0f, "
+                "\"gbps\": %.4f, \"max_abs_err\": %.6g}%s\n",
+                pre, r[i].m, r[i].n, r[i].k, r[i].variant, r[i].reps,
+                r[i].min_us, r[i].med_us, r[i].p95_us, r[i].p99_us, r[i].max_us, r[i].mean_us,
+                r[i].gflops, r[i].bytes, r[i].gbps, r[i].max_err, (i + 1 < n) ? "," : "");
+    fprintf(f, "%s]}\n", pre);
+    report_close(f, cfg->json);
+    return 0;
+}
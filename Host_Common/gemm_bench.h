@@ -0,0 +1,73 @@
+/********************************************************************
+ * gemm_bench.h
+ *  - Benchmark driver helpers for the host programs: shape / variant
+ *    sweep lists, warm-up + R timed repetitions, latency percentiles,
+ *    GFLOPS and bytes moved, CSV / JSON report
+ *  - The host owns the GEMM: gemm_bench_time() calls back one complete
+ *    run (pack + HW + unpack) per repetition
+ *  - Percentiles: nearest rank over the sorted samples (p50 = median)
+ *  - Report files: fopen on Linux (Host_Emu / PetaLinux); on the
+ *    standalone BSP there is no file system, the same lines go to the
+ *    UART with a "csv," / "json " prefix for grep
+ *  - Timing: XTime (A9 global timer, Host_Emu: host clock)
+ ********************************************************************/
+#ifndef GEMM_BENCH_H
+#define GEMM_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEMM_BENCH_MAX_LIST  16     // N / variant list length
+#define GEMM_BENCH_MAX_REPS  256    // timed repetitions per point
+
+typedef struct {
+    int         sizes[GEMM_BENCH_MAX_LIST];    // N sweep (square M = N = K)
+    int         nsizes;
+    int         variants[GEMM_BENCH_MAX_LIST]; // host-defined tile variant (Matmul_4: cblock)
+    int         nvariants;
+    int         warmup;                        // untimed runs per point
+    int         reps;                          // timed runs per point
+    const char *tag;                           // kernel / build label in the report
+    const char *csv;                           // path, "-": UART / stdout, NULL ("none"): off
+    const char *json;
+} gemm_bench_cfg_t;
+
+// One (shape, variant) point
+typedef struct {
+    int    m, n, k, variant;
+    int    reps;
+    double min_us, med_us, p95_us, p99_us, max_us, mean_us;
+    double gflops;          // 2*M*N*K / median
+    double bytes;           // MM2S + S2MM bytes of one run
+    double gbps;            // bytes / median
+    double max_err;         // vs the CPU reference (host fills in)
+} gemm_bench_result_t;
+
+// Defaults: sizes 32 64 128 256, variant 1, 2 warm-up, 20 reps, CSV to "-"
+void gemm_bench_defaults(gemm_bench_cfg_t *cfg);
+
+// "--sizes 64,128 --variants 1,2 --warmup 2 --reps 50 --tag v3 --csv f.csv --json f.json"
+// (argc = 0 on the standalone BSP: defaults stay). Returns -1 on a bad argument
+int  gemm_bench_parse(gemm_bench_cfg_t *cfg, int argc, char **argv);
+
+// warm-up + reps calls of run(ctx); a non-zero return aborts (returned as is).
+// Fills the latency fields of r
+int  gemm_bench_time(const gemm_bench_cfg_t *cfg, int (*run)(void *ctx), void *ctx,
+                     gemm_bench_result_t *r);
+
+// GFLOPS / GB/s of r from m, n, k, bytes and the median
+void gemm_bench_rates(gemm_bench_result_t *r);
+
+// One table line per point (header when first != 0)
+void gemm_bench_print(const gemm_bench_result_t *r, int first);
+
+// All points of the sweep; 0 = ok
+int  gemm_bench_write_csv(const gemm_bench_cfg_t *cfg, const gemm_bench_result_t *r, int n);
+int  gemm_bench_write_json(const gemm_bench_cfg_t *cfg, const gemm_bench_result_t *r, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/********************************************************************
+ * gemm_buf.c
+ *  - Xil_DCacheFlushRange / InvalidateRange work per MVA line (L1 and
+ *    PL310 L2); Xil_DCacheFlush cleans + invalidates both caches by
+ *    set / way
+ ********************************************************************/
+
+#include "xil_cache.h"
+#include "xil_mmu.h"
+
+#include "gemm_buf.h"
+
+typedef struct {
+    UINTPTR         base;
+    u32             bytes;
+    gemm_buf_mode_t mode;
+} buf_region_t;
+
+static buf_region_t regions[GEMM_BUF_MAX_REGIONS];
+static int          nregions;
+
+int gemm_buf_region(void *p, u32 bytes, gemm_buf_mode_t mode){
+    UINTPTR a = (UINTPTR)p;
+
+    if (mode == GEMM_BUF_CACHED) return 0;
+    if (nregions == GEMM_BUF_MAX_REGIONS) return -1;
+
+    if (mode == GEMM_BUF_NONCACHED) {
+        if ((a | bytes) & (GEMM_BUF_SECTION-1)) return -1;
+        // dirty lines of the region must reach DDR before the MMU stops
+        // looking at the cache for it
+        Xil_DCacheFlush();
+        for (u32 off = 0; off < bytes; off += GEMM_BUF_SECTION)
+            Xil_SetTlbAttributes(a + off, NORM_NONCACHE);
+    }
+
+    regions[nregions].base  = a;
+    regions[nregions].bytes = bytes;
+    regions[nregions].mode  = mode;
+    nregions++;
+    return 0;
+}
+
+gemm_buf_mode_t gemm_buf_mode(const void *p, u32 bytes){
+    UINTPTR a = (UINTPTR)p;
+
+    for (int i = 0; i < nregions; i++)
+        if (a >= regions[i].base && a + bytes <= regions[i].base + regions[i].bytes)
+            return regions[i].mode;
+    return GEMM_BUF_CACHED;
+}
+
+const char *gemm_buf_mode_name(gemm_buf_mode_t mode){
+    switch (mode) {
+    case GEMM_BUF_NONCACHED: return "non-cacheable";
+    case GEMM_BUF_COHERENT:  return "coherent (ACP)";
+    default:                 return "cached";
+    }
+}
+
+void gemm_buf_to_dev(const void *p, u32 bytes){
+    UINTPTR a = (UINTPTR)p & ~(UINTPTR)(GEMM_BUF_LINE-1);
+    u32 len = ((UINTPTR)p + bytes - a + GEMM_BUF_LINE-1) & ~(u32)(GEMM_BUF_LINE-1);
+
+    if (!bytes || gemm_buf_mode(p, bytes) != GEMM_BUF_CACHED) return;
+    if (len >= GEMM_BUF_FULL_CLEAN) Xil_DCacheFlush();
+    else                            Xil_DCacheFlushRange(a, len);
+}
+
+// exact range, not widened: Xil_DCacheInvalidateRange cleans + invalidates
+// partial lines at both ends, so data sharing those lines survives.
+// No whole-cache shortcut either: invalidate by set / way would drop
+// dirty lines of other data
+void gemm_buf_from_dev(void *p, u32 bytes){
+    if (!bytes || gemm_buf_mode(p, bytes) != GEMM_BUF_CACHED) return;
+    Xil_DCacheInvalidateRange((UINTPTR)p, bytes);
+}
@@ -0,0 +1,60 @@
+/********************************************************************
+ * gemm_buf.h
+ *  - Cache maintenance for DMA buffers, done once per buffer and GEMM
+ *    instead of once per transfer:
+ *      gemm_buf_to_dev()   : before the DMA reads (MM2S) a buffer the
+ *                            CPU wrote -> clean (flush)
+ *      gemm_buf_from_dev() : before the DMA writes (S2MM) a buffer and
+ *                            again before the CPU reads the result ->
+ *                            invalidate (the second one drops lines the
+ *                            A9 may have prefetched meanwhile)
+ *  - Callers pass plain pointers / byte counts: cleans are widened to
+ *    whole cache lines (GEMM_BUF_LINE) here, invalidates keep the exact
+ *    range (the BSP cleans + invalidates the partial end lines, which a
+ *    widened invalidate would discard)
+ *  - Cleans larger than GEMM_BUF_FULL_CLEAN bytes flush the whole
+ *    D-cache instead (set / way walk of L1 + L2 is cheaper than one
+ *    MVA operation per line of a multi-MB matrix)
+ *  - Regions (gemm_buf_region) that need no maintenance at all:
+ *      GEMM_BUF_NONCACHED : marked normal non-cacheable in the A9 MMU
+ *                           (1 MB sections: base and size 1 MB aligned)
+ *      GEMM_BUF_COHERENT  : the DMA reaches it through the ACP port
+ *                           (block design), snooped by the SCU
+ *    to_dev / from_dev calls inside such a region return immediately
+ ********************************************************************/
+#ifndef GEMM_BUF_H
+#define GEMM_BUF_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEMM_BUF_LINE        32             // A9 L1 / PL310 L2 line size (bytes)
+#define GEMM_BUF_SECTION     0x100000       // MMU section (1 MB)
+#define GEMM_BUF_FULL_CLEAN  (512*1024)     // >= L2 size: whole-cache flush
+#define GEMM_BUF_MAX_REGIONS 8
+
+typedef enum {
+    GEMM_BUF_CACHED    = 0,     // default: clean / invalidate by range
+    GEMM_BUF_NONCACHED = 1,
+    GEMM_BUF_COHERENT  = 2
+} gemm_buf_mode_t;
+
+// Register [p, p + bytes) as NONCACHED (changes the MMU attributes) or
+// COHERENT. -1: bad alignment (NONCACHED) or region table full
+int  gemm_buf_region(void *p, u32 bytes, gemm_buf_mode_t mode);
+
+// Mode of the region containing [p, p + bytes) (CACHED if none)
+gemm_buf_mode_t gemm_buf_mode(const void *p, u32 bytes);
+const char     *gemm_buf_mode_name(gemm_buf_mode_t mode);
+
+void gemm_buf_to_dev(const void *p, u32 bytes);
+void gemm_buf_from_dev(void *p, u32 bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
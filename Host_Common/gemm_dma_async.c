@@ -0,0 +1,213 @@
+/********************************************************************
+ * gemm_dma_async.c
+ *  - q[head] is the transfer on the channel (busy) or the next one
+ *    to start; q[tail] is the next free slot. head only moves in the
+ *    ISR, tail only in the main program
+ *  - Sleeping: check the condition with the IRQ masked, then wfi().
+ *    wfi() also wakes on an interrupt that is pending but masked, so
+ *    a completion between the check and the wfi() is not lost
+ *  - Every wfi() is bounded by the private timer, armed one-shot for
+ *    the time left until the deadline: a DMA interrupt that never
+ *    comes (stalled DMA / kernel, wrong IRQ ID) ends in a timeout
+ ********************************************************************/
+
+#include "xparameters.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xscutimer.h"
+#include "xtime_l.h"
+
+#include "gemm_dma_async.h"
+
+typedef struct {
+    UINTPTR       addr;
+    u32           len;
+    gemm_dma_cb_t done;
+    void         *ctx;
+} async_req_t;
+
+typedef struct {
+    async_req_t   q[GEMM_ASYNC_QLEN];
+    volatile u32  head;
+    volatile u32  tail;
+    volatile int  busy;
+    int           dir;
+} async_chan_t;
+
+static XAxiDma      *async_dma;
+static async_chan_t  async_chan[2];
+static volatile int  async_err;
+static XScuTimer     async_timer;       // wakes wfi() at the deadline
+
+// Start q[head] if the channel is idle (ISR, or main with the IRQ masked)
+static void chan_kick(async_chan_t *c){
+    if (c->busy || c->head == c->tail) return;
+
+    async_req_t *r = &c->q[c->head % GEMM_ASYNC_QLEN];
+    c->busy = 1;
+    if (XAxiDma_SimpleTransfer(async_dma, r->addr, r->len, c->dir) != XST_SUCCESS) {
+        c->busy = 0;
+        async_err = 1;
+    }
+}
+
+static void chan_isr(void *ref){
+    async_chan_t *c = (async_chan_t *)ref;
+
+    u32 irq = XAxiDma_IntrGetIrq(async_dma, c->dir);
+    XAxiDma_IntrAckIrq(async_dma, irq, c->dir);
+
+    if (irq & XAXIDMA_IRQ_ERROR_MASK) {
+        async_err = 1;
+        XAxiDma_Reset(async_dma);
+        return;
+    }
+    if (!(irq & XAXIDMA_IRQ_IOC_MASK) || !c->busy) return;
+
+    async_req_t r = c->q[c->head % GEMM_ASYNC_QLEN];
+    c->head++;
+    c->busy = 0;
+
+    chan_kick(c);               // keep the channel busy before anything else
+    if (r.done) r.done(r.ctx);
+}
+
+static void timer_isr(void *ref){
+    XScuTimer_ClearInterruptStatus((XScuTimer *)ref);
+}
+
+int gemm_async_init(XAxiDma *dma, XScuGic *gic, u16 gic_dev_id,
+                    u32 mm2s_irq_id, u32 s2mm_irq_id){
+    XScuGic_Config *cfg = XScuGic_LookupConfig(gic_dev_id);
+    if (!cfg) return -1;
+    if (XScuGic_CfgInitialize(gic, cfg, cfg->CpuBaseAddress) != XST_SUCCESS) return -1;
+
+    async_dma = dma;
+    async_err = 0;
+    async_chan[0].head = async_chan[0].tail = 0;
+    async_chan[0].busy = 0;
+    async_chan[0].dir  = XAXIDMA_DMA_TO_DEVICE;
+    async_chan[1].head = async_chan[1].tail = 0;
+    async_chan[1].busy = 0;
+    async_chan[1].dir  = XAXIDMA_DEVICE_TO_DMA;
+
+    XAxiDma_IntrDisable(dma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrDisable(dma, XAXIDMA_IRQ_ALL_MASK, XAXIDMA_DEVICE_TO_DMA);
+
+    // private timer: one-shot, counts at CPU/2 like XTime
+    XScuTimer_Config *tcfg = XScuTimer_LookupConfig(XPAR_XSCUTIMER_0_DEVICE_ID);
+    if (!tcfg) return -1;
+    if (XScuTimer_CfgInitialize(&async_timer, tcfg, tcfg->BaseAddr) != XST_SUCCESS) return -1;
+    XScuTimer_Stop(&async_timer);
+    XScuTimer_DisableAutoReload(&async_timer);
+    XScuTimer_ClearInterruptStatus(&async_timer);
+    XScuTimer_EnableInterrupt(&async_timer);
+
+    // rising edge, mid priority (AXI DMA example settings)
+    XScuGic_SetPriorityTriggerType(gic, mm2s_irq_id, 0xA0, 0x3);
+    XScuGic_SetPriorityTriggerType(gic, s2mm_irq_id, 0xA0, 0x3);
+    if (XScuGic_Connect(gic, mm2s_irq_id, (Xil_InterruptHandler)chan_isr, &async_chan[0]) != XST_SUCCESS)
+        return -1;
+    if (XScuGic_Connect(gic, s2mm_irq_id, (Xil_InterruptHandler)chan_isr, &async_chan[1]) != XST_SUCCESS)
+        return -1;
+    if (XScuGic_Connect(gic, XPAR_SCUTIMER_INTR, (Xil_InterruptHandler)timer_isr, &async_timer) != XST_SUCCESS)
+        return -1;
+    XScuGic_Enable(gic, mm2s_irq_id);
+    XScuGic_Enable(gic, s2mm_irq_id);
+    XScuGic_Enable(gic, XPAR_SCUTIMER_INTR);
+
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XScuGic_InterruptHandler, gic);
+    Xil_ExceptionEnable();
+
+    XAxiDma_IntrEnable(dma, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK, XAXIDMA_DMA_TO_DEVICE);
+    XAxiDma_IntrEnable(dma, XAXIDMA_IRQ_IOC_MASK | XAXIDMA_IRQ_ERROR_MASK, XAXIDMA_DEVICE_TO_DMA);
+    return 0;
+}
+
+// timeout (polling units, GEMM_ASYNC_POLL_NS each) -> XTime deadline
+static XTime async_deadline(long timeout){
+    XTime now;
+    XTime_GetTime(&now);
+    return now + (XTime)((double)timeout * GEMM_ASYNC_POLL_NS * ((double)COUNTS_PER_SECOND / 1e9));
+}
+
+// IRQ masked on entry and exit; the pending interrupt is taken in between.
+// -1 (without sleeping) once the deadline has passed
+static int async_sleep(XTime deadline){
+    XTime now;
+    XTime_GetTime(&now);
+    if (now >= deadline) return -1;
+
+    // private timer: 32-bit count, longer waits take several sleeps
+    XTime left = deadline - now;
+    XScuTimer_LoadTimer(&async_timer, (left > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (u32)left);
+    XScuTimer_Start(&async_timer);
+    wfi();
+    Xil_ExceptionEnable();
+    Xil_ExceptionDisable();
+    XScuTimer_Stop(&async_timer);
+    return 0;
+}
+
+static int chan_submit(async_chan_t *c, UINTPTR addr, u32 len,
+                       gemm_dma_cb_t done, void *ctx, long timeout){
+    XTime deadline = async_deadline(timeout);
+
+    Xil_ExceptionDisable();
+    while (c->tail - c->head >= GEMM_ASYNC_QLEN) {
+        if (async_err || async_sleep(deadline) != 0) { Xil_ExceptionEnable(); return -1; }
+    }
+
+    async_req_t *r = &c->q[c->tail % GEMM_ASYNC_QLEN];
+    r->addr = addr;
+    r->len  = len;
+    r->done = done;
+    r->ctx  = ctx;
+
+    c->tail++;
+    chan_kick(c);
+    Xil_ExceptionEnable();
+
+    return async_err ? -1 : 0;
+}
+
+int gemm_async_send(const void *buf, u32 len, gemm_dma_cb_t done, void *ctx, long timeout){
+    return chan_submit(&async_chan[0], (UINTPTR)buf, len, done, ctx, timeout);
+}
+
+int gemm_async_recv(void *buf, u32 len, gemm_dma_cb_t done, void *ctx, long timeout){
+    return chan_submit(&async_chan[1], (UINTPTR)buf, len, done, ctx, timeout);
+}
+
+int gemm_async_pending(int dir){
+    async_chan_t *c = &async_chan[dir == XAXIDMA_DEVICE_TO_DMA];
+    return (int)(c->tail - c->head);
+}
+
+int gemm_async_wait(int dir, int left, long timeout){
+    XTime deadline = async_deadline(timeout);
+
+    Xil_ExceptionDisable();
+    while (gemm_async_pending(dir) > left) {
+        if (async_err || async_sleep(deadline) != 0) break;
+    }
+    Xil_ExceptionEnable();
+    return (async_err || gemm_async_pending(dir) > left) ? -1 : 0;
+}
+
+int gemm_async_wait_flag(volatile int *flag, long timeout){
+    XTime deadline = async_deadline(timeout);
+
+    Xil_ExceptionDisable();
+    while (!*flag) {
+        if (async_err || async_sleep(deadline) != 0) break;
+    }
+    Xil_ExceptionEnable();
+    return *flag ? 0 : -1;
+}
+
+int gemm_async_error(void){
+    return async_err;
+}
@@ -0,0 +1,60 @@
+/********************************************************************
+ * gemm_dma_async.h
+ *  - Interrupt-driven AXI DMA (simple mode) for the Matmul_3/4 hosts
+ *  - Each channel (MM2S / S2MM) has a FIFO of requests. The channel
+ *    completion interrupt starts the next queued transfer first and
+ *    then runs the finished request's callback, so the DMA does not
+ *    wait for the CPU between transfers
+ *  - The CPU only queues buffers and is free to prepare the next
+ *    ones (pack / unpack) while earlier ones are on the wire
+ *  - Waiting sleeps in wfi() instead of spinning on XAxiDma_Busy.
+ *    timeout is in the polling paths' unit (one DMA status poll, as
+ *    DMA_TIMEOUT in the hosts), turned into an XTime deadline of
+ *    timeout * GEMM_ASYNC_POLL_NS; the A9 private timer wakes the
+ *    core at the deadline, so a missing interrupt is a timeout, not
+ *    a hang (the timer interrupt is connected on the same GIC)
+ *  - Cache maintenance of the data buffers is left to the caller
+ *  - Single instance, single core (queue updates mask the IRQ)
+ ********************************************************************/
+#ifndef GEMM_DMA_ASYNC_H
+#define GEMM_DMA_ASYNC_H
+
+#include "xaxidma.h"
+#include "xscugic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEMM_ASYNC_QLEN 1024     // per channel, power of two
+#define GEMM_ASYNC_POLL_NS 100   // one timeout unit: ~ one AXI-Lite status read over M_AXI_GP0
+
+// Runs in interrupt context, after the next transfer has been started
+typedef void (*gemm_dma_cb_t)(void *ctx);
+
+// GIC + exception setup, connects both channel interrupts, enables IOC/error
+int gemm_async_init(XAxiDma *dma, XScuGic *gic, u16 gic_dev_id,
+                    u32 mm2s_irq_id, u32 s2mm_irq_id);
+
+// Queue a transfer (blocks in wfi() while the queue is full).
+// done may be 0. 0 on success, -1 on timeout / DMA error
+int gemm_async_send(const void *buf, u32 len, gemm_dma_cb_t done, void *ctx, long timeout);
+int gemm_async_recv(void *buf, u32 len, gemm_dma_cb_t done, void *ctx, long timeout);
+
+// Queued + in-flight requests of a direction (XAXIDMA_DMA_TO_DEVICE / XAXIDMA_DEVICE_TO_DMA)
+int gemm_async_pending(int dir);
+
+// Sleep until the direction has at most left requests outstanding
+int gemm_async_wait(int dir, int left, long timeout);
+
+// Sleep until *flag becomes nonzero (set from a callback)
+int gemm_async_wait_flag(volatile int *flag, long timeout);
+
+// Sticky: a DMA error interrupt or a failed start happened
+int gemm_async_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
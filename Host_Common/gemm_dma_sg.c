@@ -0,0 +1,137 @@
+/********************************************************************
+ * gemm_dma_sg.c
+ *  - BD life cycle (xaxidma_bdring.h):
+ *      Alloc -> fill -> ToHw -> (engine) -> FromHw -> Free
+ *  - Data buffers are not flushed here: the caller flushes / invalidates
+ *    whole packed matrices once
+ ********************************************************************/
+
+#include <string.h>
+
+#include "gemm_dma_sg.h"
+
+static int ring_setup(XAxiDma_BdRing *ring, XAxiDma_Bd *bds, int cnt){
+    XAxiDma_Bd tmpl;
+
+    XAxiDma_BdRingIntDisable(ring, XAXIDMA_IRQ_ALL_MASK);
+
+    if (XAxiDma_BdRingCreate(ring, (UINTPTR)bds, (UINTPTR)bds,
+                             XAXIDMA_BD_MINIMUM_ALIGNMENT, cnt) != XST_SUCCESS)
+        return -1;
+
+    memset(&tmpl, 0, sizeof(tmpl));
+    if (XAxiDma_BdRingClone(ring, &tmpl) != XST_SUCCESS) return -1;
+
+    return (XAxiDma_BdRingStart(ring) == XST_SUCCESS) ? 0 : -1;
+}
+
+int gemm_sg_setup(XAxiDma *dma,
+                  XAxiDma_Bd *tx_bds, int tx_cnt,
+                  XAxiDma_Bd *rx_bds, int rx_cnt){
+    if (!XAxiDma_HasSg(dma)) return -1;
+    if (ring_setup(XAxiDma_GetTxRing(dma), tx_bds, tx_cnt) != 0) return -1;
+    return ring_setup(XAxiDma_GetRxRing(dma), rx_bds, rx_cnt);
+}
+
+int gemm_sg_block_segs(gemm_sg_seg_t *seg, UINTPTR base, u32 row_bytes, int rows,
+                       u32 ld_bytes, u32 first_ctrl, u32 last_ctrl){
+    for (int r = 0; r < rows; r++) {
+        seg[r].addr = base + (UINTPTR)r * ld_bytes;
+        seg[r].len  = row_bytes;
+        seg[r].ctrl = 0;
+    }
+    seg[0].ctrl        |= first_ctrl;
+    seg[rows - 1].ctrl |= last_ctrl;
+    return rows;
+}
+
+int gemm_sg_reclaim(XAxiDma_BdRing *ring){
+    XAxiDma_Bd *bd;
+    int n = XAxiDma_BdRingFromHw(ring, XAXIDMA_ALL_BDS, &bd);
+    if (n <= 0) return 0;
+
+    int err = 0;
+    XAxiDma_Bd *p = bd;
+    for (int i = 0; i < n; i++) {
+        if (XAxiDma_BdGetSts(p) & XAXIDMA_BD_STS_ALL_ERR_MASK) err = 1;
+        p = XAxiDma_BdRingNext(ring, p);
+    }
+
+    if (XAxiDma_BdRingFree(ring, n, bd) != XST_SUCCESS) return -1;
+    return err ? -1 : n;
+}
+
+// MM2S: every packet (TXSOF .. TXEOF) complete and no longer than the ring
+static int tx_check(const gemm_sg_seg_t *seg, int cnt, int ring_cnt){
+    int start = 0;
+    for (int i = 0; i < cnt; i++) {
+        if (i == start && !(seg[i].ctrl & XAXIDMA_BD_CTRL_TXSOF_MASK)) return -1;
+        if (seg[i].ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK) {
+            if (i - start + 1 > ring_cnt) return -1;
+            start = i + 1;
+        }
+    }
+    return (start == cnt) ? 0 : -1;
+}
+
+// MM2S: BDs up to the last TXEOF within the first max BDs (0: none),
+// or with max = cnt and first_only, the length of the first packet
+static int tx_prefix(const gemm_sg_seg_t *seg, int max, int first_only){
+    int n = 0;
+    for (int i = 0; i < max; i++) {
+        if (seg[i].ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK) {
+            n = i + 1;
+            if (first_only) break;
+        }
+    }
+    return n;
+}
+
+int gemm_sg_submit(XAxiDma_BdRing *ring, const gemm_sg_seg_t *seg, int cnt, long timeout){
+    // half a ring per ToHw: the engine drains one half while the CPU refills the other
+    const int tx = !ring->IsRxChannel;
+    int batch = XAxiDma_BdRingGetCnt(ring) / 2;
+    if (batch < 1) batch = 1;
+
+    // BdRingToHw rejects an MM2S batch that does not start with TXSOF and
+    // end with TXEOF: batches are cut on packet boundaries only
+    if (tx && tx_check(seg, cnt, XAxiDma_BdRingGetCnt(ring)) != 0) return -1;
+
+    while (cnt > 0) {
+        int n = (cnt < batch) ? cnt : batch;
+        if (tx) {
+            n = tx_prefix(seg, n, 0);
+            if (n == 0) n = tx_prefix(seg, cnt, 1);     // packet > half ring: alone
+        }
+
+        long t = timeout;
+        while (XAxiDma_BdRingGetFreeCnt(ring) < n) {
+            if (gemm_sg_reclaim(ring) < 0 || t-- <= 0) return -1;
+        }
+
+        XAxiDma_Bd *first, *bd;
+        if (XAxiDma_BdRingAlloc(ring, n, &first) != XST_SUCCESS) return -1;
+
+        bd = first;
+        for (int i = 0; i < n; i++) {
+            XAxiDma_BdSetBufAddr(bd, seg[i].addr);
+            XAxiDma_BdSetLength(bd, seg[i].len, ring->MaxTransferLen);
+            XAxiDma_BdSetCtrl(bd, seg[i].ctrl);
+            XAxiDma_BdSetId(bd, seg[i].addr);
+            bd = XAxiDma_BdRingNext(ring, bd);
+        }
+
+        if (XAxiDma_BdRingToHw(ring, n, first) != XST_SUCCESS) return -1;
+
+        seg += n;
+        cnt -= n;
+    }
+    return 0;
+}
+
+int gemm_sg_wait(XAxiDma_BdRing *ring, long timeout){
+    while (ring->HwCnt > 0) {
+        if (gemm_sg_reclaim(ring) < 0 || timeout-- <= 0) return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/********************************************************************
+ * gemm_dma_sg.h
+ *  - AXI DMA scatter-gather helpers for the Matmul_3/4 hosts
+ *  - One BD per contiguous buffer (a packed 16x16 tile). A batch of
+ *    BDs is chained and handed to the engine with one BdRingToHw, so
+ *    MM2S runs frame after frame with no CPU in between
+ *  - Rings are fixed size and refilled in half-ring batches: the CPU
+ *    only touches a ring to reclaim finished BDs and queue the next
+ *    batch
+ *  - Strided 2D blocks (gemm_sg_block_segs): one BD per block row, so
+ *    a tile of a row-major matrix (leading dimension ld) goes to / from
+ *    the stream with no packing copy. A packet may span several BDs
+ *    (SOF on the first, EOF on the last; S2MM fills BDs in order until
+ *    TLAST)
+ *  - Polling mode (ring interrupts disabled)
+ *  - Needs the AXI DMA IP built with the SG engine
+ *    (XAxiDma_HasSg); otherwise use XAxiDma_SimpleTransfer
+ ********************************************************************/
+#ifndef GEMM_DMA_SG_H
+#define GEMM_DMA_SG_H
+
+#include "xaxidma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    UINTPTR addr;
+    u32     len;    // bytes
+    u32     ctrl;   // MM2S: XAXIDMA_BD_CTRL_TXSOF_MASK / TXEOF_MASK, S2MM: 0
+} gemm_sg_seg_t;
+
+// Segments of a rows x row_bytes block at base, row stride ld_bytes:
+// one per row, first_ctrl on the first row and last_ctrl on the last
+// (MM2S: TXSOF / TXEOF, S2MM: 0). Returns rows
+int gemm_sg_block_segs(gemm_sg_seg_t *seg, UINTPTR base, u32 row_bytes, int rows,
+                       u32 ld_bytes, u32 first_ctrl, u32 last_ctrl);
+
+// Create, clear and start both rings on caller-provided BD memory
+// (XAXIDMA_BD_MINIMUM_ALIGNMENT aligned)
+int gemm_sg_setup(XAxiDma *dma,
+                  XAxiDma_Bd *tx_bds, int tx_cnt,
+                  XAxiDma_Bd *rx_bds, int rx_cnt);
+
+// Queue cnt buffers in order. Blocks (reclaiming) while the ring is full.
+// MM2S batches end on a TXEOF BD (the driver rejects others): every
+// packet must be complete in seg and fit in the ring.
+// 0 on success, -1 on a bad packet / timeout / DMA error
+int gemm_sg_submit(XAxiDma_BdRing *ring, const gemm_sg_seg_t *seg, int cnt, long timeout);
+
+// Return finished BDs to the free list: count, or -1 on a BD error status
+int gemm_sg_reclaim(XAxiDma_BdRing *ring);
+
+// Wait until every queued BD has finished
+int gemm_sg_wait(XAxiDma_BdRing *ring, long timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+/********************************************************************
+ * gemm_half.c
+ *  - Scalar conversions are the reference; the vector paths give the
+ *    same bits for every finite input (bf16 vector path: NaN inputs
+ *    with only low mantissa bits set may round to inf)
+ ********************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+
+#include "gemm_half.h"
+
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__ARM_FP) && (__ARM_FP & 2)
+#include <arm_neon.h>
+#define HALF_HAVE_NEON_FP16 1
+#define HALF_HAVE_NEON 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HALF_HAVE_NEON 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HALF_HAVE_SSE2 1
+#if defined(__GNUC__)
+#define HALF_HAVE_F16C 1
+#endif
+#endif
+
+static inline uint32_t f2u(float f){ uint32_t u; memcpy(&u, &f, 4); return u; }
+static inline float    u2f(uint32_t u){ float f; memcpy(&f, &u, 4); return f; }
+
+// ================================================================
+// Scalar
+// ================================================================
+static uint16_t f32_to_bf16(float f){
+    uint32_t u = f2u(f);
+    if ((u & 0x7FFFFFFFu) > 0x7F800000u)           // NaN: keep it quiet NaN
+        return (uint16_t)((u >> 16) | 0x0040);
+    u += 0x7FFFu + ((u >> 16) & 1);                // round to nearest even
+    return (uint16_t)(u >> 16);
+}
+
+static uint16_t f32_to_fp16(float f){
+    uint32_t u    = f2u(f);
+    uint32_t sign = (u >> 16) & 0x8000u;
+    uint32_t a    = u & 0x7FFFFFFFu;
+
+    if (a >= 0x7F800000u)                          // inf / NaN
+        return (uint16_t)(sign | 0x7C00u | ((a > 0x7F800000u) ? 0x200u : 0));
+    if (a >= 0x477FF000u)                          // >= 65520: rounds to inf
+        return (uint16_t)(sign | 0x7C00u);
+    if (a < 0x38800000u) {                         // < 2^-14: fp16 subnormal / zero
+        if (a < 0x33000000u) return (uint16_t)sign;            // < 2^-25: rounds to 0
+        uint32_t man   = (a & 0x7FFFFFu) | 0x800000u;
+        int      shift = 126 - (int)(a >> 23);                 // 14..24
+        uint32_t q     = man >> shift;
+        uint32_t rem   = man & ((1u << shift) - 1);
+        uint32_t half  = 1u << (shift - 1);
+        if (rem > half || (rem == half && (q & 1))) q++;
+        return (uint16_t)(sign | q);
+    }
+    // normal: rebias 127 -> 15, round mantissa 23 -> 10 bits (carry into exp is fine)
+    a -= 112u << 23;
+    a += 0xFFFu + ((a >> 13) & 1);
+    return (uint16_t)(sign | (a >> 13));
+}
+
+float gemm_half_to_f32(uint16_t h, gemm_fmt_t fmt){
+    if (fmt == GEMM_FMT_BF16) return u2f((uint32_t)h << 16);
+
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t exp  = (h >> 10) & 0x1F;
+    uint32_t man  = h & 0x3FF;
+    if (exp == 0x1F) return u2f(sign | 0x7F800000u | (man << 13));
+    if (exp != 0)    return u2f(sign | ((exp + 112) << 23) | (man << 13));
+    float v = (float)man * 5.9604644775390625e-08f;          // man * 2^-24
+    return sign ? -v : v;
+}
+
+// ================================================================
+// Vector paths (8 values per iteration)
+// ================================================================
+#ifdef HALF_HAVE_NEON
+static void bf16_neon(const float *src, uint16_t *dst, int n){
+    int i = 0;
+    const uint32x4_t bias = vdupq_n_u32(0x7FFFu);
+    const uint32x4_t one  = vdupq_n_u32(1);
+    for (; i + 8 <= n; i += 8) {
+        uint32x4_t a = vreinterpretq_u32_f32(vld1q_f32(src + i));
+        uint32x4_t b = vreinterpretq_u32_f32(vld1q_f32(src + i + 4));
+        a = vaddq_u32(a, vaddq_u32(bias, vandq_u32(vshrq_n_u32(a, 16), one)));
+        b = vaddq_u32(b, vaddq_u32(bias, vandq_u32(vshrq_n_u32(b, 16), one)));
+        vst1q_u16(dst + i, vcombine_u16(vshrn_n_u32(a, 16), vshrn_n_u32(b, 16)));
+    }
+    for (; i < n; i++) dst[i] = f32_to_bf16(src[i]);
+}
+#endif
+
+#ifdef HALF_HAVE_NEON_FP16
+// VCVT.F16.F32 rounds with FPSCR (round to nearest even by default)
+static void fp16_neon(const float *src, uint16_t *dst, int n){
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    for (; i < n; i++) dst[i] = f32_to_fp16(src[i]);
+}
+#endif
+
+#ifdef HALF_HAVE_SSE2
+static void bf16_sse2(const float *src, uint16_t *dst, int n){
+    int i = 0;
+    const __m128i bias = _mm_set1_epi32(0x7FFF);
+    const __m128i one  = _mm_set1_epi32(1);
+    for (; i + 8 <= n; i += 8) {
+        __m128i a = _mm_castps_si128(_mm_loadu_ps(src + i));
+        __m128i b = _mm_castps_si128(_mm_loadu_ps(src + i + 4));
+        a = _mm_add_epi32(a, _mm_add_epi32(bias, _mm_and_si128(_mm_srli_epi32(a, 16), one)));
+        b = _mm_add_epi32(b, _mm_add_epi32(bias, _mm_and_si128(_mm_srli_epi32(b, 16), one)));
+        // high halves, sign-extended so packs_epi32 keeps the bits
+        a = _mm_srai_epi32(a, 16);
+        b = _mm_srai_epi32(b, 16);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a, b));
+    }
+    for (; i < n; i++) dst[i] = f32_to_bf16(src[i]);
+}
+#endif
+
+#ifdef HALF_HAVE_F16C
+__attribute__((target("avx,f16c")))
+static void fp16_f16c(const float *src, uint16_t *dst, int n){
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    for (; i < n; i++) dst[i] = f32_to_fp16(src[i]);
+}
+
+static int cpu_has_f16c(void){
+    static int has = -1;
+    if (has < 0) {
+        __builtin_cpu_init();
+        has = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+    }
+    return has;
+}
+#endif
+
+const char *gemm_half_impl_name(gemm_fmt_t fmt){
+    if (fmt == GEMM_FMT_BF16) {
+#if defined(HALF_HAVE_NEON)
+        return "neon";
+#elif defined(HALF_HAVE_SSE2)
+        return "sse2";
+#endif
+    } else if (fmt == GEMM_FMT_FP16) {
+#if defined(HALF_HAVE_NEON_FP16)
+        return "neon";
+#elif defined(HALF_HAVE_F16C)
+        if (cpu_has_f16c()) return "f16c";
+#endif
+    }
+    return "scalar";
+}
+
+void gemm_f32_to_half(const float *src, uint16_t *dst, int n, gemm_fmt_t fmt){
+    if (fmt == GEMM_FMT_BF16) {
+#if defined(HALF_HAVE_NEON)
+        bf16_neon(src, dst, n);
+        return;
+#elif defined(HALF_HAVE_SSE2)
+        bf16_sse2(src, dst, n);
+        return;
+#endif
+        for (int i = 0; i < n; i++) dst[i] = f32_to_bf16(src[i]);
+        return;
+    }
+#if defined(HALF_HAVE_NEON_FP16)
+    fp16_neon(src, dst, n);
+    return;
+#elif defined(HALF_HAVE_F16C)
+    if (cpu_has_f16c()) {
+        fp16_f16c(src, dst, n);
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) dst[i] = f32_to_fp16(src[i]);
+}
+
+// ================================================================
+// Convert + pack (same layout as gemm_pack_tiles_esz(..., 2, ...))
+// ================================================================
+void gemm_pack_tiles_half(const float *src, int rows, int cols, int ld,
+                          int tile, gemm_tile_order_t order, gemm_fmt_t fmt,
+                          uint16_t *dst){
+    int ntr = gemm_ntiles(rows, tile), ntc = gemm_ntiles(cols, tile);
+
+    for (int br = 0; br < ntr; br++)
+        for (int bc = 0; bc < ntc; bc++) {
+            int h = gemm_tile_dim(rows, tile, br), w = gemm_tile_dim(cols, tile, bc);
+            uint16_t *t = dst + gemm_tile_off(rows, cols, tile, order, br, bc);
+            const float *s = src + (long)br*tile*ld + bc*tile;
+            for (int i = 0; i < h; i++)
+                gemm_f32_to_half(s + (long)i*ld, t + i*w, w, fmt);
+        }
+}
@@ -0,0 +1,46 @@
+/********************************************************************
+ * gemm_half.h
+ *  - fp32 -> fp16 / bf16 conversion for the half-width input mode of
+ *    the Matmul_4 IP (two elements per 32-bit AXIS word)
+ *  - Round to nearest even, fp16 overflow -> inf, subnormals kept
+ *  - Vectorized: NEON vcvt (A9 with -mfpu=neon-fp16) or F16C (x86,
+ *    runtime check) for fp16, NEON / SSE2 integer rounding for bf16,
+ *    scalar otherwise
+ *  - gemm_pack_tiles_half(): convert while packing into the tile-major
+ *    layout of gemm_pack (tile rows are converted straight into place)
+ ********************************************************************/
+#ifndef GEMM_HALF_H
+#define GEMM_HALF_H
+
+#include <stdint.h>
+
+#include "gemm_pack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    GEMM_FMT_FP32 = 0,
+    GEMM_FMT_FP16 = 1,
+    GEMM_FMT_BF16 = 2
+} gemm_fmt_t;
+
+// n floats -> n fp16 / bf16 values
+void gemm_f32_to_half(const float *src, uint16_t *dst, int n, gemm_fmt_t fmt);
+
+// One value back to float (exact), e.g. to round a reference matrix
+float gemm_half_to_f32(uint16_t h, gemm_fmt_t fmt);
+
+// gemm_pack_tiles() with conversion: dst holds rows*cols 16-bit values
+void gemm_pack_tiles_half(const float *src, int rows, int cols, int ld,
+                          int tile, gemm_tile_order_t order, gemm_fmt_t fmt,
+                          uint16_t *dst);
+
+const char *gemm_half_impl_name(gemm_fmt_t fmt);   // "neon", "f16c", "sse2", "scalar"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/********************************************************************
+ * gemm_pack.c
+ *  - Each tile row is w contiguous elements in both layouts (w = tile,
+ *    or the edge width), so the copy runs as one memcpy per row
+ ********************************************************************/
+
+#include <string.h>
+
+#include "gemm_pack.h"
+
+void gemm_pack_tiles_esz(const void *src, int rows, int cols, int ld,
+                         int tile, gemm_tile_order_t order, int esz, void *dst){
+    int ntr = gemm_ntiles(rows, tile), ntc = gemm_ntiles(cols, tile);
+
+    for (int br = 0; br < ntr; br++)
+        for (int bc = 0; bc < ntc; bc++) {
+            int h = gemm_tile_dim(rows, tile, br), w = gemm_tile_dim(cols, tile, bc);
+            char *t = (char *)dst + gemm_tile_off(rows, cols, tile, order, br, bc)*esz;
+            const char *s = (const char *)src + ((long)br*tile*ld + bc*tile)*esz;
+            for (int i = 0; i < h; i++)
+                memcpy(t + (long)i*w*esz, s + (long)i*ld*esz, (size_t)w*esz);
+        }
+}
+
+void gemm_unpack_tiles_esz(const void *src, int rows, int cols,
+                           int tile, gemm_tile_order_t order, int esz,
+                           void *dst, int ld){
+    int ntr = gemm_ntiles(rows, tile), ntc = gemm_ntiles(cols, tile);
+
+    for (int br = 0; br < ntr; br++)
+        for (int bc = 0; bc < ntc; bc++) {
+            int h = gemm_tile_dim(rows, tile, br), w = gemm_tile_dim(cols, tile, bc);
+            const char *t = (const char *)src + gemm_tile_off(rows, cols, tile, order, br, bc)*esz;
+            char *d = (char *)dst + ((long)br*tile*ld + bc*tile)*esz;
+            for (int i = 0; i < h; i++)
+                memcpy(d + (long)i*ld*esz, t + (long)i*w*esz, (size_t)w*esz);
+        }
+}
+
+void gemm_pack_tiles(const float *src, int rows, int cols, int ld,
+                     int tile, gemm_tile_order_t order, float *dst){
+    gemm_pack_tiles_esz(src, rows, cols, ld, tile, order, sizeof(float), dst);
+}
+
+void gemm_unpack_tiles(const float *src, int rows, int cols,
+                       int tile, gemm_tile_order_t order,
+                       float *dst, int ld){
+    gemm_unpack_tiles_esz(src, rows, cols, tile, order, sizeof(float), dst, ld);
+}
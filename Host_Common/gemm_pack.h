@@ -0,0 +1,76 @@
+/********************************************************************
+ * gemm_pack.h
+ *  - One-time conversion between row-major matrices and the
+ *    tile-major layout the GEMM IP consumes (TILE x TILE row-major
+ *    tiles, each contiguous = one DMA transfer)
+ *
+ *  - Tile order:
+ *      GEMM_TILES_ROW_MAJOR : tile (br,bc) at (br*ntc + bc)
+ *                             -> A row panel A(bi, 0..K-1) contiguous
+ *      GEMM_TILES_COL_MAJOR : tile (br,bc) at (bc*ntr + br)
+ *                             -> B col panel B(0..K-1, bj) contiguous
+ *
+ *  - Frame (bi,bj,bk) = A(bi,bk) tile then B(bk,bj) tile, straight out
+ *    of the packed buffers: no per-frame extract_block / memcpy
+ *  - rows, cols need not be multiples of tile: edge tiles are stored
+ *    compact (h x w row-major, h / w = gemm_tile_dim), no zero padding.
+ *    Panels stay contiguous, so (br,bc) is still a closed-form offset
+ ********************************************************************/
+#ifndef GEMM_PACK_H
+#define GEMM_PACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    GEMM_TILES_ROW_MAJOR = 0,
+    GEMM_TILES_COL_MAJOR = 1
+} gemm_tile_order_t;
+
+void gemm_pack_tiles(const float *src, int rows, int cols, int ld,
+                     int tile, gemm_tile_order_t order, float *dst);
+
+void gemm_unpack_tiles(const float *src, int rows, int cols,
+                       int tile, gemm_tile_order_t order,
+                       float *dst, int ld);
+
+// Number of tiles along a dimension of n elements (last one may be partial)
+static inline int gemm_ntiles(int n, int tile){ return (n + tile - 1) / tile; }
+
+// Rows (or cols) of tile b along a dimension of n elements
+static inline int gemm_tile_dim(int n, int tile, int b){
+    int r = n - b*tile;
+    return (r < tile) ? r : tile;
+}
+
+// Element offset of tile (br,bc) inside a packed buffer.
+// Every panel before br (bc) is full height (width), so the offset is
+// whole panels + the tiles before bc (br) in this panel
+static inline long gemm_tile_off(int rows, int cols, int tile,
+                                 gemm_tile_order_t order, int br, int bc){
+    return (order == GEMM_TILES_ROW_MAJOR)
+         ? (long)br*tile*cols + (long)gemm_tile_dim(rows, tile, br)*bc*tile
+         : (long)bc*tile*rows + (long)gemm_tile_dim(cols, tile, bc)*br*tile;
+}
+
+static inline float *gemm_tile_ptr(float *packed, int rows, int cols, int tile,
+                                   gemm_tile_order_t order, int br, int bc){
+    return packed + gemm_tile_off(rows, cols, tile, order, br, bc);
+}
+
+// Same layout for any element size (esz bytes: int8 = 1, fp16 = 2).
+// Narrow tiles are what the packed-beat IPs consume: a 16x16 int8 tile
+// is 256 contiguous bytes = 64 AXIS words, 4 elements per word
+void gemm_pack_tiles_esz(const void *src, int rows, int cols, int ld,
+                         int tile, gemm_tile_order_t order, int esz, void *dst);
+
+void gemm_unpack_tiles_esz(const void *src, int rows, int cols,
+                           int tile, gemm_tile_order_t order, int esz,
+                           void *dst, int ld);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
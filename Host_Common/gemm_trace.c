@@ -0,0 +1,149 @@
+/********************************************************************
+ * gemm_trace.c
+ *  - Fixed-size event log and counters, no allocation (standalone BSP)
+ *  - Timestamps are XTime ticks since gemm_trace_reset(), converted to
+ *    us (Chrome trace "ts" / "dur" unit) only when printing
+ ********************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xparameters.h"
+
+#include "gemm_trace.h"
+
+#define GEMM_TRACE_MAX_TILES 4096   // block spans in the Chrome trace
+
+typedef struct {
+    XTime t0, t1;
+    short phase;
+    int   tile;
+} trace_event_t;
+
+static const char *phase_name[GEMM_PH_NUM] = {
+    "pack", "cache", "dma submit", "dma wait", "ip poll", "unpack"
+};
+
+static trace_event_t events[GEMM_TRACE_MAX_EVENTS];
+static int           nevents;
+static int           ndropped;
+static XTime         origin;
+static int           cur_tile = -1;
+
+static XTime    total[GEMM_PH_NUM];
+static unsigned count[GEMM_PH_NUM];
+static unsigned hist[GEMM_PH_NUM][GEMM_TRACE_HIST];
+
+static inline double ticks_to_us(XTime c){
+    return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+}
+
+void gemm_trace_reset(void){
+    memset(total, 0, sizeof(total));
+    memset(count, 0, sizeof(count));
+    memset(hist, 0, sizeof(hist));
+    nevents  = 0;
+    ndropped = 0;
+    cur_tile = -1;
+    XTime_GetTime(&origin);
+}
+
+void gemm_trace_tile(int tile){
+    cur_tile = tile;
+}
+
+void gemm_trace_add(int phase, XTime t0, XTime t1){
+    double us = ticks_to_us(t1 - t0);
+    int b = 0;
+
+    total[phase] += t1 - t0;
+    count[phase]++;
+    for (double lim = 1.0; b < GEMM_TRACE_HIST-1 && us >= lim; lim *= 2.0) b++;
+    hist[phase][b]++;
+
+    if (nevents == GEMM_TRACE_MAX_EVENTS) {
+        ndropped++;
+        return;
+    }
+    events[nevents].t0    = t0;
+    events[nevents].t1    = t1;
+    events[nevents].phase = (short)phase;
+    events[nevents].tile  = cur_tile;
+    nevents++;
+}
+
+double gemm_trace_total_us(int phase){
+    return ticks_to_us(total[phase]);
+}
+
+void gemm_trace_print(double total_us){
+    double work = 0.0, wait = 0.0;
+
+    printf("Phase         total us      %%   count    mean us  hist (<1,<2,<4,.. us)\n");
+    for (int p = 0; p < GEMM_PH_NUM; p++) {
+        double us = gemm_trace_total_us(p);
+        if (!count[p]) continue;
+        printf("%-12s %10.3f %6.1f %7u %10.3f ", phase_name[p], us, 100.0*us/total_us,
+               count[p], us/count[p]);
+        for (int b = 0; b < GEMM_TRACE_HIST; b++) printf(" %u", hist[p][b]);
+        printf("\n");
+        if (p == GEMM_PH_WAIT || p == GEMM_PH_POLL) wait += us;
+        else                                        work += us;
+    }
+    // other = host code outside the scopes (loops, address math) + trace overhead
+    printf("Host work %.3f us (%.1f%%), waiting on DMA / PL %.3f us (%.1f%%), other %.3f us\n",
+           work, 100.0*work/total_us, wait, 100.0*wait/total_us, total_us - work - wait);
+    if (ndropped) printf("trace: %d events dropped (log full)\n", ndropped);
+}
+
+int gemm_trace_write_chrome(const char *path){
+    static XTime first[GEMM_TRACE_MAX_TILES], last[GEMM_TRACE_MAX_TILES];
+    static unsigned char seen[GEMM_TRACE_MAX_TILES];
+    const char *pre = "trace ";
+    FILE *f = stdout;
+    int ntiles = 0;
+
+#ifdef __linux__
+    if (strcmp(path, "-")) {
+        FILE *o = fopen(path, "w");
+        if (o) { f = o; pre = ""; }
+        else   printf("trace: cannot write %s, trace on stdout\n", path);
+    }
+#else
+    (void)path;
+#endif
+
+    memset(seen, 0, sizeof(seen));
+    for (int i = 0; i < nevents; i++) {
+        int t = events[i].tile;
+        if (t < 0 || t >= GEMM_TRACE_MAX_TILES) continue;
+        if (!seen[t] || events[i].t0 < first[t]) first[t] = events[i].t0;
+        if (!seen[t] || events[i].t1 > last[t])  last[t]  = events[i].t1;
+        seen[t] = 1;
+        if (t + 1 > ntiles) ntiles = t + 1;
+    }
+
+    fprintf(f, "%s{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n", pre);
+    fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"tile / block\"}},\n", pre);
+    for (int p = 0; p < GEMM_PH_NUM; p++)
+        fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"%s\"}},\n",
+                pre, p + 1, phase_name[p]);
+    for (int t = 0; t < ntiles; t++) {
+        if (!seen[t]) continue;
+        fprintf(f, "%s{\"name\": \"block %d\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f},\n",
+                pre, t, ticks_to_us(first[t] - origin), ticks_to_us(last[t] - first[t]));
+    }
+    for (int i = 0; i < nevents; i++)
+        fprintf(f, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"tile\": %d}},\n",
+                pre, phase_name[events[i].phase], events[i].phase + 1,
+                ticks_to_us(events[i].t0 - origin), ticks_to_us(events[i].t1 - events[i].t0), events[i].tile);
+    // last event without a trailing comma: the process name
+    fprintf(f, "%s{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"host\"}}\n", pre);
+    fprintf(f, "%s]}\n", pre);
+
+    if (f != stdout) {
+        fclose(f);
+        printf("trace: wrote %s (%d events)\n", path, nevents);
+    }
+    return 0;
+}
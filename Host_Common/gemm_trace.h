@@ -0,0 +1,90 @@
+/********************************************************************
+ * gemm_trace.h
+ *  - Scoped phase timers for the host GEMM path: per-phase totals,
+ *    call counts and log2 duration histograms, plus an event log
+ *    exported as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+ *  - A scope is one statement or block:
+ *        GEMM_TRACE_SCOPE(GEMM_PH_PACK) pack_in(...);
+ *    the duration is recorded when the statement completes (a return
+ *    / break out of the scope drops that one event)
+ *  - Events carry the current tile / block id (gemm_trace_tile()), so
+ *    the timeline has one span per block next to the phase lanes
+ *  - Cost per scope: two XTime reads and a few adds; the host keeps
+ *    the scopes behind its own build flag so the default path has none
+ *  - Not reentrant: callbacks in interrupt context are not traced
+ ********************************************************************/
+#ifndef GEMM_TRACE_H
+#define GEMM_TRACE_H
+
+#include "xtime_l.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    GEMM_PH_PACK = 0,     // A / B packing (and fp16 / bf16 conversion)
+    GEMM_PH_CACHE,        // D-cache flush / invalidate
+    GEMM_PH_SUBMIT,       // DMA transfer / BD / request submit
+    GEMM_PH_WAIT,         // waiting for a DMA channel (busy-wait, BD / IRQ completion)
+    GEMM_PH_POLL,         // IP CTRL: start, AP_DONE / AP_IDLE / last_job poll
+    GEMM_PH_UNPACK,       // packed C -> row-major
+    GEMM_PH_NUM
+} gemm_phase_t;
+
+#define GEMM_TRACE_MAX_EVENTS 16384     // event log (totals keep counting when full)
+#define GEMM_TRACE_HIST       12        // buckets: < 1, < 2, < 4, ... us, last = rest
+
+typedef struct {
+    int   phase;
+    int   once;
+    XTime t0;
+} gemm_trace_scope_t;
+
+// Clear totals / events; timestamps start here
+void gemm_trace_reset(void);
+
+// Tile / block id stored with the following events (-1: none)
+void gemm_trace_tile(int tile);
+
+// One finished phase interval (t0, t1 in XTime ticks)
+void gemm_trace_add(int phase, XTime t0, XTime t1);
+
+static inline gemm_trace_scope_t gemm_trace_open(int phase){
+    gemm_trace_scope_t s;
+    s.phase = phase;
+    s.once  = 1;
+    XTime_GetTime(&s.t0);
+    return s;
+}
+
+static inline void gemm_trace_close(gemm_trace_scope_t *s){
+    XTime t1;
+    XTime_GetTime(&t1);
+    gemm_trace_add(s->phase, s->t0, t1);
+    s->once = 0;
+}
+
+#define GEMM_TRACE_CAT_(a, b) a##b
+#define GEMM_TRACE_CAT(a, b)  GEMM_TRACE_CAT_(a, b)
+#define GEMM_TRACE_SCOPE(phase) \
+    for (gemm_trace_scope_t GEMM_TRACE_CAT(gemm_ts_, __LINE__) = gemm_trace_open(phase); \
+         GEMM_TRACE_CAT(gemm_ts_, __LINE__).once; gemm_trace_close(&GEMM_TRACE_CAT(gemm_ts_, __LINE__)))
+
+// Total time of one phase since the last reset (us)
+double gemm_trace_total_us(int phase);
+
+// Per-phase table: total, share of total_us (the measured end-to-end
+// time), count, mean, histogram; then host work vs waiting
+void gemm_trace_print(double total_us);
+
+// Chrome trace JSON of the event log: lane 0 = one span per tile /
+// block, lanes 1.. = phases. path "-" (or not writable, standalone
+// BSP): stdout, each line prefixed with "trace "
+int  gemm_trace_write_chrome(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
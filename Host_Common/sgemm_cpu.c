@@ -0,0 +1,408 @@
+/********************************************************************
+ * sgemm_cpu.c
+ *  - GotoBLAS-style blocking:
+ *      jc (NC) -> pc (KC): pack B panel (KC x NC, NR-wide strips)
+ *              -> ic (MC): pack A block (MC x KC, MR-high strips)
+ *              -> jr / ir : MR x NR micro-kernel from packed strips
+ *  - Edge tiles are zero-padded in the packed buffers, so every
+ *    micro-kernel call is a full MR x NR tile
+ *  - Threads split M into MR-aligned row ranges, each with its own
+ *    packing buffers
+ ********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "sgemm_cpu.h"
+
+#if defined(__linux__) && !defined(SGEMM_NO_THREADS)
+#define SGEMM_HAVE_PTHREADS 1
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SGEMM_HAVE_NEON 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SGEMM_HAVE_SSE 1
+#if defined(__GNUC__)
+#define SGEMM_HAVE_AVX2 1
+#endif
+#endif
+
+// ---------------- Blocking ----------------
+#define MR 4
+#define NR 8
+#define MC 64      // A block  MC x KC = 32 KB (A9 L1)
+#define KC 128
+#define NC 512     // B panel  KC x NC = 256 KB (A9 L2 512 KB)
+
+#define SGEMM_MAX_THREADS 64
+
+typedef void (*sgemm_ukr_t)(int kc, const float *Ap, const float *Bp, float *acc);
+
+static sgemm_impl_t sgemm_impl    = SGEMM_SIMD;
+static int          sgemm_threads = 0;
+
+// ================================================================
+// Micro-kernels: acc[MR][NR] = sum_k Ap[k][0..MR) x Bp[k][0..NR)
+// ================================================================
+static void ukr_scalar(int kc, const float *Ap, const float *Bp, float *acc){
+    float c[MR][NR];
+    memset(c, 0, sizeof(c));
+
+    for (int k = 0; k < kc; k++) {
+        for (int i = 0; i < MR; i++) {
+            float a = Ap[i];
+            for (int j = 0; j < NR; j++)
+                c[i][j] += a * Bp[j];
+        }
+        Ap += MR;
+        Bp += NR;
+    }
+    memcpy(acc, c, sizeof(c));
+}
+
+#ifdef SGEMM_HAVE_NEON
+static void ukr_neon(int kc, const float *Ap, const float *Bp, float *acc){
+    float32x4_t c00 = vdupq_n_f32(0.0f), c01 = vdupq_n_f32(0.0f);
+    float32x4_t c10 = vdupq_n_f32(0.0f), c11 = vdupq_n_f32(0.0f);
+    float32x4_t c20 = vdupq_n_f32(0.0f), c21 = vdupq_n_f32(0.0f);
+    float32x4_t c30 = vdupq_n_f32(0.0f), c31 = vdupq_n_f32(0.0f);
+
+    for (int k = 0; k < kc; k++) {
+        float32x4_t a  = vld1q_f32(Ap);
+        float32x4_t b0 = vld1q_f32(Bp);
+        float32x4_t b1 = vld1q_f32(Bp + 4);
+        float32x2_t al = vget_low_f32(a);
+        float32x2_t ah = vget_high_f32(a);
+
+        c00 = vmlaq_lane_f32(c00, b0, al, 0);  c01 = vmlaq_lane_f32(c01, b1, al, 0);
+        c10 = vmlaq_lane_f32(c10, b0, al, 1);  c11 = vmlaq_lane_f32(c11, b1, al, 1);
+        c20 = vmlaq_lane_f32(c20, b0, ah, 0);  c21 = vmlaq_lane_f32(c21, b1, ah, 0);
+        c30 = vmlaq_lane_f32(c30, b0, ah, 1);  c31 = vmlaq_lane_f32(c31, b1, ah, 1);
+
+        Ap += MR;
+        Bp += NR;
+    }
+
+    vst1q_f32(acc +  0, c00);  vst1q_f32(acc +  4, c01);
+    vst1q_f32(acc +  8, c10);  vst1q_f32(acc + 12, c11);
+    vst1q_f32(acc + 16, c20);  vst1q_f32(acc + 20, c21);
+    vst1q_f32(acc + 24, c30);  vst1q_f32(acc + 28, c31);
+}
+#endif
+
+#ifdef SGEMM_HAVE_SSE
+static void ukr_sse(int kc, const float *Ap, const float *Bp, float *acc){
+    __m128 c[MR][2];
+    for (int i = 0; i < MR; i++) {
+        c[i][0] = _mm_setzero_ps();
+        c[i][1] = _mm_setzero_ps();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        __m128 b0 = _mm_load_ps(Bp);
+        __m128 b1 = _mm_load_ps(Bp + 4);
+        for (int i = 0; i < MR; i++) {
+            __m128 a = _mm_set1_ps(Ap[i]);
+            c[i][0] = _mm_add_ps(c[i][0], _mm_mul_ps(a, b0));
+            c[i][1] = _mm_add_ps(c[i][1], _mm_mul_ps(a, b1));
+        }
+        Ap += MR;
+        Bp += NR;
+    }
+
+    for (int i = 0; i < MR; i++) {
+        _mm_store_ps(acc + i*NR,     c[i][0]);
+        _mm_store_ps(acc + i*NR + 4, c[i][1]);
+    }
+}
+#endif
+
+#ifdef SGEMM_HAVE_AVX2
+__attribute__((target("avx2,fma")))
+static void ukr_avx2(int kc, const float *Ap, const float *Bp, float *acc){
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+
+    for (int k = 0; k < kc; k++) {
+        __m256 b = _mm256_load_ps(Bp);
+        c0 = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 0), b, c0);
+        c1 = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 1), b, c1);
+        c2 = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 2), b, c2);
+        c3 = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 3), b, c3);
+        Ap += MR;
+        Bp += NR;
+    }
+
+    _mm256_store_ps(acc +  0, c0);
+    _mm256_store_ps(acc +  8, c1);
+    _mm256_store_ps(acc + 16, c2);
+    _mm256_store_ps(acc + 24, c3);
+}
+
+static int cpu_has_avx2(void){
+    static int has = -1;
+    if (has < 0) {
+        __builtin_cpu_init();
+        has = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    return has;
+}
+#endif
+
+static sgemm_ukr_t simd_ukr(const char **name){
+#if defined(SGEMM_HAVE_NEON)
+    if (name) *name = "neon";
+    return ukr_neon;
+#else
+#if defined(SGEMM_HAVE_AVX2)
+    if (cpu_has_avx2()) {
+        if (name) *name = "avx2";
+        return ukr_avx2;
+    }
+#endif
+#if defined(SGEMM_HAVE_SSE)
+    if (name) *name = "sse";
+    return ukr_sse;
+#else
+    if (name) *name = "scalar";
+    return ukr_scalar;
+#endif
+#endif
+}
+
+// ================================================================
+// Packing
+// ================================================================
+// A[mc][kc] -> MR-high strips: strip s holds rows s*MR.., k-major
+static void pack_A(int mc, int kc, const float *A, int lda, float *Ap){
+    for (int i0 = 0; i0 < mc; i0 += MR) {
+        int mr = (mc - i0 < MR) ? mc - i0 : MR;
+        for (int k = 0; k < kc; k++) {
+            for (int i = 0; i < MR; i++)
+                *Ap++ = (i < mr) ? A[(i0 + i)*lda + k] : 0.0f;
+        }
+    }
+}
+
+// B[kc][nc] -> NR-wide strips: strip s holds cols s*NR.., k-major
+static void pack_B(int kc, int nc, const float *B, int ldb, float *Bp){
+    for (int j0 = 0; j0 < nc; j0 += NR) {
+        int nr = (nc - j0 < NR) ? nc - j0 : NR;
+        for (int k = 0; k < kc; k++) {
+            const float *b = B + k*ldb + j0;
+            for (int j = 0; j < NR; j++)
+                *Bp++ = (j < nr) ? b[j] : 0.0f;
+        }
+    }
+}
+
+// Per-thread packing buffers, allocated on first use and kept
+// (a 16x16 GEMM must not pay for malloc)
+typedef struct {
+    void  *raw;
+    float *Ap;     // MC x KC
+    float *Bp;     // KC x NC
+} sgemm_pack_buf_t;
+
+static sgemm_pack_buf_t sgemm_bufs[SGEMM_MAX_THREADS];
+
+static int pack_buf_get(int slot, float **Ap, float **Bp){
+    sgemm_pack_buf_t *pb = &sgemm_bufs[slot];
+    if (!pb->raw) {
+        size_t nfloats = (size_t)MC * KC + (size_t)KC * NC;
+        pb->raw = malloc(nfloats * sizeof(float) + 64);
+        if (!pb->raw) return -1;
+        pb->Ap = (float *)(((uintptr_t)pb->raw + 63) & ~(uintptr_t)63);
+        pb->Bp = pb->Ap + (size_t)MC * KC;
+    }
+    *Ap = pb->Ap;
+    *Bp = pb->Bp;
+    return 0;
+}
+
+// ================================================================
+// Blocked SGEMM on rows [m0, m1)
+// ================================================================
+typedef struct {
+    int slot;
+    int m0, m1, N, K;
+    const float *A; int lda;
+    const float *B; int ldb;
+    float *C; int ldc;
+    sgemm_ukr_t ukr;
+    int status;
+} sgemm_job_t;
+
+static void sgemm_blocked_rows(sgemm_job_t *job){
+    const int N = job->N, K = job->K;
+    const int lda = job->lda, ldb = job->ldb, ldc = job->ldc;
+
+    float *Ap, *Bp;
+    float acc[MR*NR] __attribute__((aligned(64)));
+
+    if (pack_buf_get(job->slot, &Ap, &Bp) != 0) {
+        job->status = -1;
+        return;
+    }
+
+    for (int i = job->m0; i < job->m1; i++)
+        memset(&job->C[i*ldc], 0, (size_t)N * sizeof(float));
+
+    for (int jc = 0; jc < N; jc += NC) {
+        int nc = (N - jc < NC) ? N - jc : NC;
+
+        for (int pc = 0; pc < K; pc += KC) {
+            int kc = (K - pc < KC) ? K - pc : KC;
+            pack_B(kc, nc, job->B + pc*ldb + jc, ldb, Bp);
+
+            for (int ic = job->m0; ic < job->m1; ic += MC) {
+                int mc = (job->m1 - ic < MC) ? job->m1 - ic : MC;
+                pack_A(mc, kc, job->A + ic*lda + pc, lda, Ap);
+
+                for (int jr = 0; jr < nc; jr += NR) {
+                    int nr = (nc - jr < NR) ? nc - jr : NR;
+
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = (mc - ir < MR) ? mc - ir : MR;
+
+                        job->ukr(kc, Ap + ir*kc, Bp + jr*kc, acc);
+
+                        float *c = &job->C[(ic + ir)*ldc + jc + jr];
+                        for (int i = 0; i < mr; i++)
+                            for (int j = 0; j < nr; j++)
+                                c[i*ldc + j] += acc[i*NR + j];
+                    }
+                }
+            }
+        }
+    }
+
+    job->status = 0;
+}
+
+#ifdef SGEMM_HAVE_PTHREADS
+static void *sgemm_thread(void *arg){
+    sgemm_blocked_rows((sgemm_job_t *)arg);
+    return NULL;
+}
+#endif
+
+static void sgemm_naive(int M, int N, int K,
+                        const float *A, int lda,
+                        const float *B, int ldb,
+                        float *C, int ldc){
+    for (int i = 0; i < M; i++)
+        for (int j = 0; j < N; j++) {
+            float s = 0;
+            for (int k = 0; k < K; k++)
+                s += A[i*lda + k] * B[k*ldb + j];
+            C[i*ldc + j] = s;
+        }
+}
+
+// ================================================================
+// Public API
+// ================================================================
+void sgemm_set_impl(sgemm_impl_t impl){ sgemm_impl = impl; }
+sgemm_impl_t sgemm_get_impl(void){ return sgemm_impl; }
+
+const char *sgemm_impl_name(sgemm_impl_t impl){
+    const char *name = "scalar";
+    switch (impl) {
+    case SGEMM_NAIVE:   return "naive";
+    case SGEMM_BLOCKED: return "blocked";
+    case SGEMM_SIMD:    simd_ukr(&name); return name;
+    }
+    return "?";
+}
+
+void sgemm_set_threads(int n){ sgemm_threads = n; }
+
+int sgemm_get_threads(void){
+#ifdef SGEMM_HAVE_PTHREADS
+    int n = sgemm_threads;
+    if (n <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        n = (online > 0) ? (int)online : 1;
+    }
+    return (n > SGEMM_MAX_THREADS) ? SGEMM_MAX_THREADS : n;
+#else
+    return 1;
+#endif
+}
+
+void sgemm_cpu(int M, int N, int K,
+               const float *A, int lda,
+               const float *B, int ldb,
+               float *C, int ldc){
+    if (M <= 0 || N <= 0) return;
+
+    if (sgemm_impl == SGEMM_NAIVE) {
+        sgemm_naive(M, N, K, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    sgemm_ukr_t ukr = (sgemm_impl == SGEMM_SIMD) ? simd_ukr(NULL) : ukr_scalar;
+
+    // row ranges: multiples of MR, at most one per thread
+    int strips  = (M + MR - 1) / MR;
+    int nthr    = sgemm_get_threads();
+    if (nthr > strips) nthr = strips;
+
+    sgemm_job_t jobs[SGEMM_MAX_THREADS];
+    int per = (strips + nthr - 1) / nthr;
+    for (int t = 0; t < nthr; t++) {
+        jobs[t].slot = t;
+        jobs[t].m0  = t * per * MR;
+        jobs[t].m1  = ((t + 1) * per * MR < M) ? (t + 1) * per * MR : M;
+        jobs[t].N   = N;   jobs[t].K   = K;
+        jobs[t].A   = A;   jobs[t].lda = lda;
+        jobs[t].B   = B;   jobs[t].ldb = ldb;
+        jobs[t].C   = C;   jobs[t].ldc = ldc;
+        jobs[t].ukr = ukr;
+        jobs[t].status = 0;
+    }
+
+#ifdef SGEMM_HAVE_PTHREADS
+    pthread_t tid[SGEMM_MAX_THREADS];
+    int started[SGEMM_MAX_THREADS];
+    for (int t = 1; t < nthr; t++) {
+        started[t] = 0;
+        if (jobs[t].m0 >= jobs[t].m1) continue;
+        started[t] = (pthread_create(&tid[t], NULL, sgemm_thread, &jobs[t]) == 0);
+        if (!started[t]) sgemm_blocked_rows(&jobs[t]);
+    }
+    if (jobs[0].m0 < jobs[0].m1) sgemm_blocked_rows(&jobs[0]);
+    for (int t = 1; t < nthr; t++)
+        if (started[t]) pthread_join(tid[t], NULL);
+#else
+    for (int t = 0; t < nthr; t++)
+        if (jobs[t].m0 < jobs[t].m1) sgemm_blocked_rows(&jobs[t]);
+#endif
+
+    // packing buffer allocation failed: fall back
+    for (int t = 0; t < nthr; t++)
+        if (jobs[t].status != 0) {
+            sgemm_naive(M, N, K, A, lda, B, ldb, C, ldc);
+            return;
+        }
+}
+
+int sgemm_route_to_cpu(const sgemm_route_t *r, int M, int N, int K){
+    if (!r->edge_tiles && (M % r->tile || N % r->tile || K % r->tile)) return 1;
+    if (r->cpu_gflops <= 0) return 0;
+    if (r->accel_gflops <= 0) return 1;
+
+    double flops  = 2.0 * (double)M * (double)N * (double)K;
+    double cpu_us = flops / (r->cpu_gflops * 1e3);
+    double acc_us = r->accel_fixed_us + flops / (r->accel_gflops * 1e3);
+    return cpu_us <= acc_us;
+}
@@ -0,0 +1,59 @@
+/********************************************************************
+ * sgemm_cpu.h
+ *  - CPU SGEMM baseline / fallback for the host programs
+ *  - C = A * B, row-major, arbitrary M x N x K and leading dims
+ *
+ *  - Implementations (selectable at runtime):
+ *      SGEMM_NAIVE   : ijk triple loop (the old gemm_sw)
+ *      SGEMM_BLOCKED : packed panels + register-blocked 4x8 micro-kernel (scalar)
+ *      SGEMM_SIMD    : same blocking, NEON / SSE / AVX2+FMA micro-kernel
+ *  - Threads: pthreads on Linux (PetaLinux on both A9 cores, or any
+ *    build server), always 1 on the standalone BSP
+ *  - Packing buffers are allocated once and reused: not reentrant
+ ********************************************************************/
+#ifndef SGEMM_CPU_H
+#define SGEMM_CPU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SGEMM_NAIVE   = 0,
+    SGEMM_BLOCKED = 1,
+    SGEMM_SIMD    = 2
+} sgemm_impl_t;
+
+// host.c may #define N / K: keep parameter names lowercase here
+void sgemm_cpu(int m, int n, int k,
+               const float *a, int lda,
+               const float *b, int ldb,
+               float *c, int ldc);
+
+void         sgemm_set_impl(sgemm_impl_t impl);
+sgemm_impl_t sgemm_get_impl(void);
+const char  *sgemm_impl_name(sgemm_impl_t impl);   // "naive", "blocked", "neon", "avx2", ...
+
+// n <= 0: all online cores (1 on standalone)
+void sgemm_set_threads(int n);
+int  sgemm_get_threads(void);
+
+// ---------------- CPU / accelerator routing ----------------
+// Predicted time = fixed + flops / rate. Shapes the accelerator cannot
+// run (M, N or K not a multiple of tile, unless it pads edge tiles in
+// PL) always go to the CPU.
+typedef struct {
+    int    tile;            // accelerator tile size (16)
+    double cpu_gflops;      // measured sgemm_cpu rate
+    double accel_gflops;    // accelerator steady-state rate (board measurement)
+    double accel_fixed_us;  // per-call setup (AXI-Lite, DMA descriptors, cache)
+    int    edge_tiles;      // 1: accelerator handles partial edge tiles (Matmul_4)
+} sgemm_route_t;
+
+int sgemm_route_to_cpu(const sgemm_route_t *r, int m, int n, int k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,175 @@
+// ================================================================
+// xaxidma.h  (Host_Emu)
+//  - Simple-mode AXI DMA: MM2S pushes words into the emulated IP
+//    s_in stream, S2MM drains s_out into the destination buffer
+//  - Transfers complete synchronously; XAxiDma_Busy() reports 1
+//    only while an S2MM transfer is still waiting for kernel output
+//  - Scatter-gather mode (XEMU_DMA_SG=1): the BD ring subset of the
+//    xaxidma_bdring.h / xaxidma_bd.h API. MM2S BDs complete inside
+//    XAxiDma_BdRingToHw, S2MM BDs complete as kernel output arrives.
+//    XAxiDma_SimpleTransfer fails in SG mode, as on hardware
+// ================================================================
+#ifndef XAXIDMA_H
+#define XAXIDMA_H
+
+#include <string.h>
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#define XAXIDMA_DMA_TO_DEVICE 0x00
+#define XAXIDMA_DEVICE_TO_DMA 0x01
+
+// ------------------------------
+// Buffer descriptor (xaxidma_hw.h layout, 64 B)
+// ------------------------------
+#define XAXIDMA_BD_NDESC_OFFSET      0x00
+#define XAXIDMA_BD_BUFA_OFFSET       0x08
+#define XAXIDMA_BD_BUFA_MSB_OFFSET   0x0C
+#define XAXIDMA_BD_CTRL_LEN_OFFSET   0x18
+#define XAXIDMA_BD_STS_OFFSET        0x1C
+#define XAXIDMA_BD_ID_OFFSET         0x34
+#define XAXIDMA_BD_NUM_WORDS         16U
+
+#define XAXIDMA_BD_MINIMUM_ALIGNMENT 0x40
+
+#define XAXIDMA_BD_CTRL_TXSOF_MASK   0x08000000
+#define XAXIDMA_BD_CTRL_TXEOF_MASK   0x04000000
+#define XAXIDMA_BD_CTRL_ALL_MASK     0x0C000000
+
+#define XAXIDMA_BD_STS_COMPLETE_MASK   0x80000000
+#define XAXIDMA_BD_STS_DEC_ERR_MASK    0x40000000
+#define XAXIDMA_BD_STS_SLV_ERR_MASK    0x20000000
+#define XAXIDMA_BD_STS_INT_ERR_MASK    0x10000000
+#define XAXIDMA_BD_STS_ALL_ERR_MASK    0x70000000
+#define XAXIDMA_BD_STS_RXSOF_MASK      0x08000000
+#define XAXIDMA_BD_STS_RXEOF_MASK      0x04000000
+#define XAXIDMA_BD_STS_ACTUAL_LEN_MASK 0x007FFFFF
+#define XAXIDMA_BD_STS_ALL_MASK        0xFC000000
+
+#define XAXIDMA_ALL_BDS     0x0FFFFFFF
+
+// Channel interrupts (DMACR enable / DMASR status bits)
+#define XAXIDMA_IRQ_IOC_MASK   0x00001000
+#define XAXIDMA_IRQ_DELAY_MASK 0x00002000
+#define XAXIDMA_IRQ_ERROR_MASK 0x00004000
+#define XAXIDMA_IRQ_ALL_MASK   0x00007000
+
+typedef u32 XAxiDma_Bd[XAXIDMA_BD_NUM_WORDS];
+
+// Ring bookkeeping follows the driver: BDs move
+//   free -> (Alloc) -> pre -> (ToHw) -> hw -> (FromHw) -> post -> (Free) -> free
+typedef struct {
+    int         IsRxChannel;
+    int         RunState;        // 0 halted, 1 started
+    u32         MaxTransferLen;
+    UINTPTR     FirstBdAddr;
+    UINTPTR     LastBdAddr;
+    u32         Separation;
+    XAxiDma_Bd *FreeHead;
+    XAxiDma_Bd *PreHead;
+    XAxiDma_Bd *HwHead;
+    XAxiDma_Bd *HwTail;
+    XAxiDma_Bd *PostHead;
+    int         FreeCnt;
+    int         PreCnt;
+    int         HwCnt;
+    int         PostCnt;
+    int         AllCnt;
+} XAxiDma_BdRing;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    u32     DeviceId;
+    UINTPTR BaseAddr;
+    int     HasMm2S;
+    int     HasS2Mm;
+    int     HasSg;
+} XAxiDma_Config;
+
+typedef struct {
+    UINTPTR RegBase;
+    int     HasMm2S;
+    int     HasS2Mm;
+    int     HasSg;
+    int     Initialized;
+    XAxiDma_BdRing TxBdRing;
+    XAxiDma_BdRing RxBdRing[1];
+} XAxiDma;
+
+XAxiDma_Config *XAxiDma_LookupConfig(u32 DeviceId);
+int  XAxiDma_CfgInitialize(XAxiDma *InstancePtr, XAxiDma_Config *Config);
+void XAxiDma_Reset(XAxiDma *InstancePtr);
+int  XAxiDma_ResetIsDone(XAxiDma *InstancePtr);
+int  XAxiDma_SimpleTransfer(XAxiDma *InstancePtr, UINTPTR BuffAddr, u32 Length, int Direction);
+u32  XAxiDma_Busy(XAxiDma *InstancePtr, int Direction);
+
+// Interrupts: IOC is raised when a simple transfer or BD completes;
+// the channel interrupt line stays asserted until acknowledged
+void XAxiDma_IntrEnable(XAxiDma *InstancePtr, u32 Mask, int Direction);
+void XAxiDma_IntrDisable(XAxiDma *InstancePtr, u32 Mask, int Direction);
+u32  XAxiDma_IntrGetIrq(XAxiDma *InstancePtr, int Direction);
+void XAxiDma_IntrAckIrq(XAxiDma *InstancePtr, u32 Mask, int Direction);
+
+#define XAxiDma_HasSg(InstancePtr) ((InstancePtr)->HasSg ? TRUE : FALSE)
+
+// ------------------------------
+// Scatter-gather (xaxidma_bdring.h)
+// ------------------------------
+#define XAxiDma_GetTxRing(InstancePtr) (&((InstancePtr)->TxBdRing))
+#define XAxiDma_GetRxRing(InstancePtr) (&((InstancePtr)->RxBdRing[0]))
+
+#define XAxiDma_BdRingCntCalc(Alignment, Bytes) \
+    (u32)((Bytes) / ((sizeof(XAxiDma_Bd) + ((Alignment) - 1)) & ~((Alignment) - 1)))
+#define XAxiDma_BdRingGetFreeCnt(RingPtr) ((RingPtr)->FreeCnt)
+#define XAxiDma_BdRingGetCnt(RingPtr)     ((RingPtr)->AllCnt)
+#define XAxiDma_BdRingNext(RingPtr, BdPtr) \
+    (((UINTPTR)(BdPtr) >= (RingPtr)->LastBdAddr) ? \
+        (XAxiDma_Bd *)(RingPtr)->FirstBdAddr : \
+        (XAxiDma_Bd *)((UINTPTR)(BdPtr) + (RingPtr)->Separation))
+
+int  XAxiDma_BdRingCreate(XAxiDma_BdRing *RingPtr, UINTPTR PhysAddr,
+                          UINTPTR VirtAddr, u32 Alignment, int BdCount);
+int  XAxiDma_BdRingClone(XAxiDma_BdRing *RingPtr, XAxiDma_Bd *SrcBdPtr);
+int  XAxiDma_BdRingStart(XAxiDma_BdRing *RingPtr);
+int  XAxiDma_BdRingAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd **BdSetPtr);
+int  XAxiDma_BdRingToHw(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr);
+int  XAxiDma_BdRingFromHw(XAxiDma_BdRing *RingPtr, int BdLimit, XAxiDma_Bd **BdSetPtr);
+int  XAxiDma_BdRingFree(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr);
+void XAxiDma_BdRingIntDisable(XAxiDma_BdRing *RingPtr, u32 Mask);
+
+// ------------------------------
+// Buffer descriptor access (xaxidma_bd.h)
+// ------------------------------
+#define XAxiDma_BdRead(BdPtr, Offset) \
+    (*(u32 *)((UINTPTR)(BdPtr) + (Offset)))
+#define XAxiDma_BdWrite(BdPtr, Offset, Data) \
+    (*(u32 *)((UINTPTR)(BdPtr) + (Offset)) = (u32)(Data))
+
+// keeps NDESC (0x00..0x07)
+#define XAxiDma_BdClear(BdPtr) \
+    memset((void *)((UINTPTR)(BdPtr) + XAXIDMA_BD_BUFA_OFFSET), 0, 48)
+#define XAxiDma_BdSetId(BdPtr, Id) \
+    XAxiDma_BdWrite((BdPtr), XAXIDMA_BD_ID_OFFSET, (u32)(Id))
+#define XAxiDma_BdGetId(BdPtr) \
+    XAxiDma_BdRead((BdPtr), XAXIDMA_BD_ID_OFFSET)
+#define XAxiDma_BdGetSts(BdPtr) \
+    (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_STS_OFFSET) & XAXIDMA_BD_STS_ALL_MASK)
+#define XAxiDma_BdGetActualLength(BdPtr, LengthMask) \
+    (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_STS_OFFSET) & (LengthMask))
+#define XAxiDma_BdGetLength(BdPtr, LengthMask) \
+    (XAxiDma_BdRead((BdPtr), XAXIDMA_BD_CTRL_LEN_OFFSET) & (LengthMask))
+
+int     XAxiDma_BdSetBufAddr(XAxiDma_Bd *BdPtr, UINTPTR Addr);
+UINTPTR XAxiDma_BdGetBufAddr(XAxiDma_Bd *BdPtr);
+int     XAxiDma_BdSetLength(XAxiDma_Bd *BdPtr, u32 LenBytes, u32 LengthMask);
+void    XAxiDma_BdSetCtrl(XAxiDma_Bd *BdPtr, u32 Data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
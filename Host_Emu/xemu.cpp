@@ -0,0 +1,857 @@
+// ================================================================
+// xemu.cpp  (Host_Emu core)
+//  - Linux emulation of the standalone BSP calls used by host.c:
+//      XAxiDma_*   : MM2S -> s_in, s_out -> S2MM (simple or SG BD rings)
+//      Xil_Out32/In32 : GEMM IP s_axilite register file (CTRL)
+//      Xil_DCache* / Xil_SetTlbAttributes : counted no-ops
+//      XTime_*     : CLOCK_MONOTONIC scaled to CPU/2 ticks
+//      XScuGic_* / Xil_Exception* / wfi : DMA interrupts delivered to
+//                    the registered handlers at emulator entry points
+//      XScuTimer_* : A9 private timer on the XTime clock (interrupt
+//                    only; wfi() sleeps until it when nothing else can
+//                    wake the core)
+//  - The HLS kernel is C-simulated synchronously inside the call that
+//    completes its input (MM2S submit or AP_CTRL start)
+//
+//  - Environment:
+//      XEMU_STATS=1   print transfer/cache/register/kernel totals at exit
+//      XEMU_HIDE_PL=1 exclude kernel C-sim time from XTime_GetTime
+//      XEMU_DMA_SG=1  AXI DMA configured with scatter-gather (HasSg)
+// ================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+
+#include "xemu.h"
+#include "xparameters.h"
+#include "xaxidma.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+#include "xil_io.h"
+#include "xtime_l.h"
+#include "xscugic.h"
+#include "xscutimer.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+
+#define CTRL_BASE XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#define CTRL_HIGH XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR
+
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define AP_READY        0x08
+#define AP_AUTO_RESTART 0x80
+
+// ------------------------------
+// Emulator state
+// ------------------------------
+struct XEmu_Stats {
+    unsigned long mm2s_xfers, s2mm_xfers;
+    unsigned long tx_tohw, rx_tohw;
+    unsigned long long mm2s_bytes, s2mm_bytes;
+    unsigned long flush_calls, inval_calls;
+    unsigned long long flush_bytes, inval_bytes;
+    unsigned long mmu_sections;
+    unsigned long reg_writes, reg_reads;
+    unsigned long kernel_runs;
+    unsigned long irqs;
+    double pl_ns;
+};
+
+struct XEmu_S2mm {
+    int  busy;
+    u8  *dst;
+    u32  len;
+    u32  got;
+    XAxiDma_Bd *bd;              // SG: descriptor to complete, else 0
+    int  mid_pkt;                // SG: previous BD ended without TLAST
+};
+
+struct XEmu_State {
+    hls::stream<xemu_axis_t> s_in;
+    hls::stream<xemu_axis_t> s_out;
+    std::deque<u32> in_words;    // TDATA of s_in, for XEmu_InPeek
+
+    u32  regs[XEMU_NUM_REGS];
+    int  start_pending;
+    long runs_left;              // runs_per_start: invocations left of this start
+    int  auto_restart;
+    int  done;
+    int  ready;
+
+    long tlast_cnt;              // axis_tlast_gen beat counter
+    XEmu_S2mm s2mm;
+    std::deque<XAxiDma_Bd *> rx_q;   // SG: S2MM BDs handed to hardware
+
+    // interrupts: DMA channel enable/status -> GIC -> IRQ exception
+    u32  dma_irq_en[2];          // [XAXIDMA_DMA_TO_DEVICE], [XAXIDMA_DEVICE_TO_DMA]
+    u32  dma_irq_sts[2];
+    struct { int run; int reload; int irq_en; int sts; u32 load; double expiry_ns; } tmr;   // private timer
+    struct { Xil_InterruptHandler h; void *ref; int en; } gic[XSCUGIC_MAX_NUM_INTR_INPUTS + 1];
+    Xil_ExceptionHandler irq_handler;
+    void *irq_data;
+    int  irq_enabled;
+    int  in_isr;
+
+    int  hide_pl;
+    int  print_stats;
+    XEmu_Stats st;
+
+    XEmu_State() : s_in("xemu_s_in"), s_out("xemu_s_out") {}
+};
+
+static XEmu_State *emu_state = 0;
+
+static double now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void emu_print_stats(void){
+    XEmu_State &e = *emu_state;
+    fprintf(stderr, "\n[xemu] IP %s\n", XEmu_Ip_Top.name);
+    fprintf(stderr, "[xemu] MM2S  %lu xfers, %llu bytes\n", e.st.mm2s_xfers, e.st.mm2s_bytes);
+    fprintf(stderr, "[xemu] S2MM  %lu xfers, %llu bytes\n", e.st.s2mm_xfers, e.st.s2mm_bytes);
+    if (e.st.tx_tohw || e.st.rx_tohw)
+        fprintf(stderr, "[xemu] SG    %lu MM2S / %lu S2MM BdRingToHw calls\n", e.st.tx_tohw, e.st.rx_tohw);
+    fprintf(stderr, "[xemu] flush %lu calls, %llu bytes\n", e.st.flush_calls, e.st.flush_bytes);
+    fprintf(stderr, "[xemu] inval %lu calls, %llu bytes\n", e.st.inval_calls, e.st.inval_bytes);
+    if (e.st.mmu_sections)
+        fprintf(stderr, "[xemu] MMU   %lu section attribute changes\n", e.st.mmu_sections);
+    fprintf(stderr, "[xemu] AXI-Lite %lu writes, %lu reads\n", e.st.reg_writes, e.st.reg_reads);
+    if (e.st.irqs)
+        fprintf(stderr, "[xemu] IRQ   %lu handled\n", e.st.irqs);
+    fprintf(stderr, "[xemu] kernel %lu runs, %.3f ms C-sim\n", e.st.kernel_runs, e.st.pl_ns * 1e-6);
+}
+
+static XEmu_State &emu(void){
+    if (!emu_state) {
+        emu_state = new XEmu_State();
+        XEmu_State &e = *emu_state;
+        memset(e.regs, 0, sizeof(e.regs));
+        e.start_pending = 0;
+        e.runs_left     = 0;
+        e.auto_restart  = 0;
+        e.done          = 0;
+        e.ready         = 0;
+        e.tlast_cnt     = 0;
+        memset(&e.s2mm, 0, sizeof(e.s2mm));
+        memset(&e.st, 0, sizeof(e.st));
+        memset(e.dma_irq_en,  0, sizeof(e.dma_irq_en));
+        memset(e.dma_irq_sts, 0, sizeof(e.dma_irq_sts));
+        memset(e.gic, 0, sizeof(e.gic));
+        memset(&e.tmr, 0, sizeof(e.tmr));
+        e.irq_handler = 0;
+        e.irq_data    = 0;
+        e.irq_enabled = 0;
+        e.in_isr      = 0;
+
+        const char *hide  = getenv("XEMU_HIDE_PL");
+        const char *stats = getenv("XEMU_STATS");
+        e.hide_pl     = (hide  && hide[0]  == '1');
+        e.print_stats = (stats && stats[0] == '1');
+        if (e.print_stats) atexit(emu_print_stats);
+    }
+    return *emu_state;
+}
+
+// ------------------------------
+// Stream plumbing
+// ------------------------------
+static void emu_s2mm_next_bd(XEmu_State &e){
+    if (e.s2mm.busy || e.rx_q.empty()) return;
+    XAxiDma_Bd *bd = e.rx_q.front();
+    e.rx_q.pop_front();
+    e.s2mm.busy = 1;
+    e.s2mm.dst  = (u8 *)XAxiDma_BdGetBufAddr(bd);
+    e.s2mm.len  = XAxiDma_BdGetLength(bd, XAXIDMA_BD_STS_ACTUAL_LEN_MASK);
+    e.s2mm.got  = 0;
+    e.s2mm.bd   = bd;
+    e.st.s2mm_xfers++;
+}
+
+static int emu_drain_s2mm(XEmu_State &e){
+    int moved = 0;
+    emu_s2mm_next_bd(e);
+    while (e.s2mm.busy && !e.s_out.empty()) {
+        xemu_axis_t w = e.s_out.read();
+        u32 v = (u32)w.data.to_uint();
+        if (e.s2mm.got + 4 <= e.s2mm.len) {
+            memcpy(e.s2mm.dst + e.s2mm.got, &v, 4);
+            e.s2mm.got += 4;
+        }
+        moved = 1;
+        if (w.last || e.s2mm.got >= e.s2mm.len) {
+            e.s2mm.busy = 0;
+            e.st.s2mm_bytes += e.s2mm.got;
+            e.dma_irq_sts[XAXIDMA_DEVICE_TO_DMA] |= XAXIDMA_IRQ_IOC_MASK;
+            if (e.s2mm.bd) {
+                XAxiDma_BdWrite(e.s2mm.bd, XAXIDMA_BD_STS_OFFSET,
+                                XAXIDMA_BD_STS_COMPLETE_MASK |
+                                (e.s2mm.mid_pkt ? 0 : XAXIDMA_BD_STS_RXSOF_MASK) |
+                                (w.last ? XAXIDMA_BD_STS_RXEOF_MASK : 0) | e.s2mm.got);
+                e.s2mm.bd = 0;
+                e.s2mm.mid_pkt = !w.last;    // packet continues in the next BD
+            }
+            emu_s2mm_next_bd(e);
+        }
+    }
+    return moved;
+}
+
+// MM2S: Length bytes -> s_in, TLAST per binding
+static void emu_mm2s_push(XEmu_State &e, const u8 *src, u32 Length){
+    const int frame = XEmu_Ip_Top.tlast_frame_words;
+    const u32 words = Length / 4;
+
+    for (u32 i = 0; i < words; i++) {
+        u32 v;
+        memcpy(&v, src + 4*i, 4);
+
+        xemu_axis_t w;
+        w.data = v;
+        w.keep = 0xF;
+        w.strb = 0xF;
+        w.user = 0;
+        w.id   = 0;
+        w.dest = 0;
+        if (frame > 0) {
+            w.last = (e.tlast_cnt == frame - 1) ? 1 : 0;
+            e.tlast_cnt = (e.tlast_cnt == frame - 1) ? 0 : e.tlast_cnt + 1;
+        } else {
+            w.last = (i == words - 1) ? 1 : 0;
+        }
+        e.s_in.write(w);
+        e.in_words.push_back(v);
+    }
+    e.st.mm2s_xfers++;
+    e.st.mm2s_bytes += Length;
+    e.dma_irq_sts[XAXIDMA_DMA_TO_DEVICE] |= XAXIDMA_IRQ_IOC_MASK;
+}
+
+static int emu_try_run_kernel(XEmu_State &e){
+    const XEmu_Ip &ip = XEmu_Ip_Top;
+
+    if (ip.ctrl_hs && !e.start_pending) return 0;
+    if (ip.ctrl_hs && e.runs_left == 0) {
+        e.runs_left = ip.runs_per_start ? ip.runs_per_start(e.regs) : 1;
+        if (e.runs_left < 1) e.runs_left = 1;
+    }
+
+    long need = ip.words_needed(e.regs);
+    if (need < 0) return 0;
+    if (!ip.ctrl_hs && need == 0) return 0;
+    if ((long)e.s_in.size() < need) return 0;
+
+    long before = (long)e.s_in.size();
+    double t0 = now_ns();
+    ip.run(e.s_in, e.s_out, e.regs);
+    e.st.pl_ns += now_ns() - t0;
+    e.in_words.erase(e.in_words.begin(), e.in_words.begin() + (before - (long)e.s_in.size()));
+    e.st.kernel_runs++;
+
+    if (ip.ctrl_hs && ip.start_done && ip.start_done(e.regs)) e.runs_left = 1;
+    if (ip.ctrl_hs && --e.runs_left > 0) return 1;     // more results of this start
+    if (ip.ctrl_hs) {
+        e.start_pending = e.auto_restart;
+        e.done  = 1;
+        e.ready = 1;
+    }
+    return 1;
+}
+
+// ------------------------------
+// Interrupts
+// ------------------------------
+static u32 emu_dma_irq_id(int dir){
+    return (dir == XAXIDMA_DMA_TO_DEVICE) ? XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID
+                                          : XPAR_FABRIC_AXIDMA_0_S2MM_INTROUT_VEC_ID;
+}
+
+static double emu_xtime_ns(XEmu_State &e){
+    return now_ns() - (e.hide_pl ? e.st.pl_ns : 0.0);
+}
+
+// Private timer count reached 0: event flag (interrupt status) set
+static void emu_tmr_poll(XEmu_State &e){
+    if (!e.tmr.run || emu_xtime_ns(e) < e.tmr.expiry_ns) return;
+    e.tmr.sts = 1;
+    if (e.tmr.reload) e.tmr.expiry_ns += (double)e.tmr.load * 1e9 / COUNTS_PER_SECOND;
+    else              e.tmr.run = 0;
+}
+
+// Lowest asserted + enabled GIC input, or -1
+static int emu_gic_pending(XEmu_State &e){
+    int best = -1;
+    emu_tmr_poll(e);
+    if (e.tmr.sts && e.tmr.irq_en && e.gic[XPAR_SCUTIMER_INTR].en && e.gic[XPAR_SCUTIMER_INTR].h)
+        best = (int)XPAR_SCUTIMER_INTR;
+    for (int dir = 0; dir < 2; dir++) {
+        if (!(e.dma_irq_sts[dir] & e.dma_irq_en[dir])) continue;
+        int id = (int)emu_dma_irq_id(dir);
+        if (!e.gic[id].en || !e.gic[id].h) continue;
+        if (best < 0 || id < best) best = id;
+    }
+    return best;
+}
+
+// Take interrupts until none is pending. Handlers run with further
+// delivery held off; whatever they raise is taken after they return
+static void emu_irq_dispatch(XEmu_State &e){
+    if (e.in_isr || !e.irq_enabled || !e.irq_handler) return;
+    while (e.irq_enabled && emu_gic_pending(e) >= 0) {
+        e.in_isr = 1;
+        e.irq_handler(e.irq_data);
+        e.in_isr = 0;
+    }
+}
+
+// Queued s_in words, for bindings whose input length depends on a
+// header word the kernel reads first
+long XEmu_InWords(void){
+    return (long)emu().in_words.size();
+}
+
+u32 XEmu_InPeek(long i){
+    return emu().in_words[i];
+}
+
+// Advance the emulated PL until nothing more can happen
+static void emu_pump(XEmu_State &e){
+    int progress;
+    do {
+        progress  = emu_try_run_kernel(e);
+        progress |= emu_drain_s2mm(e);
+    } while (progress);
+    emu_irq_dispatch(e);
+}
+
+// ================================================================
+// xil_io.h
+// ================================================================
+extern "C" void Xil_Out32(UINTPTR Addr, u32 Value){
+    XEmu_State &e = emu();
+    if (Addr < CTRL_BASE || Addr > CTRL_HIGH) return;
+
+    u32 off = (u32)(Addr - CTRL_BASE);
+    e.st.reg_writes++;
+
+    if (off == 0x00) {
+        e.auto_restart = (Value & AP_AUTO_RESTART) ? 1 : 0;
+        if (Value & AP_START) {
+            e.start_pending = 1;
+            e.runs_left     = 0;
+            e.done  = 0;
+            e.ready = 0;
+        }
+    } else if (off / 4 < XEMU_NUM_REGS) {
+        e.regs[off / 4] = Value;
+    }
+    emu_pump(e);
+}
+
+extern "C" u32 Xil_In32(UINTPTR Addr){
+    XEmu_State &e = emu();
+    if (Addr < CTRL_BASE || Addr > CTRL_HIGH) return 0;
+
+    u32 off = (u32)(Addr - CTRL_BASE);
+    e.st.reg_reads++;
+    emu_pump(e);
+
+    if (off == 0x00) {
+        u32 v = 0;
+        if (e.start_pending) v |= AP_START;
+        if (e.done)          v |= AP_DONE;
+        if (!e.start_pending) v |= AP_IDLE;
+        if (e.ready)         v |= AP_READY;
+        if (e.auto_restart)  v |= AP_AUTO_RESTART;
+        e.done  = 0;         // ap_done / ap_ready are clear-on-read
+        e.ready = 0;
+        return v;
+    }
+    return (off / 4 < XEMU_NUM_REGS) ? e.regs[off / 4] : 0;
+}
+
+// ================================================================
+// xil_cache.h
+// ================================================================
+extern "C" void Xil_DCacheEnable(void){}
+extern "C" void Xil_DCacheDisable(void){}
+extern "C" void Xil_DCacheFlush(void){ emu().st.flush_calls++; }
+extern "C" void Xil_DCacheInvalidate(void){ emu().st.inval_calls++; }
+
+extern "C" void Xil_DCacheFlushRange(INTPTR adr, u32 len){
+    (void)adr;
+    XEmu_State &e = emu();
+    e.st.flush_calls++;
+    e.st.flush_bytes += len;
+}
+
+extern "C" void Xil_DCacheInvalidateRange(INTPTR adr, u32 len){
+    (void)adr;
+    XEmu_State &e = emu();
+    e.st.inval_calls++;
+    e.st.inval_bytes += len;
+}
+
+// ================================================================
+// xil_mmu.h
+// ================================================================
+extern "C" void Xil_SetTlbAttributes(UINTPTR Addr, u32 attrib){
+    (void)Addr; (void)attrib;
+    emu().st.mmu_sections++;
+}
+
+// ================================================================
+// xtime_l.h
+// ================================================================
+extern "C" void XTime_GetTime(XTime *Xtime_Global){
+    XEmu_State &e = emu();
+    emu_pump(e);
+    *Xtime_Global = (XTime)(emu_xtime_ns(e) * ((double)COUNTS_PER_SECOND / 1e9));
+}
+
+extern "C" void XTime_SetTime(XTime Xtime_Global){ (void)Xtime_Global; }
+
+// ================================================================
+// xaxidma.h
+// ================================================================
+static XAxiDma_Config emu_dma_cfg = {
+    XPAR_AXIDMA_0_DEVICE_ID, XPAR_AXI_DMA_0_BASEADDR, 1, 1, XPAR_AXI_DMA_0_INCLUDE_SG
+};
+
+extern "C" XAxiDma_Config *XAxiDma_LookupConfig(u32 DeviceId){
+    emu();
+    const char *sg = getenv("XEMU_DMA_SG");
+    if (sg) emu_dma_cfg.HasSg = (sg[0] == '1');
+    return (DeviceId == emu_dma_cfg.DeviceId) ? &emu_dma_cfg : 0;
+}
+
+extern "C" int XAxiDma_CfgInitialize(XAxiDma *InstancePtr, XAxiDma_Config *Config){
+    if (!InstancePtr || !Config) return XST_INVALID_PARAM;
+    InstancePtr->RegBase     = Config->BaseAddr;
+    InstancePtr->HasMm2S     = Config->HasMm2S;
+    InstancePtr->HasS2Mm     = Config->HasS2Mm;
+    InstancePtr->HasSg       = Config->HasSg;
+    InstancePtr->Initialized = 1;
+
+    memset(&InstancePtr->TxBdRing, 0, sizeof(InstancePtr->TxBdRing));
+    memset(&InstancePtr->RxBdRing, 0, sizeof(InstancePtr->RxBdRing));
+    InstancePtr->TxBdRing.MaxTransferLen    = XAXIDMA_BD_STS_ACTUAL_LEN_MASK;
+    InstancePtr->RxBdRing[0].MaxTransferLen = XAXIDMA_BD_STS_ACTUAL_LEN_MASK;
+    InstancePtr->RxBdRing[0].IsRxChannel    = 1;
+    return XST_SUCCESS;
+}
+
+extern "C" void XAxiDma_Reset(XAxiDma *InstancePtr){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    memset(e.dma_irq_en,  0, sizeof(e.dma_irq_en));
+    memset(e.dma_irq_sts, 0, sizeof(e.dma_irq_sts));
+    memset(&e.s2mm, 0, sizeof(e.s2mm));
+    e.rx_q.clear();
+    e.tlast_cnt = 0;
+    InstancePtr->TxBdRing.RunState    = 0;
+    InstancePtr->RxBdRing[0].RunState = 0;
+}
+
+extern "C" int XAxiDma_ResetIsDone(XAxiDma *InstancePtr){
+    (void)InstancePtr;
+    return 1;
+}
+
+extern "C" int XAxiDma_SimpleTransfer(XAxiDma *InstancePtr, UINTPTR BuffAddr,
+                                      u32 Length, int Direction){
+    XEmu_State &e = emu();
+    if (!InstancePtr || !InstancePtr->Initialized || Length == 0 || (Length & 3))
+        return XST_INVALID_PARAM;
+    if (InstancePtr->HasSg) return XST_FAILURE;     // SG engine: BD rings only
+
+    if (Direction == XAXIDMA_DMA_TO_DEVICE) {
+        emu_mm2s_push(e, (const u8 *)BuffAddr, Length);
+    } else if (Direction == XAXIDMA_DEVICE_TO_DMA) {
+        if (e.s2mm.busy) return XST_FAILURE;
+        e.s2mm.busy = 1;
+        e.s2mm.dst  = (u8 *)BuffAddr;
+        e.s2mm.len  = Length;
+        e.s2mm.got  = 0;
+        e.s2mm.bd   = 0;
+        e.st.s2mm_xfers++;
+    } else {
+        return XST_INVALID_PARAM;
+    }
+
+    emu_pump(e);
+    return XST_SUCCESS;
+}
+
+extern "C" u32 XAxiDma_Busy(XAxiDma *InstancePtr, int Direction){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    emu_pump(e);
+    if (Direction == XAXIDMA_DEVICE_TO_DMA) return (e.s2mm.busy || !e.rx_q.empty()) ? TRUE : FALSE;
+    return FALSE;
+}
+
+extern "C" void XAxiDma_IntrEnable(XAxiDma *InstancePtr, u32 Mask, int Direction){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    e.dma_irq_en[Direction & 1] |= Mask & XAXIDMA_IRQ_ALL_MASK;
+    emu_pump(e);
+}
+
+extern "C" void XAxiDma_IntrDisable(XAxiDma *InstancePtr, u32 Mask, int Direction){
+    (void)InstancePtr;
+    emu().dma_irq_en[Direction & 1] &= ~Mask;
+}
+
+extern "C" u32 XAxiDma_IntrGetIrq(XAxiDma *InstancePtr, int Direction){
+    (void)InstancePtr;
+    return emu().dma_irq_sts[Direction & 1] & XAXIDMA_IRQ_ALL_MASK;
+}
+
+extern "C" void XAxiDma_IntrAckIrq(XAxiDma *InstancePtr, u32 Mask, int Direction){
+    (void)InstancePtr;
+    emu().dma_irq_sts[Direction & 1] &= ~Mask;
+}
+
+// ================================================================
+// xaxidma_bdring.h / xaxidma_bd.h  (scatter-gather)
+// ================================================================
+extern "C" int XAxiDma_BdSetBufAddr(XAxiDma_Bd *BdPtr, UINTPTR Addr){
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_BUFA_OFFSET, (u32)((u64)Addr & 0xFFFFFFFFu));
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_BUFA_MSB_OFFSET, (u32)((u64)Addr >> 32));
+    return XST_SUCCESS;
+}
+
+extern "C" UINTPTR XAxiDma_BdGetBufAddr(XAxiDma_Bd *BdPtr){
+    u64 lo = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_BUFA_OFFSET);
+    u64 hi = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_BUFA_MSB_OFFSET);
+    return (UINTPTR)((hi << 32) | lo);
+}
+
+extern "C" int XAxiDma_BdSetLength(XAxiDma_Bd *BdPtr, u32 LenBytes, u32 LengthMask){
+    if (LenBytes == 0 || LenBytes > LengthMask) return XST_INVALID_PARAM;
+    u32 v = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET, (v & ~LengthMask) | LenBytes);
+    return XST_SUCCESS;
+}
+
+extern "C" void XAxiDma_BdSetCtrl(XAxiDma_Bd *BdPtr, u32 Data){
+    u32 v = XAxiDma_BdRead(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
+    XAxiDma_BdWrite(BdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET,
+                    (v & ~XAXIDMA_BD_CTRL_ALL_MASK) | (Data & XAXIDMA_BD_CTRL_ALL_MASK));
+}
+
+extern "C" int XAxiDma_BdRingCreate(XAxiDma_BdRing *RingPtr, UINTPTR PhysAddr,
+                                    UINTPTR VirtAddr, u32 Alignment, int BdCount){
+    (void)PhysAddr;
+    if (BdCount <= 0 || Alignment < XAXIDMA_BD_MINIMUM_ALIGNMENT || (VirtAddr & (Alignment - 1)))
+        return XST_INVALID_PARAM;
+
+    RingPtr->RunState    = 0;
+    RingPtr->Separation  = (sizeof(XAxiDma_Bd) + (Alignment - 1)) & ~(Alignment - 1);
+    RingPtr->FirstBdAddr = VirtAddr;
+    RingPtr->LastBdAddr  = VirtAddr + (UINTPTR)(BdCount - 1) * RingPtr->Separation;
+    RingPtr->AllCnt  = BdCount;
+    RingPtr->FreeCnt = BdCount;
+    RingPtr->PreCnt  = RingPtr->HwCnt = RingPtr->PostCnt = 0;
+    RingPtr->FreeHead = RingPtr->PreHead = RingPtr->HwHead =
+    RingPtr->HwTail   = RingPtr->PostHead = (XAxiDma_Bd *)VirtAddr;
+
+    memset((void *)VirtAddr, 0, (size_t)BdCount * RingPtr->Separation);
+    XAxiDma_Bd *bd = (XAxiDma_Bd *)VirtAddr;
+    for (int i = 0; i < BdCount; i++) {
+        XAxiDma_Bd *next = XAxiDma_BdRingNext(RingPtr, bd);
+        XAxiDma_BdWrite(bd, XAXIDMA_BD_NDESC_OFFSET, (u32)(UINTPTR)next);
+        bd = next;
+    }
+    return XST_SUCCESS;
+}
+
+extern "C" int XAxiDma_BdRingClone(XAxiDma_BdRing *RingPtr, XAxiDma_Bd *SrcBdPtr){
+    if (RingPtr->RunState || RingPtr->FreeCnt != RingPtr->AllCnt) return XST_DMA_ERROR;
+
+    XAxiDma_Bd *bd = (XAxiDma_Bd *)RingPtr->FirstBdAddr;
+    for (int i = 0; i < RingPtr->AllCnt; i++) {
+        u32 ndesc = XAxiDma_BdRead(bd, XAXIDMA_BD_NDESC_OFFSET);
+        memcpy(bd, SrcBdPtr, sizeof(XAxiDma_Bd));
+        XAxiDma_BdWrite(bd, XAXIDMA_BD_NDESC_OFFSET, ndesc);
+        XAxiDma_BdWrite(bd, XAXIDMA_BD_STS_OFFSET, 0);
+        bd = XAxiDma_BdRingNext(RingPtr, bd);
+    }
+    return XST_SUCCESS;
+}
+
+// The emulated engine completes MM2S BDs at once and queues S2MM BDs
+// behind the current kernel output
+static void emu_sg_process(XEmu_State &e, XAxiDma_BdRing *RingPtr,
+                           XAxiDma_Bd *bd, int n){
+    for (int i = 0; i < n; i++, bd = XAxiDma_BdRingNext(RingPtr, bd)) {
+        if (RingPtr->IsRxChannel) {
+            e.rx_q.push_back(bd);
+        } else {
+            u32 len = XAxiDma_BdGetLength(bd, RingPtr->MaxTransferLen);
+            emu_mm2s_push(e, (const u8 *)XAxiDma_BdGetBufAddr(bd), len);
+            XAxiDma_BdWrite(bd, XAXIDMA_BD_STS_OFFSET, XAXIDMA_BD_STS_COMPLETE_MASK | len);
+        }
+    }
+    emu_pump(e);
+}
+
+extern "C" int XAxiDma_BdRingStart(XAxiDma_BdRing *RingPtr){
+    XEmu_State &e = emu();
+    if (RingPtr->RunState) return XST_SUCCESS;
+    RingPtr->RunState = 1;
+    if (RingPtr->HwCnt > 0) emu_sg_process(e, RingPtr, RingPtr->HwHead, RingPtr->HwCnt);
+    return XST_SUCCESS;
+}
+
+extern "C" int XAxiDma_BdRingAlloc(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd **BdSetPtr){
+    if (NumBd <= 0) return XST_INVALID_PARAM;
+    if (RingPtr->FreeCnt < NumBd) return XST_FAILURE;
+
+    *BdSetPtr = RingPtr->FreeHead;
+    for (int i = 0; i < NumBd; i++)
+        RingPtr->FreeHead = XAxiDma_BdRingNext(RingPtr, RingPtr->FreeHead);
+    RingPtr->FreeCnt -= NumBd;
+    RingPtr->PreCnt  += NumBd;
+    return XST_SUCCESS;
+}
+
+extern "C" int XAxiDma_BdRingToHw(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr){
+    XEmu_State &e = emu();
+    if (NumBd <= 0) return XST_INVALID_PARAM;
+    if (RingPtr->PreCnt < NumBd || BdSetPtr != RingPtr->PreHead) return XST_DMA_SG_LIST_ERROR;
+
+    XAxiDma_Bd *bd = BdSetPtr;
+    for (int i = 0; i < NumBd; i++) {
+        if (XAxiDma_BdGetLength(bd, RingPtr->MaxTransferLen) == 0) return XST_INVALID_PARAM;
+        // as the driver: an MM2S batch starts with TXSOF and ends with TXEOF
+        u32 ctrl = XAxiDma_BdRead(bd, XAXIDMA_BD_CTRL_LEN_OFFSET);
+        if (!RingPtr->IsRxChannel) {
+            if (i == 0 && !(ctrl & XAXIDMA_BD_CTRL_TXSOF_MASK)) {
+                fprintf(stderr, "[xemu] MM2S BdRingToHw: first BD without TXSOF\n");
+                return XST_FAILURE;
+            }
+            if (i == NumBd - 1 && !(ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK)) {
+                fprintf(stderr, "[xemu] MM2S BdRingToHw: last BD without TXEOF\n");
+                return XST_FAILURE;
+            }
+        }
+        XAxiDma_BdWrite(bd, XAXIDMA_BD_STS_OFFSET, 0);
+        RingPtr->HwTail = bd;
+        bd = XAxiDma_BdRingNext(RingPtr, bd);
+    }
+    RingPtr->PreHead = bd;
+    RingPtr->PreCnt -= NumBd;
+    RingPtr->HwCnt  += NumBd;
+
+    if (RingPtr->IsRxChannel) e.st.rx_tohw++;
+    else                      e.st.tx_tohw++;
+
+    if (RingPtr->RunState) emu_sg_process(e, RingPtr, BdSetPtr, NumBd);
+    return XST_SUCCESS;
+}
+
+extern "C" int XAxiDma_BdRingFromHw(XAxiDma_BdRing *RingPtr, int BdLimit, XAxiDma_Bd **BdSetPtr){
+    XEmu_State &e = emu();
+    emu_pump(e);
+
+    int n = 0;
+    XAxiDma_Bd *bd = RingPtr->HwHead;
+    while (n < RingPtr->HwCnt && n < BdLimit &&
+           (XAxiDma_BdRead(bd, XAXIDMA_BD_STS_OFFSET) & XAXIDMA_BD_STS_COMPLETE_MASK)) {
+        bd = XAxiDma_BdRingNext(RingPtr, bd);
+        n++;
+    }
+    if (n == 0) { *BdSetPtr = 0; return 0; }
+
+    *BdSetPtr = RingPtr->HwHead;
+    RingPtr->HwHead   = bd;
+    RingPtr->HwCnt   -= n;
+    RingPtr->PostCnt += n;
+    return n;
+}
+
+extern "C" int XAxiDma_BdRingFree(XAxiDma_BdRing *RingPtr, int NumBd, XAxiDma_Bd *BdSetPtr){
+    if (NumBd <= 0) return XST_INVALID_PARAM;
+    if (RingPtr->PostCnt < NumBd || BdSetPtr != RingPtr->PostHead) return XST_DMA_SG_LIST_ERROR;
+
+    for (int i = 0; i < NumBd; i++)
+        RingPtr->PostHead = XAxiDma_BdRingNext(RingPtr, RingPtr->PostHead);
+    RingPtr->PostCnt -= NumBd;
+    RingPtr->FreeCnt += NumBd;
+    return XST_SUCCESS;
+}
+
+extern "C" void XAxiDma_BdRingIntDisable(XAxiDma_BdRing *RingPtr, u32 Mask){
+    (void)RingPtr; (void)Mask;
+}
+
+// ================================================================
+// xscugic.h
+// ================================================================
+static XScuGic_Config emu_gic_cfg = {
+    XPAR_SCUGIC_0_DEVICE_ID, XPAR_SCUGIC_0_CPU_BASEADDR, XPAR_SCUGIC_0_DIST_BASEADDR
+};
+
+extern "C" XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId){
+    emu();
+    return (DeviceId == emu_gic_cfg.DeviceId) ? &emu_gic_cfg : 0;
+}
+
+extern "C" int XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr, u32 EffectiveAddr){
+    (void)EffectiveAddr;
+    if (!InstancePtr || !ConfigPtr) return XST_INVALID_PARAM;
+    InstancePtr->Config  = ConfigPtr;
+    InstancePtr->IsReady = 1;
+    return XST_SUCCESS;
+}
+
+extern "C" int XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id,
+                               Xil_InterruptHandler Handler, void *CallBackRef){
+    (void)InstancePtr;
+    if (Int_Id > XSCUGIC_MAX_NUM_INTR_INPUTS || !Handler) return XST_INVALID_PARAM;
+    XEmu_State &e = emu();
+    e.gic[Int_Id].h   = Handler;
+    e.gic[Int_Id].ref = CallBackRef;
+    return XST_SUCCESS;
+}
+
+extern "C" void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id){
+    (void)InstancePtr;
+    if (Int_Id > XSCUGIC_MAX_NUM_INTR_INPUTS) return;
+    XEmu_State &e = emu();
+    e.gic[Int_Id].h   = 0;
+    e.gic[Int_Id].ref = 0;
+    e.gic[Int_Id].en  = 0;
+}
+
+extern "C" void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id){
+    (void)InstancePtr;
+    if (Int_Id > XSCUGIC_MAX_NUM_INTR_INPUTS) return;
+    XEmu_State &e = emu();
+    e.gic[Int_Id].en = 1;
+    emu_pump(e);
+}
+
+extern "C" void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id){
+    (void)InstancePtr;
+    if (Int_Id > XSCUGIC_MAX_NUM_INTR_INPUTS) return;
+    emu().gic[Int_Id].en = 0;
+}
+
+extern "C" void XScuGic_SetPriorityTriggerType(XScuGic *InstancePtr, u32 Int_Id, u8 Priority, u8 Trigger){
+    (void)InstancePtr; (void)Int_Id; (void)Priority; (void)Trigger;
+}
+
+// One interrupt per entry, like the IAR read / EOI write pair
+extern "C" void XScuGic_InterruptHandler(XScuGic *InstancePtr){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    int id = emu_gic_pending(e);
+    if (id < 0) return;
+    e.st.irqs++;
+    e.gic[id].h(e.gic[id].ref);
+}
+
+// ================================================================
+// xil_exception.h / xpseudo_asm.h
+// ================================================================
+extern "C" void Xil_ExceptionInit(void){ emu(); }
+
+extern "C" void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data){
+    if (Exception_id != XIL_EXCEPTION_ID_INT) return;
+    XEmu_State &e = emu();
+    e.irq_handler = Handler;
+    e.irq_data    = Data;
+}
+
+extern "C" void Xil_ExceptionEnable(void){
+    XEmu_State &e = emu();
+    e.irq_enabled = 1;
+    emu_pump(e);
+}
+
+extern "C" void Xil_ExceptionDisable(void){
+    emu().irq_enabled = 0;
+}
+
+// The PL is advanced synchronously, so after the pump nothing but the
+// private timer can raise an interrupt: sleep until it expires. With no
+// timer armed the core would sleep forever; return instead
+extern "C" void XEmu_Wfi(void){
+    XEmu_State &e = emu();
+    emu_pump(e);
+    if (emu_gic_pending(e) >= 0 || !e.tmr.run || !e.tmr.irq_en) return;
+
+    double ns = e.tmr.expiry_ns - emu_xtime_ns(e);
+    if (ns > 0) {
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(ns / 1e9);
+        ts.tv_nsec = (long)(ns - (double)ts.tv_sec * 1e9);
+        nanosleep(&ts, 0);
+    }
+    emu_pump(e);
+}
+
+// ================================================================
+// xscutimer.h
+// ================================================================
+static XScuTimer_Config emu_tmr_cfg = { XPAR_XSCUTIMER_0_DEVICE_ID, XPAR_XSCUTIMER_0_BASEADDR };
+
+extern "C" XScuTimer_Config *XScuTimer_LookupConfig(u16 DeviceId){
+    return (DeviceId == XPAR_XSCUTIMER_0_DEVICE_ID) ? &emu_tmr_cfg : 0;
+}
+
+extern "C" int XScuTimer_CfgInitialize(XScuTimer *InstancePtr, XScuTimer_Config *ConfigPtr, u32 EffectiveAddress){
+    if (!InstancePtr || !ConfigPtr) return XST_INVALID_PARAM;
+    InstancePtr->Config          = *ConfigPtr;
+    InstancePtr->Config.BaseAddr = EffectiveAddress;
+    InstancePtr->IsReady         = 1;
+    InstancePtr->IsStarted       = 0;
+    memset(&emu().tmr, 0, sizeof(emu().tmr));
+    return XST_SUCCESS;
+}
+
+extern "C" void XScuTimer_LoadTimer(XScuTimer *InstancePtr, u32 Value){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    e.tmr.load      = Value;
+    e.tmr.expiry_ns = emu_xtime_ns(e) + (double)Value * 1e9 / COUNTS_PER_SECOND;
+}
+
+extern "C" void XScuTimer_Start(XScuTimer *InstancePtr){
+    XEmu_State &e = emu();
+    InstancePtr->IsStarted = 1;
+    e.tmr.expiry_ns = emu_xtime_ns(e) + (double)e.tmr.load * 1e9 / COUNTS_PER_SECOND;
+    e.tmr.run = 1;
+}
+
+extern "C" void XScuTimer_Stop(XScuTimer *InstancePtr){
+    InstancePtr->IsStarted = 0;
+    emu().tmr.run = 0;
+}
+
+extern "C" void XScuTimer_EnableAutoReload(XScuTimer *InstancePtr){ (void)InstancePtr; emu().tmr.reload = 1; }
+extern "C" void XScuTimer_DisableAutoReload(XScuTimer *InstancePtr){ (void)InstancePtr; emu().tmr.reload = 0; }
+extern "C" void XScuTimer_EnableInterrupt(XScuTimer *InstancePtr){ (void)InstancePtr; emu().tmr.irq_en = 1; }
+extern "C" void XScuTimer_DisableInterrupt(XScuTimer *InstancePtr){ (void)InstancePtr; emu().tmr.irq_en = 0; }
+
+extern "C" u32 XScuTimer_IsExpired(XScuTimer *InstancePtr){
+    (void)InstancePtr;
+    XEmu_State &e = emu();
+    emu_tmr_poll(e);
+    return (u32)e.tmr.sts;
+}
+
+extern "C" void XScuTimer_ClearInterruptStatus(XScuTimer *InstancePtr){
+    (void)InstancePtr;
+    emu().tmr.sts = 0;
+}
@@ -0,0 +1,62 @@
+// ================================================================
+// xemu.h  (Host_Emu: emulator core <-> HLS kernel binding)
+//  - One xemu_ip_*.cpp binding is linked per host program; it tells
+//    the core how to start the real HLS top function in-process
+//  - s_in/s_out are the same hls::stream<ap_axiu<32,0,0,0>> types
+//    the kernels and their CSIM testbenches already use
+// ================================================================
+#ifndef XEMU_H
+#define XEMU_H
+
+#include <hls_stream.h>
+#include <ap_axi_sdata.h>
+#include "xil_types.h"
+
+typedef ap_axiu<32, 0, 0, 0> xemu_axis_t;
+
+// s_axilite register window (byte offsets 0x00..0xFF)
+#define XEMU_NUM_REGS 64
+
+typedef struct {
+    const char *name;
+
+    // 1: ap_ctrl_hs (AP_CTRL start/done/idle at offset 0x00)
+    // 0: ap_ctrl_none (kernel runs whenever enough input is queued)
+    int ctrl_hs;
+
+    // TLAST placement on s_in:
+    //   >0: every FRAME_WORDS beats (axis_tlast_gen in the block design)
+    //    0: last beat of each MM2S transfer (DMA generated TLAST)
+    int tlast_frame_words;
+
+    // Input words one invocation consumes, given the CTRL registers.
+    // The kernel is only called once this many words are queued.
+    long (*words_needed)(const u32 *regs);
+
+    // Invoke the HLS top function
+    void (*run)(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs);
+
+    // Optional (0 = 1): invocations per AP_START, read at the start.
+    // For kernels that stream several results per start: the core
+    // calls run() once per result as its input arrives, so a host may
+    // wait for result t before sending the input of t+1, and raises
+    // AP_DONE after the last one
+    long (*runs_per_start)(const u32 *regs);
+
+    // Optional: checked after each run(); nonzero ends the start there
+    // (AP_DONE) even if runs_per_start has runs left. For kernels whose
+    // run length is decided in-band (end-of-queue word on s_in)
+    int (*start_done)(const u32 *regs);
+} XEmu_Ip;
+
+// Provided by exactly one xemu_ip_*.cpp
+extern const XEmu_Ip XEmu_Ip_Top;
+
+// For words_needed(): number of queued s_in words and the TDATA of
+// word i (0 = next word the kernel will read)
+long XEmu_InWords(void);
+u32  XEmu_InPeek(long i);
+
+#endif
@@ -0,0 +1,24 @@
+// ================================================================
+// xemu_ip_gemm16_accel.cpp  (Host_Emu binding for Matmul_2)
+//  - ap_ctrl_none: one run per A16(256) + B16(256) = 512 words
+//  - TLAST comes from the DMA at the end of each MM2S transfer
+// ================================================================
+
+#include "xemu.h"
+
+extern "C" void gemm16_accel(hls::stream<xemu_axis_t>& s_in,
+                             hls::stream<xemu_axis_t>& s_out);
+
+static long words_needed(const u32 *regs){
+    (void)regs;
+    return 512;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    (void)regs;
+    gemm16_accel(s_in, s_out);
+}
+
+const XEmu_Ip XEmu_Ip_Top = { "gemm16_accel", 0, 0, words_needed, run, 0, 0 };
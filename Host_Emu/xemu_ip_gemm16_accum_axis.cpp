@@ -0,0 +1,344 @@
+// ================================================================
+// xemu_ip_gemm16_accum_axis.cpp  (Host_Emu binding for Matmul_3/4/8)
+//  - ap_ctrl_hs, Ktiles at CTRL offset 0x10
+//  - One run per Ktiles frames of A16(256) + B16(256) = 512 words
+//  - axis_tlast_gen (FRAME_WORDS=512) sits between MM2S and s_in
+//  - Build with -DXEMU_GEMM16_DB for the Matmul_4 top function:
+//      a_mode at 0x18, Jtiles at 0x20; REUSE runs take B-only frames
+//      (256 words). AMODE_ROW is resolved with the same run counter
+//      the kernel keeps. edge at 0x28: each run starts with a shape
+//      header (peeked) and carries only the valid edge-tile words.
+//      epilogue at 0x30 (EPI_BIAS: cols bias words after the header),
+//      alpha (float bits) at 0x38, fmt at 0x40 (fp16 / bf16: a tile
+//      row of w elements is ceil(w/2) words). Ntiles at 0x48: one
+//      start = Ntiles output tiles, emulated as Ntiles single-tile
+//      calls (runs_per_start), each started once its tile's input is
+//      queued, so hosts may wait for C of tile t before sending t+1.
+//      Same words in and out as one Ntiles run; the C ping-pong itself
+//      is covered by the CSIM testbench. cblock at 0x50: br x bc tile
+//      C blocks, a run is the block's header, bias and per K step br A
+//      + bc B tiles (tiles outside the matrix have no words). jobs at
+//      0x58 = 1: a run is one job (descriptor peeked for its settings,
+//      then bias and tiles); the top is called per job with an
+//      end-of-queue word appended, and the start ends (start_done) at
+//      the queue's own end-of-queue word. last_job (0x60) is updated
+//      per job; with jobs = 0 it stays 0 (single-tile calls). perf
+//      counters (0x70.., 0x10 apart) are copied out after every call;
+//      C-sim never stalls, so the stall counters read 0 (the CSIM
+//      testbench covers the stall paths with injected misses)
+//  - -DXEMU_GEMM16_SA: Matmul_8 top (gemm16_systolic_axis, same
+//    Ktiles protocol as Matmul_3; XEMU_AXIS_W 32 or 128)
+//  - -DXEMU_AXIS_W=64 / 128: the _x64 / _x128 top. The DMA word stream
+//    is cut into the kernel's segments (one MM2S transfer each: header,
+//    bias, A / B tiles), each packed into W-bit beats from a beat
+//    boundary; C beats are unpacked by TKEEP
+// ================================================================
+
+#include <string.h>
+#include <vector>
+
+#include "xemu.h"
+
+#define REG_KTILES 0x10
+
+#ifndef XEMU_AXIS_W
+#define XEMU_AXIS_W 32
+#endif
+#define XEMU_WPB (XEMU_AXIS_W / 32)
+
+typedef ap_axiu<XEMU_AXIS_W, 0, 0, 0> xemu_beat_t;
+
+// n words of one transfer -> ceil(n / WPB) beats, last one TKEEP-trimmed
+static void pack_seg(hls::stream<xemu_axis_t> &s, long n, hls::stream<xemu_beat_t> &b){
+    for (long w = 0; w < n; w += XEMU_WPB) {
+        xemu_beat_t o;
+        o.data = 0;
+        int k = 0;
+        for (; k < XEMU_WPB && w + k < n; k++)
+            o.data.range(32*k + 31, 32*k) = s.read().data.to_uint();
+        o.keep = (ap_uint<XEMU_AXIS_W/8>)((1ull << (4*k)) - 1);
+        o.strb = o.keep;
+        o.user = 0;
+        o.id   = 0;
+        o.dest = 0;
+        o.last = (w + XEMU_WPB >= n) ? 1 : 0;
+        b.write(o);
+    }
+}
+
+// C beats -> words (TKEEP lanes), TLAST on the last word of the last beat
+static void unpack_c(hls::stream<xemu_beat_t> &b, hls::stream<xemu_axis_t> &s){
+    while (!b.empty()) {
+        xemu_beat_t i = b.read();
+        int n = 0;
+        while (n < XEMU_WPB && ((i.keep.to_uint64() >> (4*n)) & 0xF)) n++;
+        for (int k = 0; k < n; k++) {
+            xemu_axis_t o;
+            o.data = i.data.range(32*k + 31, 32*k).to_uint();
+            o.keep = 0xF;
+            o.strb = 0xF;
+            o.user = 0;
+            o.id   = 0;
+            o.dest = 0;
+            o.last = (i.last && k == n-1) ? 1 : 0;
+            s.write(o);
+        }
+    }
+}
+
+// Run a W-bit top on the 32-bit emulator streams, segment by segment,
+// plus one extra beat of TDATA tail (tail_n = 1) when given
+template<typename F>
+static void run_beats(hls::stream<xemu_axis_t> &s_in, hls::stream<xemu_axis_t> &s_out,
+                      const std::vector<long> &segs, F top, int tail_n = 0, u32 tail = 0){
+    hls::stream<xemu_beat_t> b_in, b_out;
+    for (size_t g = 0; g < segs.size(); g++) pack_seg(s_in, segs[g], b_in);
+    if (tail_n) {
+        xemu_beat_t o;
+        o.data = tail;
+        o.keep = 0xF;
+        o.strb = 0xF;
+        o.user = 0;
+        o.id   = 0;
+        o.dest = 0;
+        o.last = 1;
+        b_in.write(o);
+    }
+    top(b_in, b_out);
+    unpack_c(b_out, s_out);
+}
+
+#ifdef XEMU_GEMM16_DB
+#define REG_AMODE  0x18
+#define REG_JTILES 0x20
+#define REG_EDGE   0x28
+#define REG_EPI    0x30
+#define REG_ALPHA  0x38
+#define REG_FMT    0x40
+#define REG_NTILES 0x48
+#define REG_CBLK   0x50
+#define REG_JOBS   0x58
+#define REG_LASTJOB 0x60
+#define REG_PERF    0x70     // 8 counters, 0x10 apart
+#define PERF_NUM    8
+
+#define EPI_BIAS   0x10
+
+#define AMODE_STREAM 0
+#define AMODE_LOAD   1
+#define AMODE_REUSE  2
+#define AMODE_ROW    3
+
+#define KT_MAX 48
+#define CB_MAX 2
+
+#if XEMU_AXIS_W == 128
+#define GEMM16_DB_TOP gemm16_accum_axis_db_x128
+#define XEMU_GEMM16_NAME "gemm16_accum_axis_db_x128"
+#elif XEMU_AXIS_W == 64
+#define GEMM16_DB_TOP gemm16_accum_axis_db_x64
+#define XEMU_GEMM16_NAME "gemm16_accum_axis_db_x64"
+#else
+#define GEMM16_DB_TOP gemm16_accum_axis_db
+#define XEMU_GEMM16_NAME "gemm16_accum_axis_db"
+#endif
+void GEMM16_DB_TOP(hls::stream<xemu_beat_t>& s_in,
+                   hls::stream<xemu_beat_t>& s_out,
+                   int Ktiles, int a_mode, int Jtiles, int edge,
+                   int epilogue, float alpha, int fmt, int Ntiles, int cblock,
+                   int jobs, int *last_job,
+                   uint32_t *perf_recv, uint32_t *perf_in_stall, uint32_t *perf_mac, uint32_t *perf_mac_stall,
+                   uint32_t *perf_send, uint32_t *perf_out_stall, uint32_t *perf_frames, uint32_t *perf_tiles);
+
+static int row_cnt  = 0;
+static int job_stop = 0;     // last run consumed an end-of-queue descriptor
+
+static int run_mode(int a_mode){
+    if (a_mode != AMODE_ROW) return a_mode;
+    return (row_cnt == 0) ? AMODE_LOAD : AMODE_REUSE;
+}
+
+// One block's settings: CTRL registers, or the job descriptor
+struct run_cfg {
+    int ktiles, a_mode, edge, epi, fmt, cblk;
+    int nd;          // descriptor words (0: CTRL protocol)
+    int end;         // end of queue / run that does nothing
+};
+
+static int hdr_dim(u32 v, int max){ return (v == 0 || (int)v > max) ? max : (int)v; }
+
+// C block shape in tiles, clamped like the kernel
+static int cblk_dim(u32 v){ return (v < 1) ? 1 : ((v > CB_MAX) ? CB_MAX : (int)v); }
+
+// valid rows / cols of sub-tile i of an n-wide block
+static int sub_dim(int n, int i){ int d = n - 16*i; return (d < 0) ? 0 : ((d > 16) ? 16 : d); }
+
+// words of an h x w tile: fp32 one per element, fp16 / bf16 two per word
+static long tile_words(int h, int w, int half){ return (long)h * (half ? (w + 1) / 2 : w); }
+
+// Settings of the next run; -1 while the descriptor is not queued yet
+static int run_config(const u32 *regs, run_cfg &c){
+    if (!regs[REG_JOBS/4]) {
+        c.ktiles = (int)regs[REG_KTILES/4];
+        c.a_mode = (int)regs[REG_AMODE/4];
+        c.edge   = (int)regs[REG_EDGE/4];
+        c.epi    = (int)regs[REG_EPI/4];
+        c.fmt    = (int)regs[REG_FMT/4];
+        c.cblk   = (int)regs[REG_CBLK/4];
+        c.nd     = 0;
+    } else {
+        // d0: [7:0] Ktiles, [9:8] a_mode, [10] edge, [12:11] fmt, [20:16] epilogue, [31:24] cblock
+        if (XEmu_InWords() < 1) return -1;
+        u32 d0 = XEmu_InPeek(0);
+        c.ktiles = (int)(d0 & 0xFF);
+        c.a_mode = (int)((d0 >> 8) & 0x3);
+        c.edge   = (int)((d0 >> 10) & 0x1);
+        c.fmt    = (int)((d0 >> 11) & 0x3);
+        c.epi    = (int)((d0 >> 16) & 0x1F);
+        c.cblk   = (int)((d0 >> 24) & 0xFF);
+        c.nd     = c.ktiles ? 2 + c.edge : 1;
+        if (XEmu_InWords() < c.nd) return -1;
+    }
+    c.end = (c.ktiles <= 0) ||
+            (c.a_mode != AMODE_STREAM && c.ktiles * cblk_dim(c.cblk & 0xF) > KT_MAX);
+    return 0;
+}
+
+// Words of each input segment of the next run (descriptor, header,
+// bias, A / B tiles); -1 while the descriptor / edge header is not
+// queued yet
+static int run_segs(const u32 *regs, std::vector<long> &segs){
+    run_cfg c;
+    segs.clear();
+    if (run_config(regs, c) < 0) return -1;
+    if (c.nd) segs.push_back(c.nd);
+    if (c.end) return 0;             // kernel returns at once (job queue: after the descriptor)
+
+    int Ktiles = c.ktiles;
+    int br     = cblk_dim(c.cblk & 0xF);
+    int bc     = cblk_dim((c.cblk >> 4) & 0xF);
+    int recv_a = (run_mode(c.a_mode) != AMODE_REUSE);
+    int rows = 16*br, cols = 16*bc, klast = 16;
+
+    // header: rows | cols << 8 | k_last << 16 (job queue: descriptor word 2)
+    if (c.edge) {
+        if (!c.nd && XEmu_InWords() < 1) return -1;
+        u32 h = XEmu_InPeek(c.nd ? 2 : 0);
+        rows  = hdr_dim(h & 0xFF, 16*br);
+        cols  = hdr_dim((h >> 8) & 0xFF, 16*bc);
+        klast = hdr_dim((h >> 16) & 0xFF, 16);
+        if (!c.nd) segs.push_back(1);
+    }
+    if (c.epi & EPI_BIAS) segs.push_back(cols);
+
+    int half = (c.fmt != 0);
+    for (int k = 0; k < Ktiles; k++) {
+        int kv = (k == Ktiles-1) ? klast : 16;
+        for (int r = 0; r < br && recv_a; r++)
+            if (sub_dim(rows, r)) segs.push_back(tile_words(sub_dim(rows, r), kv, half));
+        for (int c = 0; c < bc; c++)
+            if (sub_dim(cols, c)) segs.push_back(tile_words(kv, sub_dim(cols, c), half));
+    }
+    return 0;
+}
+
+static long words_needed(const u32 *regs){
+    std::vector<long> segs;
+    if (run_segs(regs, segs) < 0) return -1;
+    long words = 0;
+    for (size_t g = 0; g < segs.size(); g++) words += segs[g];
+    return words;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    int Ktiles = (int)regs[REG_KTILES/4];
+    int a_mode = (int)regs[REG_AMODE/4];
+    int Jtiles = (int)regs[REG_JTILES/4];
+    int edge   = (int)regs[REG_EDGE/4];
+    int epi    = (int)regs[REG_EPI/4];
+    int fmt    = (int)regs[REG_FMT/4];
+    int cblk   = (int)regs[REG_CBLK/4];
+    int jobs   = (int)regs[REG_JOBS/4];
+    int last_job = (int)regs[REG_LASTJOB/4];
+    uint32_t perf[PERF_NUM];
+    for (int i = 0; i < PERF_NUM; i++) perf[i] = regs[(REG_PERF + 0x10*i)/4];
+    float alpha;
+    memcpy(&alpha, &regs[REG_ALPHA/4], sizeof(float));
+
+    run_cfg c;
+    run_config(regs, c);
+    std::vector<long> segs;
+    run_segs(regs, segs);
+    // job queue: one job per call, closed by an end-of-queue word unless
+    // the job is the queue's own end
+    run_beats(s_in, s_out, segs, [&](hls::stream<xemu_beat_t> &i, hls::stream<xemu_beat_t> &o){
+        GEMM16_DB_TOP(i, o, Ktiles, a_mode, Jtiles, edge, epi, alpha, fmt, 1, cblk, jobs, &last_job,
+                      &perf[0], &perf[1], &perf[2], &perf[3], &perf[4], &perf[5], &perf[6], &perf[7]);
+    }, jobs && !c.end, 0);
+    if (jobs) regs[REG_LASTJOB/4] = (u32)last_job;
+    for (int i = 0; i < PERF_NUM; i++) regs[(REG_PERF + 0x10*i)/4] = perf[i];
+    job_stop = jobs && c.end;
+
+    if (c.end) return;
+    if (c.a_mode == AMODE_ROW) row_cnt = (row_cnt + 1 >= Jtiles) ? 0 : row_cnt + 1;
+    else                       row_cnt = 0;
+}
+
+static long runs_per_start(const u32 *regs){
+    if (regs[REG_JOBS/4]) return 1L << 30;         // until the end-of-queue word
+    long n = (long)(int)regs[REG_NTILES/4];
+    return (n > 1) ? n : 1;
+}
+
+static int start_done(const u32 *){
+    return job_stop;
+}
+#else
+#if defined(XEMU_GEMM16_SA) && XEMU_AXIS_W == 128
+#define GEMM16_TOP gemm16_systolic_axis_x128
+#define XEMU_GEMM16_NAME "gemm16_systolic_axis_x128"
+#elif defined(XEMU_GEMM16_SA)
+#define GEMM16_TOP gemm16_systolic_axis
+#define XEMU_GEMM16_NAME "gemm16_systolic_axis"
+#elif XEMU_AXIS_W == 128
+#define GEMM16_TOP gemm16_accum_axis_x128
+#define XEMU_GEMM16_NAME "gemm16_accum_axis_x128"
+#elif XEMU_AXIS_W == 64
+#define GEMM16_TOP gemm16_accum_axis_x64
+#define XEMU_GEMM16_NAME "gemm16_accum_axis_x64"
+#else
+#define GEMM16_TOP gemm16_accum_axis
+#define XEMU_GEMM16_NAME "gemm16_accum_axis"
+#endif
+void GEMM16_TOP(hls::stream<xemu_beat_t>& s_in,
+                hls::stream<xemu_beat_t>& s_out,
+                int Ktiles);
+
+static long words_needed(const u32 *regs){
+    int Ktiles = (int)regs[REG_KTILES/4];
+    return (Ktiles > 0) ? (long)Ktiles * 512 : 0;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    int Ktiles = (int)regs[REG_KTILES/4];
+#if XEMU_AXIS_W == 32
+    GEMM16_TOP(s_in, s_out, Ktiles);
+#else
+    // A and B tiles are separate transfers (Matmul_3 host), 256 words each
+    std::vector<long> segs(Ktiles > 0 ? 2*Ktiles : 0, 256);
+    run_beats(s_in, s_out, segs, [&](hls::stream<xemu_beat_t> &i, hls::stream<xemu_beat_t> &o){
+        GEMM16_TOP(i, o, Ktiles);
+    });
+#endif
+}
+#endif
+
+#ifdef XEMU_GEMM16_DB
+const XEmu_Ip XEmu_Ip_Top = { XEMU_GEMM16_NAME, 1, 512, words_needed, run, runs_per_start, start_done };
+#else
+const XEmu_Ip XEmu_Ip_Top = { XEMU_GEMM16_NAME, 1, 512, words_needed, run, 0, 0 };
+#endif
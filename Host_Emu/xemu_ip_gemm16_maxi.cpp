@@ -0,0 +1,49 @@
+// ================================================================
+// xemu_ip_gemm16_maxi.cpp  (Host_Emu binding for Matmul_7)
+//  - ap_ctrl_hs, m_axi addresses A 0x10, B 0x1c, C 0x28 (low / high
+//    word), M 0x34, N 0x3c, K 0x44, lda 0x4c, ldb 0x54, ldc 0x5c
+//  - No AXIS ports: the kernel runs as soon as AP_START is written and
+//    reads / writes the host buffers directly (m_axi on host memory).
+//    Its DDR traffic is not part of the XEMU_STATS DMA counters
+// ================================================================
+
+#include <stdint.h>
+
+#include "xemu.h"
+
+#define REG_A   0x10
+#define REG_B   0x1c
+#define REG_C   0x28
+#define REG_M   0x34
+#define REG_N   0x3c
+#define REG_K   0x44
+#define REG_LDA 0x4c
+#define REG_LDB 0x54
+#define REG_LDC 0x5c
+
+void gemm16_maxi(const float *A, const float *B, float *C,
+                 int M, int N, int K, int lda, int ldb, int ldc);
+
+static void *reg_ptr(const u32 *regs, int off){
+    u64 a = ((u64)regs[off/4 + 1] << 32) | regs[off/4];
+    return (void *)(uintptr_t)a;
+}
+
+static long words_needed(const u32 *regs){
+    (void)regs;
+    return 0;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    (void)s_in;
+    (void)s_out;
+    gemm16_maxi((const float *)reg_ptr(regs, REG_A),
+                (const float *)reg_ptr(regs, REG_B),
+                (float *)reg_ptr(regs, REG_C),
+                (int)regs[REG_M/4], (int)regs[REG_N/4], (int)regs[REG_K/4],
+                (int)regs[REG_LDA/4], (int)regs[REG_LDB/4], (int)regs[REG_LDC/4]);
+}
+
+const XEmu_Ip XEmu_Ip_Top = { "gemm16_maxi", 1, 0, words_needed, run, 0, 0 };
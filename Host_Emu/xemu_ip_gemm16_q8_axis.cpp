@@ -0,0 +1,39 @@
+// ================================================================
+// xemu_ip_gemm16_q8_axis.cpp  (Host_Emu binding for Matmul_6)
+//  - ap_ctrl_hs, Ktiles 0x10, qmode 0x18, scale 0x20, zp_out 0x28
+//  - per run: [16 scale words (Q_CHANNEL)] + Ktiles * 128 words
+//    (A16 + B16, 4 int8 per word)
+//  - TLAST comes from the DMA at the end of each MM2S transfer
+// ================================================================
+
+#include <string.h>
+
+#include "xemu.h"
+
+#define REG_KTILES 0x10
+#define REG_QMODE  0x18
+#define REG_SCALE  0x20
+#define REG_ZP_OUT 0x28
+
+#define Q_CHANNEL 2
+
+void gemm16_q8_axis(hls::stream<xemu_axis_t>& s_in,
+                    hls::stream<xemu_axis_t>& s_out,
+                    int Ktiles, int qmode, float scale, int zp_out);
+
+static long words_needed(const u32 *regs){
+    int Ktiles = (int)regs[REG_KTILES/4];
+    if (Ktiles <= 0) return 0;
+    return (long)Ktiles * 128 + ((int)regs[REG_QMODE/4] == Q_CHANNEL ? 16 : 0);
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    float scale;
+    memcpy(&scale, &regs[REG_SCALE/4], sizeof(float));
+    gemm16_q8_axis(s_in, s_out, (int)regs[REG_KTILES/4], (int)regs[REG_QMODE/4],
+                   scale, (int)regs[REG_ZP_OUT/4]);
+}
+
+const XEmu_Ip XEmu_Ip_Top = { "gemm16_q8_axis", 1, 0, words_needed, run, 0, 0 };
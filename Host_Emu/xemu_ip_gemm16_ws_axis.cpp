@@ -0,0 +1,57 @@
+// ================================================================
+// xemu_ip_gemm16_ws_axis.cpp  (Host_Emu binding for Matmul_5)
+//  - ap_ctrl_hs, cmd 0x10, Ktiles 0x18, Jtiles 0x20, Mtiles 0x28
+//  - CMD_LOAD_W: Jtiles*Ktiles W tiles (256 words each), no output
+//  - CMD_RUN   : Mtiles * Ktiles X tiles, using the Ktiles / Jtiles
+//                latched by the last valid LOAD_W (mirrored here)
+//  - s_in is driven by MM2S directly, TLAST from the DMA (ignored)
+// ================================================================
+
+#include "xemu.h"
+
+#define REG_CMD    0x10
+#define REG_KTILES 0x18
+#define REG_JTILES 0x20
+#define REG_MTILES 0x28
+
+#define CMD_LOAD_W 0
+#define CMD_RUN    1
+
+#define WT_MAX 128
+#define JT_MAX 8
+
+void gemm16_ws_axis(hls::stream<xemu_axis_t>& s_in,
+                    hls::stream<xemu_axis_t>& s_out,
+                    int cmd, int Ktiles, int Jtiles, int Mtiles);
+
+static int w_kt = 0;
+
+static int load_ok(int Ktiles, int Jtiles){
+    return Ktiles > 0 && Jtiles > 0 && Jtiles <= JT_MAX && Ktiles * Jtiles <= WT_MAX;
+}
+
+static long words_needed(const u32 *regs){
+    int cmd    = (int)regs[REG_CMD/4];
+    int Ktiles = (int)regs[REG_KTILES/4];
+    int Jtiles = (int)regs[REG_JTILES/4];
+    int Mtiles = (int)regs[REG_MTILES/4];
+
+    if (cmd == CMD_LOAD_W)
+        return load_ok(Ktiles, Jtiles) ? (long)Ktiles * Jtiles * 256 : 0;
+    if (cmd == CMD_RUN && w_kt > 0 && Mtiles > 0)
+        return (long)Mtiles * w_kt * 256;
+    return 0;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    int cmd    = (int)regs[REG_CMD/4];
+    int Ktiles = (int)regs[REG_KTILES/4];
+    int Jtiles = (int)regs[REG_JTILES/4];
+    gemm16_ws_axis(s_in, s_out, cmd, Ktiles, Jtiles, (int)regs[REG_MTILES/4]);
+
+    if (cmd == CMD_LOAD_W) w_kt = load_ok(Ktiles, Jtiles) ? Ktiles : 0;
+}
+
+const XEmu_Ip XEmu_Ip_Top = { "gemm16_ws_axis", 1, 0, words_needed, run, 0, 0 };
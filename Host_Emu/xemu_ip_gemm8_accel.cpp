@@ -0,0 +1,24 @@
+// ================================================================
+// xemu_ip_gemm8_accel.cpp  (Host_Emu binding for Matmul_1)
+//  - ap_ctrl_none: one run per A8(64) + B8(64) + C8(64) = 192 words
+//  - TLAST comes from the DMA at the end of each MM2S transfer
+// ================================================================
+
+#include "xemu.h"
+
+extern "C" void gemm8_accel(hls::stream<xemu_axis_t>& s_in,
+                            hls::stream<xemu_axis_t>& s_out);
+
+static long words_needed(const u32 *regs){
+    (void)regs;
+    return 192;
+}
+
+static void run(hls::stream<xemu_axis_t> &s_in,
+                hls::stream<xemu_axis_t> &s_out,
+                u32 *regs){
+    (void)regs;
+    gemm8_accel(s_in, s_out);
+}
+
+const XEmu_Ip XEmu_Ip_Top = { "gemm8_accel", 0, 0, words_needed, run, 0, 0 };
@@ -0,0 +1,26 @@
+// ================================================================
+// xil_cache.h  (Host_Emu)
+//  - No cache to maintain on Linux: calls are counted only
+//    (XEMU_STATS=1 prints the totals at exit)
+// ================================================================
+#ifndef XIL_CACHE_H
+#define XIL_CACHE_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Xil_DCacheEnable(void);
+void Xil_DCacheDisable(void);
+void Xil_DCacheFlush(void);
+void Xil_DCacheInvalidate(void);
+void Xil_DCacheFlushRange(INTPTR adr, u32 len);
+void Xil_DCacheInvalidateRange(INTPTR adr, u32 len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,32 @@
+// ================================================================
+// xil_exception.h  (Host_Emu)
+//  - Only the IRQ exception exists. Pending interrupts are delivered
+//    when host code enters the emulator (DMA / register / timer /
+//    wfi calls) while exceptions are enabled, one handler at a time:
+//    a handler is never interrupted, like the A9 IRQ mode
+// ================================================================
+#ifndef XIL_EXCEPTION_H
+#define XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+#define XIL_EXCEPTION_ID_IRQ_INT 5U
+#define XIL_EXCEPTION_ID_INT     XIL_EXCEPTION_ID_IRQ_INT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+typedef void (*Xil_InterruptHandler)(void *data);
+
+void Xil_ExceptionInit(void);
+void Xil_ExceptionRegisterHandler(u32 Exception_id, Xil_ExceptionHandler Handler, void *Data);
+void Xil_ExceptionEnable(void);
+void Xil_ExceptionDisable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+// ================================================================
+// xil_io.h  (Host_Emu)
+//  - Accesses inside the GEMM CTRL window hit the emulated IP
+//    register file, everything else reads as 0 / is dropped
+// ================================================================
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Xil_Out32(UINTPTR Addr, u32 Value);
+u32  Xil_In32(UINTPTR Addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
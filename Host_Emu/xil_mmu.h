@@ -0,0 +1,24 @@
+// ================================================================
+// xil_mmu.h  (Host_Emu)
+//  - No MMU to program on Linux: section attribute changes are
+//    counted only (XEMU_STATS=1)
+// ================================================================
+#ifndef XIL_MMU_H
+#define XIL_MMU_H
+
+#include "xil_types.h"
+
+#define NORM_NONCACHE 0x11DE2    // normal memory, non-cacheable (A9 section attributes)
+#define NORM_WB_CACHE 0x15DE6    // normal memory, write-back cacheable
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Xil_SetTlbAttributes(UINTPTR Addr, u32 attrib);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,57 @@
+// ================================================================
+// xparameters.h  (Host_Emu)
+//  - Same XPAR_* names as the Zybo Z7-20 block designs of Matmul_1..8
+//  - Addresses only need to be unique: Xil_Out32/In32 decode them
+//    inside the emulator, nothing is memory-mapped
+// ================================================================
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+// Set when the host code is built against Host_Emu instead of the BSP
+#define XEMU_BUILD 1
+
+// PS7 Cortex-A9 (Zybo Z7-20 default)
+#define XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ 666666687
+
+// AXI DMA
+#define XPAR_XAXIDMA_NUM_INSTANCES 1
+#define XPAR_AXIDMA_0_DEVICE_ID    0
+#define XPAR_AXI_DMA_0_DEVICE_ID   0
+#define XPAR_AXI_DMA_0_BASEADDR    0x40400000
+#define XPAR_AXI_DMA_0_HIGHADDR    0x4040FFFF
+#define XPAR_AXI_DMA_0_INCLUDE_SG  0      // XEMU_DMA_SG=1 overrides at run time
+
+// AXI DMA interrupt outputs -> IRQ_F2P[0..1]
+#define XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID 61U
+#define XPAR_FABRIC_AXIDMA_0_S2MM_INTROUT_VEC_ID 62U
+
+// PS7 GIC
+#define XPAR_SCUGIC_SINGLE_DEVICE_ID 0
+#define XPAR_SCUGIC_0_DEVICE_ID      0
+#define XPAR_SCUGIC_0_CPU_BASEADDR   0xF8F00100
+#define XPAR_SCUGIC_0_DIST_BASEADDR  0xF8F01000
+
+// A9 private timer (xparameters_ps.h: XPS_SCU_TMR_INT_ID)
+#define XPAR_XSCUTIMER_0_DEVICE_ID   0
+#define XPAR_XSCUTIMER_0_BASEADDR    0xF8F00600
+#define XPAR_SCUTIMER_INTR           29U
+
+// HLS GEMM IP, s_axilite bundle=CTRL (Matmul_3/4)
+#define XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR 0x43C00000
+#define XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR 0x43C0FFFF
+
+// Matmul_5 (gemm16_ws_axis), Matmul_6 (gemm16_q8_axis): same CTRL window, one IP per program
+#define XPAR_GEMM16_WS_AXIS_0_S_AXI_CTRL_BASEADDR    XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#define XPAR_GEMM16_WS_AXIS_0_S_AXI_CTRL_HIGHADDR    XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR
+#define XPAR_GEMM16_Q8_AXIS_0_S_AXI_CTRL_BASEADDR    XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#define XPAR_GEMM16_Q8_AXIS_0_S_AXI_CTRL_HIGHADDR    XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR
+
+// Matmul_7 (gemm16_maxi): m_axi IP, no DMA in the design
+#define XPAR_GEMM16_MAXI_0_S_AXI_CTRL_BASEADDR       XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#define XPAR_GEMM16_MAXI_0_S_AXI_CTRL_HIGHADDR       XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR
+
+// Matmul_8 (gemm16_systolic_axis): Matmul_3 protocol, host = Matmul_3/host.c
+#define XPAR_GEMM16_SYSTOLIC_AXIS_0_S_AXI_CTRL_BASEADDR XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#define XPAR_GEMM16_SYSTOLIC_AXIS_0_S_AXI_CTRL_HIGHADDR XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_HIGHADDR
+
+#endif
@@ -0,0 +1,21 @@
+// ================================================================
+// xpseudo_asm.h  (Host_Emu)
+//  - wfi(): advance the emulated PL and take pending interrupts,
+//    instead of sleeping the core
+// ================================================================
+#ifndef XPSEUDO_ASM_H
+#define XPSEUDO_ASM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void XEmu_Wfi(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define wfi() XEmu_Wfi()
+
+#endif
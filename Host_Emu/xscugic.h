@@ -0,0 +1,44 @@
+// ================================================================
+// xscugic.h  (Host_Emu)
+//  - PS7 GIC: per-ID enable + handler table. An ID is pending while
+//    its source (AXI DMA MM2S / S2MM interrupt) is asserted
+//  - Priority / trigger type are accepted and ignored
+// ================================================================
+#ifndef XSCUGIC_H
+#define XSCUGIC_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_exception.h"
+
+#define XSCUGIC_MAX_NUM_INTR_INPUTS 95U
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    u16     DeviceId;
+    UINTPTR CpuBaseAddress;
+    UINTPTR DistBaseAddress;
+} XScuGic_Config;
+
+typedef struct {
+    XScuGic_Config *Config;
+    u32             IsReady;
+} XScuGic;
+
+XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId);
+int  XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr, u32 EffectiveAddr);
+int  XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id, Xil_InterruptHandler Handler, void *CallBackRef);
+void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_SetPriorityTriggerType(XScuGic *InstancePtr, u32 Int_Id, u8 Priority, u8 Trigger);
+void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+// ================================================================
+// xscutimer.h  (Host_Emu)
+//  - A9 private timer: 32-bit down counter at CPU/2 (same rate as
+//    XTime), one-shot or auto-reload, interrupt XPAR_SCUTIMER_INTR
+//  - Emulated on the XTime clock: the interrupt is pending once the
+//    loaded count has elapsed after XScuTimer_Start; wfi() with
+//    nothing else pending sleeps until then
+//  - The BSP's macros (LoadTimer, EnableInterrupt, ...) are functions
+// ================================================================
+#ifndef XSCUTIMER_H
+#define XSCUTIMER_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    u16     DeviceId;
+    UINTPTR BaseAddr;
+} XScuTimer_Config;
+
+typedef struct {
+    XScuTimer_Config Config;
+    u32              IsReady;
+    u32              IsStarted;
+} XScuTimer;
+
+XScuTimer_Config *XScuTimer_LookupConfig(u16 DeviceId);
+int  XScuTimer_CfgInitialize(XScuTimer *InstancePtr, XScuTimer_Config *ConfigPtr, u32 EffectiveAddress);
+void XScuTimer_Start(XScuTimer *InstancePtr);
+void XScuTimer_Stop(XScuTimer *InstancePtr);
+
+void XScuTimer_LoadTimer(XScuTimer *InstancePtr, u32 Value);
+void XScuTimer_EnableAutoReload(XScuTimer *InstancePtr);
+void XScuTimer_DisableAutoReload(XScuTimer *InstancePtr);
+void XScuTimer_EnableInterrupt(XScuTimer *InstancePtr);
+void XScuTimer_DisableInterrupt(XScuTimer *InstancePtr);
+u32  XScuTimer_IsExpired(XScuTimer *InstancePtr);
+void XScuTimer_ClearInterruptStatus(XScuTimer *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
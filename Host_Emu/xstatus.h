@@ -0,0 +1,14 @@
+// ================================================================
+// xstatus.h  (Host_Emu)
+// ================================================================
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#define XST_SUCCESS           0L
+#define XST_FAILURE           1L
+#define XST_DEVICE_NOT_FOUND  2L
+#define XST_INVALID_PARAM     15L
+#define XST_DMA_ERROR         28L
+#define XST_DMA_SG_LIST_ERROR 521L
+
+#endif
@@ -0,0 +1,29 @@
+// ================================================================
+// xtime_l.h  (Host_Emu)
+//  - XTime ticks at CPU/2 like the A9 global timer, so the
+//    cycles_to_us() helpers in host.c stay unchanged
+//  - XEMU_HIDE_PL=1 subtracts the time spent inside the C-simulated
+//    kernel, leaving host-side (packing/protocol) time only
+// ================================================================
+#ifndef XTIME_L_H
+#define XTIME_L_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+typedef u64 XTime;
+
+#define COUNTS_PER_SECOND (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void XTime_GetTime(XTime *Xtime_Global);
+void XTime_SetTime(XTime Xtime_Global);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,12 +13,14 @@
 #include "xil_cache.h"
 #include "xtime_l.h"
 
+#include "sgemm_cpu.h"
+#include "gemm_buf.h"
+
 //==================== CONFIG ====================
 #define N16 16
 #define TS  8
 #define DMA_DEV_ID XPAR_AXIDMA_0_DEVICE_ID
 
-#define CACHELINE 32
 #define DMA_TIMEOUT 100000000
 #define EPS 1e-6f
 
@@ -30,18 +32,9 @@ static inline int idx(int r,int c){ return r*N16+c; }
 static inline int idx8(int r,int c){ return r*TS+c; }
 
 //==================== CACHE ====================
-static void cache_flush(void* p, int sz){
-    UINTPTR a=(UINTPTR)p;
-    a&=~(CACHELINE-1);
-    sz=(sz+CACHELINE-1)&~(CACHELINE-1);
-    Xil_DCacheFlushRange(a,sz);
-}
-static void cache_inv(void* p,int sz){
-    UINTPTR a=(UINTPTR)p;
-    a&=~(CACHELINE-1);
-    sz=(sz+CACHELINE-1)&~(CACHELINE-1);
-    Xil_DCacheInvalidateRange(a,sz);
-}
+// line 정렬은 gemm_buf가 처리 (clean은 line 단위로 확장, invalidate는 정확한 범위)
+static void cache_flush(void* p, int sz){ gemm_buf_to_dev(p, sz); }
+static void cache_inv(void* p, int sz){ gemm_buf_from_dev(p, sz); }
 
 //==================== TIMER ====================
 // Zynq-7000: XTime tick = CPU/2  → 반드시 ×2
@@ -52,13 +45,7 @@ static double cycles_to_us(XTime cyc){
 
 //==================== SW GEMM ====================
 static void gemm_sw(const float*A,const float*B,float*C){
-    for(int i=0;i<N16;i++)
-        for(int j=0;j<N16;j++){
-            float s=0;
-            for(int k=0;k<N16;k++)
-                s+=A[idx(i,k)]*B[idx(k,j)];
-            C[idx(i,j)]=s;
-        }
+    sgemm_cpu(N16,N16,N16, A,N16, B,N16, C,N16);   // sgemm_set_impl()로 naive / SIMD 선택
 }
 
 //==================== TILE ====================
@@ -144,6 +131,15 @@ int main(){
 
     //---------------- SW ----------------
     XTime t0,t1;
+    sgemm_set_impl(SGEMM_NAIVE);
+    XTime_GetTime(&t0);
+    gemm_sw(A,B,Csw);
+    XTime_GetTime(&t1);
+
+    double sw_naive_us=cycles_to_us(t1-t0);
+
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(1);     // 16x16: thread 생성 비용이 더 큼
     XTime_GetTime(&t0);
     gemm_sw(A,B,Csw);
     XTime_GetTime(&t1);
@@ -182,9 +178,9 @@ int main(){
     double flops=2.0*N16*N16*N16;
 
     printf("\nPerformance\n");
-    printf("SW  time  : %.3f us\n",sw_us);
+    printf("SW  time  : %.3f us (naive %.3f us, %s)\n",sw_us,sw_naive_us,sgemm_impl_name(SGEMM_SIMD));
     printf("HW  time  : %.3f us\n",hw_us);
-    printf("Speedup   : %.3f x\n",sw_us/hw_us);
+    printf("Speedup   : %.3f x (vs naive %.3f x)\n",sw_us/hw_us,sw_naive_us/hw_us);
 
     printf("SW GFLOPS : %.6f\n", flops/(sw_us*1e-6)/1e9);
     printf("HW GFLOPS : %.6f\n", flops/(hw_us*1e-6)/1e9);
@@ -13,12 +13,22 @@ const int Ktiles_tb = 3;
 
 typedef ap_axiu<32,0,0,0> axis_t;
 
-// DUT prototype
+// DUT prototypes (32 / 64 / 128-bit stream)
 void gemm16_accum_axis(
     hls::stream<axis_t>& s_in,
     hls::stream<axis_t>& s_out,
     int Ktiles
 );
+void gemm16_accum_axis_x64(
+    hls::stream<ap_axiu<64,0,0,0> >& s_in,
+    hls::stream<ap_axiu<64,0,0,0> >& s_out,
+    int Ktiles
+);
+void gemm16_accum_axis_x128(
+    hls::stream<ap_axiu<128,0,0,0> >& s_in,
+    hls::stream<ap_axiu<128,0,0,0> >& s_out,
+    int Ktiles
+);
 
 // =====================================================
 // bit cast helpers (CSIM-safe)
@@ -50,6 +60,58 @@ void gemm16_sw(float A[N][N], float B[N][N], float C[N][N])
         }
 }
 
+// =====================================================
+// 64 / 128-bit stream: same frames, W/32 floats per beat
+// =====================================================
+static void dut(hls::stream<ap_axiu<64,0,0,0> >& i, hls::stream<ap_axiu<64,0,0,0> >& o, int kt)
+{ gemm16_accum_axis_x64(i, o, kt); }
+static void dut(hls::stream<ap_axiu<128,0,0,0> >& i, hls::stream<ap_axiu<128,0,0,0> >& o, int kt)
+{ gemm16_accum_axis_x128(i, o, kt); }
+
+template<int W>
+static bool test_wide(float A[][N][N], float B[][N][N], float Cref[N][N])
+{
+    const int WPB = W / 32;
+    hls::stream<ap_axiu<W,0,0,0> > s_in, s_out;
+
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int m=0; m<2; m++)
+            for(int e=0; e<N*N; e+=WPB){
+                ap_axiu<W,0,0,0> w;
+                for(int l=0; l<WPB; l++){
+                    int i = (e+l) / N, j = (e+l) % N;
+                    w.data.range(32*l+31, 32*l) = f2u(m ? B[kt][i][j] : A[kt][i][j]);
+                }
+                w.keep = -1;
+                w.strb = -1;
+                w.user = 0;
+                w.id   = 0;
+                w.dest = 0;
+                w.last = (m == 1 && e == N*N-WPB) ? 1 : 0;
+                s_in.write(w);
+            }
+    int beats_in = s_in.size();
+
+    dut(s_in, s_out, Ktiles_tb);
+
+    int beats_out = s_out.size();
+    bool ok = s_in.empty() && beats_out == N*N/WPB;
+    float max_err = 0;
+    for(int b=0; ok && b<beats_out; b++){
+        ap_axiu<W,0,0,0> w = s_out.read();
+        if((int)w.last != (b == beats_out-1 ? 1 : 0)) ok = false;
+        for(int l=0; l<WPB; l++){
+            int i = (b*WPB+l) / N, j = (b*WPB+l) % N;
+            float e = fabs(Cref[i][j] - u2f(w.data.range(32*l+31, 32*l)));
+            if(e > max_err) max_err = e;
+        }
+    }
+
+    std::cout << W << "-bit stream: " << beats_in << " input beats, "
+              << beats_out << " output beats, max error = " << max_err << std::endl;
+    return ok && beats_in == Ktiles_tb*512/WPB && max_err < EPS;
+}
+
 // =====================================================
 // Main Testbench
 // =====================================================
@@ -174,10 +236,15 @@ int main()
 
     std::cout << "Max error = " << max_err << std::endl;
 
+    // -------------------------------------------------
+    // 64 / 128-bit AXIS variants
+    // -------------------------------------------------
+    bool wide_ok = test_wide<64>(A, B, Cref) && test_wide<128>(A, B, Cref);
+
     // -------------------------------------------------
     // Result
     // -------------------------------------------------
-    if(max_err < EPS && last_seen && words_out==256)
+    if(max_err < EPS && last_seen && words_out==256 && wide_ok)
         std::cout << "\nPASS ✅\n";
     else
         std::cout << "\nFAIL ❌\n";
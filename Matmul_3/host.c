@@ -1,9 +1,23 @@
 /********************************************************************
  * SAFE Generic GEMM Host (Correct protocol for Ktiles-accum IP)
  *  - N = 16*k
+ *  - A, B packed ONCE into tile-major panels (gemm_pack)
  *  - Tile (bi,bj):
- *      S2MM (256 floats) ONCE
- *      MM2S (512 floats) Ktiles times
+ *      S2MM (256 floats) ONCE, straight into packed C
+ *      MM2S (A tile 256 + B tile 256 floats) Ktiles times,
+ *           straight out of packed A / B (no per-frame copy)
+ *  - DMA mode (XAxiDma_HasSg at runtime, DMA IRQ lines at build time):
+ *      simple : SimpleTransfer + busy-wait per tile transfer
+ *      async  : SimpleTransfer chained from the DMA completion IRQ
+ *               (gemm_dma_async); A/C row panels ping-pong so the CPU
+ *               packs / unpacks while the previous row is on the wire
+ *      SG     : all frames of all output tiles as BD chains
+ *               (gemm_dma_sg), IP in auto-restart -> continuous stream
+ *      SG + DMA_2D : one BD per tile row, gathered from row-major A / B
+ *               (leading dimension N) and scattered into row-major C
+ *               -> no packing / unpacking copy at all
+ *  - Cache maintenance (gemm_buf): packed A / B flushed and packed C
+ *    invalidated once per GEMM in every mode, none per transfer
  ********************************************************************/
 
 #include <stdio.h>
@@ -17,66 +31,133 @@
 #include "xtime_l.h"
 #include "xil_io.h"
 
-#define N 32              // 16의 배수
+#include "sgemm_cpu.h"
+#include "gemm_pack.h"
+#include "gemm_dma_sg.h"
+#include "gemm_dma_async.h"
+#include "gemm_buf.h"
+
+#ifndef N
+#define N 32              // 16의 배수 (에뮬레이션 빌드에서는 -DN=... 로 지정)
+#endif
 #define TILE 16           // 가속기 자체는 16*16 행렬 곱셈 & 누적
 #define NB (N/TILE)       // Tile의 수
 #define KTILES NB         // Tile의 수 (한 차원 측면에서)
 
 #define MAXN 256*3        // 최대 행렬의 크기
 #define DMA_DEV_ID XPAR_AXIDMA_0_DEVICE_ID
-#define GEMM_CTRL_BASE XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
+#ifndef GEMM_CTRL_BASE
+#define GEMM_CTRL_BASE XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR   // Matmul_8: -DGEMM_CTRL_BASE=XPAR_GEMM16_SYSTOLIC_AXIS_0_S_AXI_CTRL_BASEADDR
+#endif
 
 #define REG_AP_CTRL  0x00
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define AP_AUTO_RESTART 0x80
 #define REG_KTILES   0x10    // Tile의 수를 가속기에 제공하여 가속기 내부에서 KTILES번 곱셈누적하도록 함.
 
+#define SW_THREADS 0       // CPU SGEMM thread 수 (0: 전체 core, standalone은 1)
+#define SW_REPS 3          // SW(simd) 측정 횟수 (warm-up 1회 뒤 최소값)
+
+// CPU / PL routing (opt-in fallback build): HW 실행 전에 예측 시간 비교 → CPU가 빠르면 sgemm_cpu로 계산 (PL 미사용)
+//  CPU rate는 직전 sgemm_cpu 측정값, PL은 보드 측정값 (README: N=512 rate, N=32 시간 - flops / rate)
+#ifndef ROUTE
+#define ROUTE 0                    // -DROUTE=1: CPU fallback build (기본은 항상 PL)
+#endif
+#ifndef ROUTE_ACCEL_GFLOPS
+#define ROUTE_ACCEL_GFLOPS   0.136 // PL steady-state rate
+#endif
+#ifndef ROUTE_ACCEL_FIXED_US
+#define ROUTE_ACCEL_FIXED_US 250.0 // 호출당 고정 비용 (AXI-Lite, DMA 설정, cache)
+#endif
+
+// block design에 DMA interrupt (IRQ_F2P)가 연결되어 있으면 async mode
+// (-DDMA_USE_IRQ=0: 기존 polling simple mode 강제)
+#ifndef DMA_USE_IRQ
+#ifdef XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID
+#define DMA_USE_IRQ 1
+#else
+#define DMA_USE_IRQ 0
+#endif
+#endif
+
+enum { DMA_SIMPLE, DMA_ASYNC, DMA_SG };
+static const char *dma_mode_name[] = { "simple", "async (IRQ)", "SG" };
+
+#define SG_TX_BDS 256      // MM2S BD ring (16 KB): 128 frame, half ring씩 refill (DMA_2D: 8 frame)
+#define SG_RX_BDS 64       // S2MM BD ring: output tile 64개 (DMA_2D: 4개)
+
+// SG mode에서 tile을 row-major 원본에서 직접 전송 (tile row마다 BD 1개, 64 B)
+//  → gemm_pack_tiles / gemm_unpack_tiles 없음, 대신 BD 수 16배
+#ifndef DMA_2D
+#define DMA_2D 0
+#endif
+#define SG_TILE_BDS (DMA_2D ? TILE : 1)     // tile 1개의 BD 수
+
 #define DMA_TIMEOUT 100000000
 #define EPS 1e-6f
 
 static XAxiDma AxiDma;
 
+static XAxiDma_Bd TxBds[SG_TX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+static XAxiDma_Bd RxBds[SG_RX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+
 static inline int idx(int r,int c){ return r*N+c; }         // 입력 행렬의 주소 index 반환
-static inline int idx16(int r,int c){ return r*TILE+c; }    // tile 행렬의 주소 index 반환
 
 static inline double cycles_to_us(XTime c){
     return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
 }
 
-static void flush(void* p,int sz){ Xil_DCacheFlushRange((UINTPTR)p,sz); }    // Cache Flush for READs
-static void inval(void* p,int sz){ Xil_DCacheInvalidateRange((UINTPTR)p,sz); }    // Cache Invalidate for WRITEs
+// cache 관리는 buffer 전체 단위로 GEMM마다 1회 (gemm_buf) → 전송 loop 안에는 cache 작업 없음
+static void flush(void* p,int sz){ gemm_buf_to_dev(p,sz); }      // Cache Flush for READs
+static void inval(void* p,int sz){ gemm_buf_from_dev(p,sz); }    // Cache Invalidate for WRITEs
 
 // ---------------- SW GEMM ----------------
+// sgemm_set_impl()로 naive / blocked / SIMD 선택
 void gemm_sw(float*A,float*B,float*C){
-    for(int i=0;i<N;i++)
-        for(int j=0;j<N;j++){
-            float s=0;
-            for(int k=0;k<N;k++)
-                s+=A[idx(i,k)]*B[idx(k,j)];
-            C[idx(i,j)]=s;
-        }
+    sgemm_cpu(N,N,N, A,N, B,N, C,N);
 }
 
-// ---------------- Tile helpers ----------------
-void extract_block(float*src,int br,int bc,float*dst){
-    int r0=br*TILE, c0=bc*TILE;
-    for(int i=0;i<TILE;i++)
-        for(int j=0;j<TILE;j++)
-            dst[idx16(i,j)] = src[idx(r0+i,c0+j)];
+// 결과 검증 (SW 기준)
+static float max_abs_err(const float *Chw, const float *Csw){
+    float max_err=0;
+    for(int i=0;i<N*N;i++){
+        float e=fabsf(Chw[i]-Csw[i]);
+        if(e>max_err) max_err=e;
+    }
+    return max_err;
 }
 
-void store_block(float*dst,int br,int bc,float*src){
-    int r0=br*TILE, c0=bc*TILE;
-    for(int i=0;i<TILE;i++)
-        for(int j=0;j<TILE;j++)
-            dst[idx(r0+i,c0+j)] = src[idx16(i,j)];
+// ---------------- Packed tile access ----------------
+// A: row panel 순서 (A(bi,0..NB-1) 연속), B: column panel 순서 (B(0..NB-1,bj) 연속)
+static inline float* tileA(float*Ap,int br,int bc){ return gemm_tile_ptr(Ap,N,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+static inline float* tileB(float*Bp,int br,int bc){ return gemm_tile_ptr(Bp,N,N,TILE,GEMM_TILES_COL_MAJOR,br,bc); }
+static inline float* tileC(float*Cp,int br,int bc){ return gemm_tile_ptr(Cp,N,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+
+// SG mode의 tile: packed buffer의 tile 1개 = BD 1개,
+// DMA_2D는 row-major 행렬 (leading dimension N) 안의 16 x 16 block = tile row마다 BD 1개
+static inline float* sg_tileA(float*A,int br,int bc){ return DMA_2D ? A + idx(br*TILE, bc*TILE) : tileA(A,br,bc); }
+static inline float* sg_tileB(float*B,int br,int bc){ return DMA_2D ? B + idx(br*TILE, bc*TILE) : tileB(B,br,bc); }
+static inline float* sg_tileC(float*C,int br,int bc){ return DMA_2D ? C + idx(br*TILE, bc*TILE) : tileC(C,br,bc); }
+
+static int sg_tile_segs(gemm_sg_seg_t *seg, float *tile, u32 first_ctrl, u32 last_ctrl){
+    if (!DMA_2D) {
+        seg->addr = (UINTPTR)tile;
+        seg->len  = 256*sizeof(float);
+        seg->ctrl = first_ctrl | last_ctrl;
+        return 1;
+    }
+    return gemm_sg_block_segs(seg, (UINTPTR)tile, TILE*sizeof(float), TILE, N*sizeof(float),
+                              first_ctrl, last_ctrl);
 }
 
 // ---------------- DMA helpers ----------------
-// MM2S: send 512 floats (2KB)
-static int dma_send_frame(float *in512){
-    const int in_bytes = 512*sizeof(float);        // 16*16 행렬 2개: 16*16*2 = 512
-    flush(in512, in_bytes);
+// MM2S: 256 floats (1KB) 1회 (packed A / B는 GEMM 시작 전에 전체 flush 완료)
+static int dma_send_tile(float *in256){
+    const int in_bytes = 256*sizeof(float);
 
-    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)in512, in_bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)in256, in_bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
         return -1;
 
     int t=DMA_TIMEOUT;
@@ -84,10 +165,15 @@ static int dma_send_frame(float *in512){
     return (t<=0) ? -1 : 0;
 }
 
-// S2MM: receive 256 floats (1KB) - tile당 1번만!
+// MM2S: 1 frame = A tile(256) + B tile(256) = 512 floats, packed buffer에서 바로 전송
+static int dma_send_frame(float *a256, float *b256){
+    if (dma_send_tile(a256)!=0) return -1;
+    return dma_send_tile(b256);
+}
+
+// S2MM: receive 256 floats (1KB) - tile당 1번만! (packed C는 GEMM 전후로 전체 invalidate)
 static int dma_recv_tile(float *out256){
     const int out_bytes = 256*sizeof(float);        // 출력 행렬 1개: 16*16 = 256
-    inval(out256, out_bytes);
 
     if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)out256, out_bytes, XAXIDMA_DEVICE_TO_DMA) != XST_SUCCESS)
         return -1;
@@ -101,21 +187,252 @@ static int dma_wait_recv_done(void){
     return (t<=0) ? -1 : 0;
 }
 
+// ---------------- HW GEMM: simple mode ----------------
+// tile마다 S2MM 1회 + IP start + MM2S 2*Ktiles회 (전송마다 busy-wait)
+static int gemm_hw_simple(float *Ap, float *Bp, float *Cp){
+    // packed 행렬 전체를 1회만 flush / invalidate (SG mode와 같음)
+    flush(Ap, N*N*sizeof(float));
+    flush(Bp, N*N*sizeof(float));
+    inval(Cp, N*N*sizeof(float));
+
+    for(int bi=0; bi<NB; bi++){                // NB: 한 축으로의 tile의 수
+        for(int bj=0; bj<NB; bj++){            // NB: 한 축으로의 tile의 수
+
+            // (1) 타일 출력 S2MM을 먼저 1회만 걸어둔다
+            float *out_tile = tileC(Cp, bi, bj);
+            if(dma_recv_tile(out_tile)!=0){
+                printf("S2MM submit fail\n");
+                return -1;
+            }
+
+            // (2) IP start
+            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START);
+
+            // (3) Ktiles 프레임을 MM2S로 연속 전송 (각 512 floats, 복사 없음)
+            for(int bk=0; bk<NB; bk++){
+                if(dma_send_frame(tileA(Ap, bi, bk), tileB(Bp, bk, bj))!=0){
+                    printf("MM2S frame send fail\n");
+                    return -1;
+                }
+            }
+
+            // (4) S2MM 완료 대기 (여기서 packed C의 tile이 채워짐)
+            if(dma_wait_recv_done()!=0){
+                printf("S2MM wait timeout\n");
+                return -1;
+            }
+
+            // (5) IP done도 확인(안전)
+            while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_DONE));
+        }
+    }
+
+    inval(Cp, N*N*sizeof(float));     // S2MM 중 prefetch된 line 제거
+    return 0;
+}
+
+// ---------------- HW GEMM: scatter-gather mode ----------------
+// 전체 GEMM의 frame을 BD chain으로 연속 제출, CPU는 ring refill 때만 개입
+//  - IP는 auto-restart: tile이 끝나면 바로 다음 tile 시작 (tile당 AP start 없음)
+//  - 마지막 tile은 직전 tile까지 끝난 뒤 auto-restart를 해제하고 나서 전송
+//    → IP가 마지막 tile 후 재시작되어 입력을 기다리는 상태로 남지 않음
+//  - Ap / Bp / Cp: packed buffer, DMA_2D면 row-major A / B / C 그대로
+static int gemm_hw_sg(float *Ap, float *Bp, float *Cp){
+    static gemm_sg_seg_t seg[2*KTILES*SG_TILE_BDS];
+    gemm_sg_seg_t out[SG_TILE_BDS];
+    XAxiDma_BdRing *tx = XAxiDma_GetTxRing(&AxiDma);
+    XAxiDma_BdRing *rx = XAxiDma_GetRxRing(&AxiDma);
+    const int ntiles = NB*NB;
+
+    // 행렬 전체를 1회만 flush / invalidate (BD는 cache 작업 없음)
+    flush(Ap, N*N*sizeof(float));
+    flush(Bp, N*N*sizeof(float));
+    inval(Cp, N*N*sizeof(float));
+
+    Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, (ntiles > 1) ? (AP_AUTO_RESTART|AP_START) : AP_START);
+
+    for(int t=0; t<ntiles; t++){
+        int bi = t / NB, bj = t % NB;
+
+        if (t == ntiles-1 && ntiles > 1) {
+            // 마지막 tile: 앞의 tile 출력이 모두 끝남 = IP가 마지막 run으로 재시작됨
+            if (gemm_sg_wait(rx, DMA_TIMEOUT)!=0){
+                printf("S2MM SG wait fail\n");
+                return -1;
+            }
+            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 0);    // auto-restart 해제
+        }
+
+        // (1) 출력 tile S2MM BD (DMA_2D: C row 16개로 scatter, TLAST까지 BD 순서대로 채움)
+        int nout = sg_tile_segs(out, sg_tileC(Cp, bi, bj), 0, 0);
+        if (gemm_sg_submit(rx, out, nout, DMA_TIMEOUT)!=0){
+            printf("S2MM SG submit fail\n");
+            return -1;
+        }
+
+        // (2) Ktiles frame = A tile BD(s)(SOF) + B tile BD(s)(EOF)
+        int nseg = 0;
+        for(int bk=0; bk<NB; bk++){
+            nseg += sg_tile_segs(&seg[nseg], sg_tileA(Ap, bi, bk), XAXIDMA_BD_CTRL_TXSOF_MASK, 0);
+            nseg += sg_tile_segs(&seg[nseg], sg_tileB(Bp, bk, bj), 0, XAXIDMA_BD_CTRL_TXEOF_MASK);
+        }
+        if (gemm_sg_submit(tx, seg, nseg, DMA_TIMEOUT)!=0){
+            printf("MM2S SG submit fail\n");
+            return -1;
+        }
+    }
+
+    // (3) 모든 BD 완료 대기 + IP idle 확인
+    if (gemm_sg_wait(tx, DMA_TIMEOUT)!=0 || gemm_sg_wait(rx, DMA_TIMEOUT)!=0){
+        printf("SG wait timeout\n");
+        return -1;
+    }
+    while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_IDLE));
+
+    inval(Cp, N*N*sizeof(float));
+    return 0;
+}
+
+#if DMA_USE_IRQ
+// ---------------- HW GEMM: interrupt-driven async mode ----------------
+// DMA 완료 interrupt에서 다음 전송을 바로 시작 (gemm_dma_async) → busy-wait 없음
+//  - IP는 SG mode와 같이 auto-restart, 마지막 tile 직전에 해제
+//  - A row panel / C row panel을 ping-pong 2개로 운용:
+//    row bi가 전송되는 동안 CPU는 A panel bi+1 packing, C panel bi-1 unpack
+static XScuGic Intc;
+
+static float Apan[2][TILE*MAXN] __attribute__((aligned(64)));
+static float Cpan[2][TILE*MAXN] __attribute__((aligned(64)));
+static volatile int apan_free[2];     // panel의 마지막 MM2S 완료 (callback에서 set)
+static volatile int cpan_full[2];     // panel의 마지막 S2MM 완료 (callback에서 set)
+
+static void apan_done(void *ctx){ apan_free[(INTPTR)ctx] = 1; }
+static void cpan_done(void *ctx){ cpan_full[(INTPTR)ctx] = 1; }
+
+// row panel 안의 tile (16 x N panel, tile은 column 순서로 연속)
+static inline float* panel_tile(float *pan, int bc){
+    return gemm_tile_ptr(pan, TILE, N, TILE, GEMM_TILES_ROW_MAJOR, 0, bc);
+}
+
+static int gemm_hw_async(float *A, float *B, float *Bp, float *C){
+    const int ntiles    = NB*NB;
+    const int pan_bytes = TILE*N*sizeof(float);
+    const int tile_bytes = 256*sizeof(float);
+
+    // (0) B 전체 + A panel 0 packing
+    gemm_pack_tiles(B, N, N, N, TILE, GEMM_TILES_COL_MAJOR, Bp);
+    flush(Bp, N*N*sizeof(float));
+    gemm_pack_tiles(A, TILE, N, N, TILE, GEMM_TILES_ROW_MAJOR, Apan[0]);
+    flush(Apan[0], pan_bytes);
+    apan_free[0] = apan_free[1] = 1;
+    cpan_full[0] = cpan_full[1] = 0;
+
+    Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, (ntiles > 1) ? (AP_AUTO_RESTART|AP_START) : AP_START);
+
+    for(int bi=0; bi<NB; bi++){
+        int s = bi & 1;
+        apan_free[s] = 0;
+        cpan_full[s] = 0;
+        inval(Cpan[s], pan_bytes);
+
+        // (1) row bi 전송 예약: tile마다 S2MM 1회 + frame Ktiles개 (IRQ가 차례로 시작)
+        for(int bj=0; bj<NB; bj++){
+            if (bi == NB-1 && bj == NB-1 && ntiles > 1) {
+                // 마지막 tile: 앞 tile 출력 완료 = IP가 마지막 run으로 재시작됨
+                if (gemm_async_wait(XAXIDMA_DEVICE_TO_DMA, 0, DMA_TIMEOUT)!=0){
+                    printf("S2MM async wait fail\n");
+                    return -1;
+                }
+                Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 0);    // auto-restart 해제
+            }
+
+            if (gemm_async_recv(panel_tile(Cpan[s], bj), tile_bytes,
+                                (bj == NB-1) ? cpan_done : 0, (void*)(INTPTR)s, DMA_TIMEOUT)!=0){
+                printf("S2MM async submit fail\n");
+                return -1;
+            }
+            for(int bk=0; bk<NB; bk++){
+                int last = (bj == NB-1 && bk == NB-1);
+                if (gemm_async_send(panel_tile(Apan[s], bk), tile_bytes, 0, 0, DMA_TIMEOUT)!=0 ||
+                    gemm_async_send(tileB(Bp, bk, bj), tile_bytes,
+                                    last ? apan_done : 0, (void*)(INTPTR)s, DMA_TIMEOUT)!=0){
+                    printf("MM2S async submit fail\n");
+                    return -1;
+                }
+            }
+        }
+
+        // (2) row bi가 전송되는 동안: 다음 A panel packing, 이전 C panel unpack
+        if (bi+1 < NB) {
+            if (gemm_async_wait_flag(&apan_free[s^1], DMA_TIMEOUT)!=0){
+                printf("MM2S async wait fail\n");
+                return -1;
+            }
+            gemm_pack_tiles(A + (bi+1)*TILE*N, TILE, N, N, TILE, GEMM_TILES_ROW_MAJOR, Apan[s^1]);
+            flush(Apan[s^1], pan_bytes);
+        }
+        if (bi > 0) {
+            if (gemm_async_wait_flag(&cpan_full[s^1], DMA_TIMEOUT)!=0){
+                printf("S2MM async wait fail\n");
+                return -1;
+            }
+            inval(Cpan[s^1], pan_bytes);
+            gemm_unpack_tiles(Cpan[s^1], TILE, N, TILE, GEMM_TILES_ROW_MAJOR, C + (bi-1)*TILE*N, N);
+        }
+    }
+
+    // (3) 마지막 row unpack + IP idle 확인
+    int s = (NB-1) & 1;
+    if (gemm_async_wait_flag(&cpan_full[s], DMA_TIMEOUT)!=0){
+        printf("S2MM async wait fail\n");
+        return -1;
+    }
+    inval(Cpan[s], pan_bytes);
+    gemm_unpack_tiles(Cpan[s], TILE, N, TILE, GEMM_TILES_ROW_MAJOR, C + (NB-1)*TILE*N, N);
+
+    while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_IDLE));
+    return 0;
+}
+#endif
+
 int main(){
     printf("\n===== GEMM (N=%d) correct Ktiles protocol =====\n", N);
 
     XAxiDma_Config* cfg = XAxiDma_LookupConfig(DMA_DEV_ID);
     XAxiDma_CfgInitialize(&AxiDma,cfg);
 
+    // SG engine이 있으면 BD ring, 없으면 IRQ async (연결된 경우) 또는 polling simple mode
+    int dma_mode = DMA_SIMPLE;
+    if (XAxiDma_HasSg(&AxiDma)) {
+        if (gemm_sg_setup(&AxiDma, TxBds, SG_TX_BDS, RxBds, SG_RX_BDS)!=0){
+            printf("SG ring setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_SG;
+    }
+#if DMA_USE_IRQ
+    else {
+        if (gemm_async_init(&AxiDma, &Intc, XPAR_SCUGIC_SINGLE_DEVICE_ID,
+                            XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID,
+                            XPAR_FABRIC_AXIDMA_0_S2MM_INTROUT_VEC_ID)!=0){
+            printf("DMA interrupt setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_ASYNC;
+    }
+#endif
+    printf("DMA %s%s\n", dma_mode_name[dma_mode],
+           (DMA_2D && dma_mode == DMA_SG) ? ", 2D (BD per tile row)" : "");
+
     static float A[MAXN*MAXN] __attribute__((aligned(64)));
     static float B[MAXN*MAXN] __attribute__((aligned(64)));
     static float Csw[MAXN*MAXN] __attribute__((aligned(64)));
     static float Chw[MAXN*MAXN] __attribute__((aligned(64)));
 
-    static float frame_buf[512] __attribute__((aligned(64)));    // Two tile matrices (A16*16, B16*16)
-    static float out_buf[256]   __attribute__((aligned(64)));    // One tile matrix (C16*16)
-
-    static float A16[256], B16[256];
+    // tile-major packed buffers (DMA가 직접 읽고 씀)
+    static float Ap[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Bp[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Cp[MAXN*MAXN] __attribute__((aligned(64)));
 
     for(int i=0;i<N;i++)
         for(int j=0;j<N;j++){
@@ -123,68 +440,88 @@ int main(){
             B[idx(i,j)] = j + i*0.2f;
         }
 
-    // SW
+    // SW: naive ijk (기존 기준)
     XTime t0,t1;
+    sgemm_set_impl(SGEMM_NAIVE);
     XTime_GetTime(&t0);
     gemm_sw(A,B,Csw);
     XTime_GetTime(&t1);
-    double sw_us=cycles_to_us(t1-t0);
-
-    // HW
-    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
-
-    XTime_GetTime(&t0);
+    double sw_naive_us=cycles_to_us(t1-t0);
 
-    for(int bi=0; bi<NB; bi++){                // NB: 한 축으로의 tile의 수
-        for(int bj=0; bj<NB; bj++){            // NB: 한 축으로의 tile의 수
-
-            // (1) 타일 출력 S2MM을 먼저 1회만 걸어둔다
-            if(dma_recv_tile(out_buf)!=0){
-                printf("S2MM submit fail\n");
-                return -1;
-            }
-
-            // (2) IP start
-            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 1);
-
-            // (3) Ktiles 프레임을 MM2S로 연속 전송 (각 512 floats)
-            for(int bk=0; bk<NB; bk++){
-                extract_block(A, bi, bk, A16);
-                extract_block(B, bk, bj, B16);
+    // SW: packed panel + SIMD micro-kernel + threads (정직한 CPU 기준)
+    //  첫 호출은 pack buffer malloc / thread 생성 포함 → warm-up 1회 뒤 SW_REPS회 중 최소 (routing의 CPU rate)
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+    gemm_sw(A,B,Csw);
+    double sw_us=0;
+    for(int r=0; r<SW_REPS; r++){
+        XTime_GetTime(&t0);
+        gemm_sw(A,B,Csw);
+        XTime_GetTime(&t1);
+        double us=cycles_to_us(t1-t0);
+        if (r==0 || us<sw_us) sw_us=us;
+    }
 
-                memcpy(&frame_buf[0],   A16, 256*sizeof(float));
-                memcpy(&frame_buf[256], B16, 256*sizeof(float));
+    double flops = 2.0 * (double)N * (double)N * (double)N;
 
-                if(dma_send_frame(frame_buf)!=0){
-                    printf("MM2S frame send fail\n");
-                    return -1;
-                }
-            }
+    printf("SW(naive) %.3f us\n", sw_naive_us);
+    printf("SW(%s x%d) %.3f us\n", sgemm_impl_name(SGEMM_SIMD), sgemm_get_threads(), sw_us);
+
+    // CPU / PL 선택 (HW 실행 전): 위 sgemm_cpu 측정 rate vs PL rate + 호출당 고정 비용, 16의 배수가 아닌 shape → CPU
+    sgemm_route_t route = { TILE, flops/(sw_us*1e3), ROUTE_ACCEL_GFLOPS, ROUTE_ACCEL_FIXED_US, 0 };
+    int to_cpu = ROUTE && sgemm_route_to_cpu(&route, N, N, N);
+    if (ROUTE)
+        printf("Route %s (CPU %.3f GFLOPS, PL %.3f GFLOPS + %.1f us)\n", to_cpu ? "CPU" : "PL",
+               route.cpu_gflops, route.accel_gflops, route.accel_fixed_us);
+    if (to_cpu) {
+        // PL 미사용: 같은 sgemm_cpu 설정 (SIMD, SW_THREADS)으로 결과 계산
+        XTime_GetTime(&t0);
+        gemm_sw(A,B,Chw);
+        XTime_GetTime(&t1);
+        printf("CPU %.3f us\n", cycles_to_us(t1-t0));
+        printf("max_abs_err %.6f\n", max_abs_err(Chw, Csw));
+        return 0;
+    }
 
-            // (4) S2MM 완료 대기 (여기서 out_buf 채워짐)
-            if(dma_wait_recv_done()!=0){
-                printf("S2MM wait timeout\n");
-                return -1;
-            }
+    // HW
+    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
 
-            // (5) IP done도 확인(안전)
-            while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & 0x2));
+    XTime_GetTime(&t0);
 
-            // (6) 타일 저장
-            inval(out_buf, 256*sizeof(float));
-            store_block(Chw, bi, bj, out_buf);
-        }
+    int rc;
+#if DMA_USE_IRQ
+    if (dma_mode == DMA_ASYNC) {
+        // A panel packing / C panel unpack을 전송과 겹쳐서 수행
+        rc = gemm_hw_async(A, B, Bp, Chw);
+    } else
+#endif
+#if DMA_2D
+    if (dma_mode == DMA_SG) {
+        // row-major A / B에서 tile row 단위로 gather, Chw로 직접 scatter (packing / unpack 없음)
+        rc = gemm_hw_sg(A, B, Chw);
+    } else
+#endif
+    {
+        // (0) A, B를 1회만 tile-major로 packing
+        gemm_pack_tiles(A, N, N, N, TILE, GEMM_TILES_ROW_MAJOR, Ap);
+        gemm_pack_tiles(B, N, N, N, TILE, GEMM_TILES_COL_MAJOR, Bp);
+
+        rc = (dma_mode == DMA_SG) ? gemm_hw_sg(Ap, Bp, Cp) : gemm_hw_simple(Ap, Bp, Cp);
+
+        // (6) packed C → row-major Chw 1회 unpack
+        if (rc == 0) gemm_unpack_tiles(Cp, N, N, TILE, GEMM_TILES_ROW_MAJOR, Chw, N);
     }
+    if (rc != 0) return -1;
 
     XTime_GetTime(&t1);
     double hw_us=cycles_to_us(t1-t0);
 
-    double flops = 2.0 * (double)N * (double)N * (double)N;
-
-    printf("SW %.3f us\n", sw_us);
     printf("HW %.3f us\n", hw_us);
-    printf("Speedup %.2fx\n", sw_us/hw_us);
+    printf("Speedup %.2fx (vs naive %.2fx)\n", sw_us/hw_us, sw_naive_us/hw_us);
     printf("GFLOPS %.3f\n", flops/(hw_us*1e-6)/1e9);
 
+    // 결과 검증 (SW 기준)
+    printf("max_abs_err %.6f\n", max_abs_err(Chw, Csw));
+
     return 0;
 }
@@ -1,6 +1,6 @@
 module axis_tlast_gen #(
-    parameter integer TDATA_W     = 32,
-    parameter integer FRAME_WORDS = 512
+    parameter integer TDATA_W     = 32,     // 32 / 64 / 128
+    parameter integer FRAME_WORDS = 512     // frame length in 32-bit words
 )(
     input  wire                   aclk,
     input  wire                   aresetn,
@@ -31,17 +31,19 @@ module axis_tlast_gen #(
     // Count only when transfer happens
     wire xfer = s_axis_tvalid && s_axis_tready;
 
-    localparam integer CNT_W = $clog2(FRAME_WORDS);
+    // TDATA_W/32 words per beat (last beat rounded up)
+    localparam integer FRAME_BEATS = (FRAME_WORDS*32 + TDATA_W-1) / TDATA_W;
+    localparam integer CNT_W = (FRAME_BEATS > 1) ? $clog2(FRAME_BEATS) : 1;
     reg [CNT_W-1:0] beat_cnt;
 
     // Assert TLAST exactly at last beat of frame
-    assign m_axis_tlast = xfer && (beat_cnt == FRAME_WORDS-1);
+    assign m_axis_tlast = xfer && (beat_cnt == FRAME_BEATS-1);
 
     always @(posedge aclk) begin
         if (!aresetn) begin
             beat_cnt <= {CNT_W{1'b0}};
         end else if (xfer) begin
-            if (beat_cnt == FRAME_WORDS-1)
+            if (beat_cnt == FRAME_BEATS-1)
                 beat_cnt <= {CNT_W{1'b0}};
             else
                 beat_cnt <= beat_cnt + 1'b1;
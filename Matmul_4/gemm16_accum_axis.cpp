@@ -1,23 +1,168 @@
 // ================================================================
 // gemm16_accum_axis_db.cpp  (Double-Buffered version)
 //  - Target: Zynq-7000 (xc7z020) @ 100MHz class
-//  - AXI4-Stream in/out (32-bit float packed in TDATA)
-//  - AXI-Lite control: Ktiles
+//  - AXI4-Stream in/out, W = 32 / 64 / 128-bit TDATA (1 / 2 / 4 words
+//    of 32 bits per beat, word l in [32l+31:32l])
+//  - AXI-Lite control: Ktiles, a_mode, Jtiles, edge, epilogue, alpha, fmt,
+//                      Ntiles, cblock, jobs, last_job (out),
+//                      perf_* (out, stage cycle / event counters)
 //
 //  - Key optimizations:
-//    1) DOUBLE BUFFERING: overlap recv of next A/B tile with
-//       compute of current tile via ping-pong buffers + DATAFLOW
+//    1) DOUBLE BUFFERING: recv of tile k+1 overlaps compute of tile k.
+//       One DATAFLOW region per run (recv_frames -> mac_frames ->
+//       send_result), each process loops over all Ktiles frames and
+//       the A / B tiles travel in stream_of_blocks ping-pong buffers
+//       that recv writes in place (no FIFO -> BRAM copy)
 //    2) MANUAL ADDER TREE: 8-way MAC chunk with balanced tree
+//       (gemm_mac_tile, HLS_Common/gemm_tile.h)
+//    3) A-PANEL REUSE: A(bi,0..Ktiles-1) is identical for every bj,
+//       so it can be kept in an on-chip panel (KT_MAX tiles) and
+//       frames shrink to B16 only
+//    4) EDGE TILES: M, N, K need not be multiples of 16. Partial
+//       tiles arrive compact and are zero-padded on chip; only the
+//       valid part of C is sent back
+//    5) FUSED EPILOGUE: C = act(A*B + bias) applied in send_result,
+//       so the host does not make another pass over C per layer
+//    6) HALF-WIDTH INPUT: fp16 / bf16 A and B, two per word, widened
+//       to fp32 in recv; the MAC still accumulates in fp32
+//    7) WIDE STREAM: the stream width is a template parameter; recv
+//       unpacks up to a pair per cycle from 64/128-bit beats, so an
+//       fp32 frame loads in 256 cycles instead of 512
+//    8) OUTPUT DOUBLE BUFFERING: with Ntiles > 1 one run computes
+//       Ntiles output tiles; two C accumulators ping-pong between
+//       mac_frames and send_result, so the S2MM of tile t overlaps the
+//       clear + accumulation of tile t+1
+//    9) REGISTER BLOCKING: cblock = br x bc C tiles (up to CB_MAX x
+//       CB_MAX) accumulated on chip at once. A K step brings br A and
+//       bc B tiles, each used for bc / br tile products: 2x2 moves half
+//       the words per C tile of 1x1 (16 -> 32 FLOPs per word)
+//   10) JOB QUEUE: with jobs = 1 every C block brings its own settings
+//       in a descriptor at the head of its input, and the run lasts
+//       until an end-of-queue descriptor. One start (plus auto-restart)
+//       serves whole GEMMs, or GEMMs of different shapes back to back,
+//       with no AXI-Lite traffic between output tiles
+//   11) PERF COUNTERS: each DATAFLOW process counts its own busy and
+//       stall cycles, so stage utilization is measured on the board
 //
 //  - Protocol:
 //      Input:  Ktiles frames, each frame = A16(256) + B16(256) = 512 words
+//              (a_mode REUSE: frame = B16(256) only)
 //      Output: C16(256) words, TLAST asserted on last output word
 //
-//  - Pipeline structure (per Ktile iteration):
-//      [recv A/B into buf[ping]] || [compute C += A*B from buf[pong]]
-//      (first iteration: recv only, last iteration: compute only)
-//      Total latency ≈ (Ktiles+1) * max(recv_time, compute_time)
-//      vs. original: Ktiles * (recv_time + compute_time)
+//  - Ntiles (CTRL 0x48): output tiles per run (0 / 1 = one, the
+//    original protocol). The input is Ntiles times [header][bias]
+//    + Ktiles frames, the output Ntiles C tiles, each with its own
+//    TLAST (one S2MM transfer per tile). Header, bias and the AMODE_ROW
+//    counter are per tile, so a whole C (MT x NT tiles, row-major) is
+//    one run with a_mode = AMODE_ROW, Jtiles = NT
+//
+//  - cblock (CTRL 0x50): [3:0] br, [7:4] bc tiles per C block (0 -> 1,
+//    max CB_MAX; 0 / 0x11 = the 1x1 protocol above). Everything "per
+//    tile" above is then per C block (rows x cols up to br*16 x bc*16,
+//    row-major over blocks; Ntiles counts blocks, Jtiles blocks per
+//    block row):
+//      Input:  [header][bias: cols words], then per K step
+//              A(r, k), r < br, then B(k, c), c < bc (each a tile as
+//              above, skipped in REUSE; a tile with 0 valid rows /
+//              cols has no words)
+//      Output: C(r, c) row-major over the block, one TLAST per tile,
+//              tiles with 0 valid rows / cols skipped
+//    The A panel holds A(r, k) at panel[r*Ktiles + k], so LOAD /
+//    REUSE / ROW need Ktiles * br <= KT_MAX
+//
+//  - jobs (CTRL 0x58) = 1: job queue. Ntiles and the per-block CTRL
+//    registers (Ktiles, a_mode, edge, epilogue, fmt, cblock) are not
+//    used; each C block's input starts with a descriptor segment
+//      word 0: [7:0] Ktiles (0 = end of queue, nothing follows)
+//              [9:8] a_mode, [10] edge, [12:11] fmt,
+//              [20:16] epilogue (CTRL 0x30 bits), [31:24] cblock
+//      word 1: job id (any value, echoed in last_job)
+//      word 2: edge header (only with edge)
+//    followed by the block's bias and K steps as above. The run ends
+//    (ap_done) after the end-of-queue word; with auto-restart the IP
+//    is back at the next descriptor at once. Jtiles (AMODE_ROW) and
+//    alpha stay in CTRL. A job whose A panel would exceed KT_MAX ends
+//    the queue like Ktiles = 0 (its input is left in the stream)
+//  - last_job (CTRL 0x60, output): id of the last C block sent (job
+//    id, or the block index within the run with jobs = 0), a progress
+//    register the host can read without stopping the run
+//
+//  - perf_* (CTRL 0x70.., outputs, 0x10 apart): free-running 32-bit
+//    counters (never reset, wrap; the host takes differences), updated
+//    after every C block:
+//      perf_recv      cycles recv_frames moved input (tile, bias and
+//                     descriptor loop iterations)
+//      perf_in_stall  cycles a tile loop waited for s_in (read_nb
+//                     miss); waiting for a block's first word is idle,
+//                     not stall
+//      perf_mac       cycles in gemm_mac_tile, C clear and panel copy
+//      perf_mac_stall cycles mac_frames waited for an A / B block
+//      perf_send      cycles send_result moved C words
+//      perf_out_stall cycles s_out was full (write_nb miss)
+//      perf_frames    K steps accumulated
+//      perf_tiles     C tiles sent
+//    busy + stall of a stage = cycles spent in its II=1 loops
+//
+//  - a_mode (CTRL 0x18):
+//      AMODE_STREAM : A+B frames, panel untouched (original protocol)
+//      AMODE_LOAD   : A+B frames, A(k) also written to panel[k]
+//      AMODE_REUSE  : B-only frames, A(k) read from panel[k]
+//      AMODE_ROW    : LOAD on the first of every Jtiles (CTRL 0x20)
+//                     output tiles, REUSE on the others. For hosts that
+//                     keep the IP in auto-restart or run many tiles per
+//                     start (Ntiles) and cannot rewrite a_mode between
+//                     output tiles; the tile counter is reset by any
+//                     non-ROW run
+//    LOAD / REUSE / ROW require Ktiles <= KT_MAX (else no output)
+//
+//  - edge (CTRL 0x28) != 0: every output tile starts with one header word
+//      [7:0] rows, [15:8] cols of this C tile (1..16, C block: up to
+//      br*16 / bc*16), [23:16] valid k of the last K tile (1..16),
+//      0 = full
+//    A tile (k) = rows x kv words, B tile (k) = kv x cols words
+//    (kv = 16, or the header value for k = Ktiles-1), row-major,
+//    C tile = rows x cols words with TLAST on its last word.
+//    The header is per tile, so auto-restart / Ntiles hosts can stream
+//    tiles of any shape back to back
+//
+//  - epilogue (CTRL 0x30):
+//      [1:0] EPI_NONE / EPI_RELU / EPI_RELU6 / EPI_LEAKY (alpha, CTRL 0x38)
+//      [4]   EPI_BIAS: after the edge header (if any), each tile reads
+//            cols (16, C block: bc*16) bias words, one per C column,
+//            before the frames
+//
+//  - fmt (CTRL 0x40): A / B element format
+//      FMT_FP32 : one float per word (original protocol)
+//      FMT_FP16 / FMT_BF16 : two per word, element 2q in [15:0],
+//            2q+1 in [31:16]; a tile row of w elements is ceil(w/2)
+//            words, so A+B frames are 256 words (B-only: 128).
+//            Bias, header and C stay fp32
+//    recv / load move element pairs, so a half frame is loaded in
+//    128 cycles and the 256-cycle MAC sets the frame rate (fp32 frame:
+//    512 cycles on the stream)
+//
+//  - Stream width (top functions):
+//      gemm16_accum_axis_db      : 32-bit  (original IP)
+//      gemm16_accum_axis_db_x64  : 64-bit  (Zynq HP port / AXI DMA width)
+//      gemm16_accum_axis_db_x128 : 128-bit
+//    The word stream above is cut into segments (header, bias, each A
+//    tile, each B tile, C), one DMA transfer each. Every segment starts
+//    on a beat boundary; the unused words of its last beat are ignored
+//    on input and have TKEEP = 0 on output. TLAST on the last C beat.
+//    fp32 frame time (recv vs 256-cycle MAC): 512 / 256 / 256 cycles,
+//    128-bit halves the beats but recv still moves one pair per cycle
+//
+//  - Pipeline structure (one DATAFLOW region per run):
+//      recv_frames : header, bias, frame k -> A / B block (write lock)
+//      mac_frames  : CLEAR_C, then C(r,c) += A(r,k) * B(k,c) (read
+//                    lock), A from the panel in REUSE, C in a C block
+//      send_result : act(C + bias) once the last frame of a tile is done
+//    recv(k+1) || mac(k), send(t) || mac(t+1), without a region
+//    restart per frame or tile:
+//      Total latency ~ Ktiles * max(recv_time, compute_time)
+//                      + min(recv_time, compute_time) + send
+//    vs. original: Ktiles * (recv_time + compute_time)
+//    With Ntiles > 1 the send is hidden too, except after the last tile
 //
 //  - CSIM-safe float<->u32 bitcast via memcpy
 // ================================================================
@@ -25,228 +170,809 @@
 #include <hls_stream.h>
 #include <ap_int.h>
 #include <ap_axi_sdata.h>
-#include <cstring>
+#include <hls_streamofblocks.h>
 #include <stdint.h>
 
+#include "gemm_tile.h"   // HLS_Common: u32_to_f / f_to_u32, gemm_mac_tile
+
 #define N 16
 #define KCHUNK 8
+#define KT_MAX 48        // A panel depth in tiles (N = 768)
+
+#ifndef CB_MAX
+#define CB_MAX 2         // C block up to CB_MAX x CB_MAX tiles (cblock)
+#endif
+
+#define AMODE_STREAM 0
+#define AMODE_LOAD   1
+#define AMODE_REUSE  2
+#define AMODE_ROW    3
+
+#define EPI_NONE     0
+#define EPI_RELU     1
+#define EPI_RELU6    2
+#define EPI_LEAKY    3
+#define EPI_ACT_MASK 0x3
+#define EPI_BIAS     0x10
+
+#define FMT_FP32     0
+#define FMT_FP16     1
+#define FMT_BF16     2
+
+#define HDR_ROWS(h)  ((int)((h)        & 0xFF))
+#define HDR_COLS(h)  ((int)(((h) >> 8)  & 0xFF))
+#define HDR_KLAST(h) ((int)(((h) >> 16) & 0xFF))
+
+#define CBLK_ROWS(b) ((int)((b)        & 0xF))
+#define CBLK_COLS(b) ((int)(((b) >> 4)  & 0xF))
 
-typedef ap_axiu<32, 0, 0, 0> axis_t;
+#define JOB_KTILES(d) ((int)((d)        & 0xFF))
+#define JOB_AMODE(d)  ((int)(((d) >> 8)  & 0x3))
+#define JOB_EDGE(d)   ((int)(((d) >> 10) & 0x1))
+#define JOB_FMT(d)    ((int)(((d) >> 11) & 0x3))
+#define JOB_EPI(d)    ((int)(((d) >> 16) & 0x1F))
+#define JOB_CBLK(d)   ((int)(((d) >> 24) & 0xFF))
+
+typedef axis_w<32> axis_t;
+
+// A or B tiles of one K step (CB_MAX, only the C block's rows / cols
+// used) and the C block: the units of the recv -> mac -> send ping-pongs
+typedef float tile_t[N][N];
+typedef float tiles_t[CB_MAX][N][N];
+typedef float ctiles_t[CB_MAX*CB_MAX][N][N];
 
 // ------------------------------
-// CSIM-safe bit reinterpretation
+// fp16 / bf16 (low 16 bits of h) -> float, exact
 // ------------------------------
-static inline float u32_to_f(ap_uint<32> u) {
-#pragma HLS INLINE
-    float f;
-    uint32_t tmp = (uint32_t)u.to_uint();
-    std::memcpy(&f, &tmp, sizeof(float));
-    return f;
-}
-static inline ap_uint<32> f_to_u32(float f) {
+static inline float u16_to_f(uint32_t h, int fmt) {
 #pragma HLS INLINE
-    uint32_t tmp;
-    std::memcpy(&tmp, &f, sizeof(uint32_t));
-    return ap_uint<32>(tmp);
+    if (fmt == FMT_BF16) return u32_to_f(ap_uint<32>(h << 16));
+
+    uint32_t sign = (h & 0x8000u) << 16;
+    uint32_t exp  = (h >> 10) & 0x1F;
+    uint32_t man  = h & 0x3FF;
+    uint32_t bits;
+    if (exp == 0x1F) {                       // inf / NaN
+        bits = sign | 0x7F800000u | (man << 13);
+    } else if (exp != 0) {                   // normal: rebias 15 -> 127
+        bits = sign | ((exp + 112) << 23) | (man << 13);
+    } else if (man == 0) {                   // +-0
+        bits = sign;
+    } else {                                 // subnormal: man * 2^-24, normalize
+        int lead = 0;
+        for (int b = 0; b < 10; b++) {
+#pragma HLS UNROLL
+            if ((man >> b) & 1) lead = b;
+        }
+        bits = sign | ((uint32_t)(103 + lead) << 23) | ((man << (23 - lead)) & 0x7FFFFFu);
+    }
+    return u32_to_f(ap_uint<32>(bits));
 }
 
 // ------------------------------
-// 8-way adder-tree reduction
+// C-sim only: s_in / s_out miss injection for the testbench. C-sim
+// runs the processes one after the other with all input queued and an
+// unbounded s_out, so the tile loops' read_nb / write_nb never miss
+// there. gemm16_nb_miss(in, out) makes every in-th s_in read_nb and
+// every out-th s_out write_nb miss once (period >= 2, else off); the
+// loop retries next cycle and must count exactly one stall per miss.
+// gemm16_nb_missed() returns the misses injected since the last setup
 // ------------------------------
-static inline float reduce8_tree(float p0, float p1, float p2, float p3,
-                                 float p4, float p5, float p6, float p7) {
-#pragma HLS INLINE
-    float s0 = p0 + p1;
-    float s1 = p2 + p3;
-    float s2 = p4 + p5;
-    float s3 = p6 + p7;
-    float s4 = s0 + s1;
-    float s5 = s2 + s3;
-    return s4 + s5;
+#ifndef __SYNTHESIS__
+static long nb_every[2], nb_calls[2], nb_missed[2];      // [0] s_in, [1] s_out
+
+void gemm16_nb_miss(int in_every, int out_every) {
+    nb_every[0] = in_every;
+    nb_every[1] = out_every;
+    nb_calls[0] = nb_calls[1] = nb_missed[0] = nb_missed[1] = 0;
+}
+
+void gemm16_nb_missed(long *in, long *out) {
+    *in  = nb_missed[0];
+    *out = nb_missed[1];
 }
 
+static inline bool nb_inject(int d) {
+    if (nb_every[d] < 2 || ++nb_calls[d] % nb_every[d]) return false;
+    nb_missed[d]++;
+    return true;
+}
+#define S_IN_READ_NB(s, x)   (!nb_inject(0) && (s).read_nb(x))
+#define S_OUT_WRITE_NB(s, x) (!nb_inject(1) && (s).write_nb(x))
+#else
+#define S_IN_READ_NB(s, x)   (s).read_nb(x)
+#define S_OUT_WRITE_NB(s, x) (s).write_nb(x)
+#endif
+
 // ==============================================================
-// Sub-functions for DATAFLOW-friendly double buffering
+// Sub-functions: task-level pipeline recv -> mac -> send
 // ==============================================================
 
-// ---- Receive one A+B tile into flat arrays via FIFO streams ----
-static void recv_tile(
-    hls::stream<axis_t>& s_in,
-    hls::stream<float>&  fifo_A,
-    hls::stream<float>&  fifo_B)
+// ---- Receive one 16x16 tile straight into T, element pairs ----
+// Only the valid h x w elements are on the stream, T still gets a full
+// zero-padded tile. fp32: one word per element, fp16 / bf16: one word
+// per pair. 32-bit fp32 takes an element per cycle; otherwise a pair
+// per cycle, words of the current beat wait in wbuf
+template<int W>
+static void recv_pairs(
+    hls::stream<axis_w<W> >& s_in,
+    float                    T[N][N],
+    int                      h,
+    int                      w,
+    int                      fmt,
+    uint32_t&                busy,
+    uint32_t&                stall)
 {
-    // recv A (256 floats)
-    for (int idx = 0; idx < N*N; idx++) {
+#pragma HLS ARRAY_PARTITION variable=T cyclic factor=2 dim=2
+    const int WPB = W / 32;      // words per beat
+
+    // Both loops advance idx only when the word they need is there; an
+    // iteration without it is a stall cycle
+    if (WPB == 1 && fmt == FMT_FP32) {
+        int idx = 0;
+        while (idx < N*N) {
 #pragma HLS PIPELINE II=1
-        axis_t w = s_in.read();
-        fifo_A.write(u32_to_f(w.data));
+#pragma HLS LOOP_TRIPCOUNT min=256 max=256
+            int i = idx / N, j = idx % N;
+            float a = 0.0f;
+            if (i < h && j < w) {
+                axis_w<W> x;
+                if (!S_IN_READ_NB(s_in, x)) { stall++; continue; }
+                a = u32_to_f(x.data.range(31, 0));
+            }
+            T[i][j] = a;
+            busy++;
+            idx++;
+        }
+        return;
     }
-    // recv B (256 floats)
-    for (int idx = 0; idx < N*N; idx++) {
+
+    // unread words of the last beat (< 2 words needed + WPB new ones);
+    // whatever is left at the end is the segment's padding
+    uint32_t wbuf[2*WPB];
+#pragma HLS ARRAY_PARTITION variable=wbuf complete
+    int nbuf = 0;
+    int idx = 0;
+    while (idx < N*N/2) {
 #pragma HLS PIPELINE II=1
-        axis_t w = s_in.read();
-        fifo_B.write(u32_to_f(w.data));
+#pragma HLS LOOP_TRIPCOUNT min=128 max=128
+        int i = idx / (N/2), j = 2 * (idx % (N/2));
+        bool v0 = (i < h && j < w);
+        bool v1 = (i < h && j + 1 < w);
+        int need = (fmt == FMT_FP32) ? (int)v0 + (int)v1 : (int)v0;
+
+        if (nbuf < need) {
+            axis_w<W> x;
+            if (!S_IN_READ_NB(s_in, x)) { stall++; continue; }
+            for (int l = 0; l < WPB; l++) {
+#pragma HLS UNROLL
+                wbuf[nbuf + l] = x.data.range(32*l + 31, 32*l).to_uint();
+            }
+            nbuf += WPB;
+        }
+
+        float x0 = 0.0f, x1 = 0.0f;
+        if (fmt == FMT_FP32) {
+            if (v0) x0 = u32_to_f(ap_uint<32>(wbuf[0]));
+            if (v1) x1 = u32_to_f(ap_uint<32>(wbuf[1]));
+        } else if (v0) {
+            x0 = u16_to_f(wbuf[0] & 0xFFFF, fmt);
+            if (v1) x1 = u16_to_f(wbuf[0] >> 16, fmt);
+        }
+        T[i][j]   = x0;
+        T[i][j+1] = x1;
+
+        for (int l = 0; l < 2*WPB; l++) {
+#pragma HLS UNROLL
+            wbuf[l] = (l + need < 2*WPB) ? wbuf[l + need] : 0;
+        }
+        nbuf -= need;
+        busy++;
+        idx++;
     }
 }
 
-// ---- Load A/B from FIFOs into local BRAM arrays ----
-static void load_tile(
-    hls::stream<float>& fifo_A,
-    hls::stream<float>& fifo_B,
-    float A[N][N],
-    float B[N][N])
+// ---- Valid rows / cols of sub-tile i of an n-wide block (0..16) ----
+static inline int sub_dim(int n, int i) {
+#pragma HLS INLINE
+    int d = n - i*N;
+    return (d < 0) ? 0 : ((d > N) ? N : d);
+}
+
+// ---- C block side in tiles (cblock field, 0 -> 1, max CB_MAX) ----
+static inline int cblk_dim(int v) {
+#pragma HLS INLINE
+    return (v < 1) ? 1 : ((v > CB_MAX) ? CB_MAX : v);
+}
+
+// ---- Per-block control for mac_frames (end: no more blocks) ----
+struct mac_job_t {
+    int  mode;
+    int  ktiles;
+    int  br;
+    int  bc;
+    bool end;
+};
+
+// ---- Per-block info for send_result ----
+struct tile_info_t {
+    int   rows;
+    int   cols;
+    int   br;
+    int   bc;
+    int   act;
+    int   id;
+    bool  end;
+    float bias[CB_MAX*N];
+};
+
+// ---- Process 1: C blocks of Ktiles K steps each into A / B blocks ----
+// Per C block (br x bc tiles): [job descriptor], edge header, bias,
+// then per K step the br A tiles A(bi*br+r, k) and the bc B tiles
+// B(k, bj*bc+c). Edge tiles: only the valid rows x kv (A) / kv x cols
+// (B) elements are on the stream, each tile starting on a new beat; a
+// tile outside the matrix (0 rows / cols) has no words. REUSE steps
+// carry no A tiles, so no A block is produced. The block's A source
+// and size go to mac_frames, its shape and bias to send_result; after
+// Ntiles blocks (jobs = 0) or at the end-of-queue descriptor both get
+// an end token. perf_recv / perf_in_stall after every block
+template<int W>
+static void recv_frames(
+    hls::stream<axis_w<W> >&         s_in,
+    hls::stream_of_blocks<tiles_t>&  a_blocks,
+    hls::stream_of_blocks<tiles_t>&  b_blocks,
+    hls::stream<mac_job_t>&          job_s,
+    hls::stream<tile_info_t>&        info_s,
+    int                              jobs,
+    int                              Ntiles,
+    int                              Ktiles,
+    int                              cblock,
+    int                              a_mode,
+    int                              Jtiles,
+    int                              edge,
+    int                              epilogue,
+    int                              fmt,
+    uint32_t                        *perf_recv,
+    uint32_t                        *perf_in_stall)
 {
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
+    const int WPB = W / 32;
+    static int row_cnt = 0;          // AMODE_ROW: C blocks since the last LOAD
+    static uint32_t busy = 0, stall = 0;
+
+    RECV_TILES:
+    for (int t = 0; ; t++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        // ---- This block's settings: CTRL, or its job descriptor ----
+        int kt = Ktiles, am = a_mode, ed = edge, epi = epilogue, fm = fmt, cb = cblock;
+        int id = t;
+        bool end = false;
+        uint32_t dsc[3] = { 0, 0, 0 };
+        if (jobs) {
+            ap_uint<W> dw = 0;
+            int nd = 1;
+            for (int i = 0; i < 3; i++) {
 #pragma HLS PIPELINE II=1
-            A[i][j] = fifo_A.read();
+                if (i < nd) {
+                    if (i % WPB == 0) dw = s_in.read().data;
+                    dsc[i] = dw.range(32*(i % WPB) + 31, 32*(i % WPB)).to_uint();
+                    if (i == 0 && JOB_KTILES(dsc[0]) != 0) nd = 2 + JOB_EDGE(dsc[0]);
+                    busy++;
+                }
+            }
+            kt  = JOB_KTILES(dsc[0]);
+            am  = JOB_AMODE(dsc[0]);
+            ed  = JOB_EDGE(dsc[0]);
+            fm  = JOB_FMT(dsc[0]);
+            epi = JOB_EPI(dsc[0]);
+            cb  = JOB_CBLK(dsc[0]);
+            id  = (int)dsc[1];
+            end = (kt == 0) || (am != AMODE_STREAM && kt * cblk_dim(CBLK_ROWS(cb)) > KT_MAX);
+        } else {
+            end = (t >= Ntiles);
         }
-    }
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
+        int br = cblk_dim(CBLK_ROWS(cb)), bc = cblk_dim(CBLK_COLS(cb));
+
+        tile_info_t info;
+        mac_job_t   job;
+        info.end = job.end = end;
+        if (end) {
+            job_s.write(job);
+            info_s.write(info);
+            *perf_recv     = busy;
+            *perf_in_stall = stall;
+            break;
+        }
+
+        // ---- Edge block shape (header word: own segment, or descriptor word 2) ----
+        int rows = br*N, cols = bc*N, klast = N;
+        if (ed) {
+            ap_uint<32> h = jobs ? ap_uint<32>(dsc[2]) : s_in.read().data.range(31, 0);
+            rows  = HDR_ROWS(h);
+            cols  = HDR_COLS(h);
+            klast = HDR_KLAST(h);
+            if (rows  == 0 || rows  > br*N) rows  = br*N;
+            if (cols  == 0 || cols  > bc*N) cols  = bc*N;
+            if (klast == 0 || klast > N)    klast = N;
+        }
+        info.rows = rows;
+        info.cols = cols;
+        info.br   = br;
+        info.bc   = bc;
+        info.act  = epi & EPI_ACT_MASK;
+        info.id   = id;
+
+        // ---- Per-column bias (first words of the block, WPB per beat) ----
+        ap_uint<W> bw = 0;
+        for (int j = 0; j < CB_MAX*N; j++) {
 #pragma HLS PIPELINE II=1
-            B[i][j] = fifo_B.read();
+            float b = 0.0f;
+            if ((epi & EPI_BIAS) && j < cols) {
+                if (j % WPB == 0) bw = s_in.read().data;
+                b = u32_to_f(bw.range(32*(j % WPB) + 31, 32*(j % WPB)));
+            }
+            info.bias[j] = b;
+        }
+        busy += CB_MAX*N;
+
+        // ---- Resolve this block's A source ----
+        int mode = am;
+        if (am == AMODE_ROW) {
+            mode    = (row_cnt == 0) ? AMODE_LOAD : AMODE_REUSE;
+            row_cnt = (row_cnt + 1 >= Jtiles) ? 0 : row_cnt + 1;
+        } else {
+            row_cnt = 0;
+        }
+        job.mode   = mode;
+        job.ktiles = kt;
+        job.br     = br;
+        job.bc     = bc;
+        job_s.write(job);
+        info_s.write(info);
+
+        RECV_FRAMES:
+        for (int k = 0; k < kt; k++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=48
+            int kv = (k == kt-1) ? klast : N;
+            if (mode != AMODE_REUSE) {
+                hls::write_lock<tiles_t> A(a_blocks);
+                for (int r = 0; r < br; r++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                    recv_pairs<W>(s_in, A[r], sub_dim(rows, r), kv, fm, busy, stall);
+                }
+            }
+            hls::write_lock<tiles_t> B(b_blocks);
+            for (int c = 0; c < bc; c++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                recv_pairs<W>(s_in, B[c], kv, sub_dim(cols, c), fm, busy, stall);
+            }
         }
+        *perf_recv     = busy;
+        *perf_in_stall = stall;
     }
 }
 
-// ---- MAC: C += A * B with 8-way tree ----
-static void mac_tile(
-    float A[N][N],
-    float B[N][N],
-    float C[N][N])
+// ---- Process 2: C(t) = sum_k A(k) * B(k) for each C block ----
+// Register blocking: every A tile of a K step meets all bc B tiles and
+// every B tile all br A tiles, br * bc tile products per br + bc tiles
+// received (1x1: one per two). C is a block of the c_blocks ping-pong:
+// block t+1 is cleared and accumulated in one buffer while send_result
+// drains block t from the other. The A panel lives here only (A tile
+// (r, k) at panel[r*Ktiles + k]): REUSE multiplies straight out of the
+// panel, LOAD keeps a copy of the received tiles (a row per cycle).
+// Mode, Ktiles and shape come per block from recv_frames. Busy cycles
+// are counted per loop (a gemm_mac_tile call is N*N cycles), stall
+// cycles while the next A / B block is not there yet
+static void mac_frames(
+    hls::stream_of_blocks<tiles_t>&  a_blocks,
+    hls::stream_of_blocks<tiles_t>&  b_blocks,
+    hls::stream<mac_job_t>&          job_s,
+    hls::stream_of_blocks<ctiles_t>& c_blocks,
+    float                            A_panel[KT_MAX][N][N],
+    uint32_t                        *perf_mac,
+    uint32_t                        *perf_mac_stall,
+    uint32_t                        *perf_frames)
 {
-#pragma HLS ARRAY_PARTITION variable=A complete dim=2
-#pragma HLS ARRAY_PARTITION variable=B complete dim=1
-#pragma HLS ARRAY_PARTITION variable=C complete dim=2
-
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-#pragma HLS PIPELINE II=1
+    static uint32_t busy = 0, stall = 0, frames = 0;
 
-            float sum = 0.0f;
+    MAC_TILES:
+    for (;;) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        mac_job_t job = job_s.read();
+        if (job.end) break;
+        int mode = job.mode, Ktiles = job.ktiles, br = job.br, bc = job.bc;
+        hls::write_lock<ctiles_t> C(c_blocks);
 
-            for (int kb = 0; kb < N; kb += KCHUNK) {
+        // Clear accumulators, a row per cycle (overlaps the first recv)
+        CLEAR_C:
+        for (int q = 0; q < CB_MAX*CB_MAX*N; q++) {
+#pragma HLS PIPELINE II=1
+            for (int j = 0; j < N; j++) {
 #pragma HLS UNROLL
-                float p0 = A[i][kb+0] * B[kb+0][j];
-                float p1 = A[i][kb+1] * B[kb+1][j];
-                float p2 = A[i][kb+2] * B[kb+2][j];
-                float p3 = A[i][kb+3] * B[kb+3][j];
-                float p4 = A[i][kb+4] * B[kb+4][j];
-                float p5 = A[i][kb+5] * B[kb+5][j];
-                float p6 = A[i][kb+6] * B[kb+6][j];
-                float p7 = A[i][kb+7] * B[kb+7][j];
-
-                float part = reduce8_tree(p0,p1,p2,p3,p4,p5,p6,p7);
-                sum += part;
+                C[q / N][q % N][j] = 0.0f;
             }
+        }
+        busy += CB_MAX*CB_MAX*N;
 
-            C[i][j] += sum;
+        MAC_FRAMES:
+        for (int k = 0; k < Ktiles; k++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=48
+            MAC_WAIT:
+            while (b_blocks.empty() || (mode != AMODE_REUSE && a_blocks.empty())) {
+#pragma HLS PIPELINE II=1
+                stall++;
+            }
+            busy += br*bc*N*N + ((mode == AMODE_LOAD) ? br*N : 0);
+            frames++;
+            hls::read_lock<tiles_t> B(b_blocks);
+            if (mode == AMODE_REUSE) {
+                for (int r = 0; r < br; r++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                    for (int c = 0; c < bc; c++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                        gemm_mac_tile<N, N, N, KCHUNK, float>(A_panel[r*Ktiles + k], B[c], C[r*CB_MAX + c]);
+                    }
+                }
+            } else {
+                hls::read_lock<tiles_t> A(a_blocks);
+                for (int r = 0; r < br; r++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                    for (int c = 0; c < bc; c++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX
+                        gemm_mac_tile<N, N, N, KCHUNK, float>(A[r], B[c], C[r*CB_MAX + c]);
+                    }
+                    if (mode == AMODE_LOAD) {
+                        for (int i = 0; i < N; i++) {
+#pragma HLS PIPELINE II=1
+                            for (int j = 0; j < N; j++) {
+#pragma HLS UNROLL
+                                A_panel[r*Ktiles + k][i][j] = A[r][i][j];
+                            }
+                        }
+                    }
+                }
+            }
         }
+        *perf_mac       = busy;
+        *perf_mac_stall = stall;
+        *perf_frames    = frames;
     }
 }
 
-// ---- Send C (256 words) with TLAST ----
+// ---- Epilogue: act(c + bias) ----
+static inline float epilogue_op(float v, int act, float alpha) {
+#pragma HLS INLINE
+    switch (act) {
+    case EPI_RELU:  return (v > 0.0f) ? v : 0.0f;
+    case EPI_RELU6: return (v > 6.0f) ? 6.0f : ((v > 0.0f) ? v : 0.0f);
+    case EPI_LEAKY: return (v > 0.0f) ? v : v * alpha;
+    default:        return v;
+    }
+}
+
+// ---- Process 3: send act(C + bias) of each C block ----
+// Tile by tile, row-major over the block (tiles outside the matrix are
+// skipped), rows x cols words per tile (256 for a full tile), TLAST on
+// the last word of every tile. Words are packed WPB per beat; the last
+// beat of a tile may be partial (TKEEP). last_job = the block's id once
+// its last word is out. A beat s_out does not take (write_nb miss) is
+// retried the next cycle and counted as an output stall
+template<int W>
 static void send_result(
-    float C[N][N],
-    hls::stream<axis_t>& s_out)
+    hls::stream_of_blocks<ctiles_t>& c_blocks,
+    hls::stream<tile_info_t>&        info_s,
+    hls::stream<axis_w<W> >&         s_out,
+    float                            alpha,
+    int                             *last_job,
+    uint32_t                        *perf_send,
+    uint32_t                        *perf_out_stall,
+    uint32_t                        *perf_tiles)
 {
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
+    const int WPB = W / 32;
+    static uint32_t busy = 0, stall = 0, tiles = 0;
+
+    SEND_TILES:
+    for (;;) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=64
+        tile_info_t info = info_s.read();
+        if (info.end) break;
+        int br = info.br, bc = info.bc, act = info.act;
+        hls::read_lock<ctiles_t> C(c_blocks);
+
+        for (int q = 0; q < br*bc; q++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=CB_MAX*CB_MAX
+            int r = q / bc, c = q % bc;
+            int rows = sub_dim(info.rows, r), cols = sub_dim(info.cols, c);
+            if (rows == 0 || cols == 0) continue;
+            ap_uint<W> d = 0;
+            int lane = 0;
+
+            int idx = 0;
+            while (idx < N*N) {
 #pragma HLS PIPELINE II=1
-            axis_t o;
-            o.data = f_to_u32(C[i][j]);
-            o.keep = (ap_uint<4>)0xF;
-            o.strb = (ap_uint<4>)0xF;
-            o.user = 0;
-            o.id   = 0;
-            o.dest = 0;
-            o.last = ((i == N-1) && (j == N-1)) ? 1 : 0;
-            s_out.write(o);
+#pragma HLS LOOP_TRIPCOUNT min=256 max=256
+                int i = idx / N, j = idx % N;
+                if (i >= rows || j >= cols) { busy++; idx++; continue; }
+                float v = C[r*CB_MAX + c][i][j] + info.bias[c*N + j];
+                ap_uint<W> dn = d;
+                dn.range(32*lane + 31, 32*lane) = f_to_u32(epilogue_op(v, act, alpha));
+                bool last = (i == rows-1) && (j == cols-1);
+                if (lane == WPB-1 || last) {
+                    axis_w<W> o;
+                    o.data = dn;
+                    o.keep = (ap_uint<W/8>)((1ull << (4*(lane+1))) - 1);
+                    o.strb = o.keep;
+                    o.user = 0;
+                    o.id   = 0;
+                    o.dest = 0;
+                    o.last = last ? 1 : 0;
+                    if (!S_OUT_WRITE_NB(s_out, o)) { stall++; continue; }
+                    d    = 0;
+                    lane = 0;
+                } else {
+                    d = dn;
+                    lane++;
+                }
+                busy++;
+                idx++;
+            }
+            tiles++;
         }
+        *last_job       = info.id;
+        *perf_send      = busy;
+        *perf_out_stall = stall;
+        *perf_tiles     = tiles;
+    }
+}
+
+// ==============================================================
+// Task-level pipeline over the C blocks x Ktiles K steps of one run:
+//   recv_frames --[A / B blocks, ping-pong]--> mac_frames
+//               --[C blocks, ping-pong]--> send_result
+// Each process loops over all tiles and frames itself, so recv of
+// frame k+1 runs while mac_frames works on frame k, and send of tile
+// t runs while mac_frames accumulates tile t+1 (no region restart per
+// frame or tile); a block is handed over by its lock, no copy. recv
+// decides how many blocks the run has (Ntiles or the job queue) and
+// the others stop at its end token
+// ==============================================================
+template<int W>
+static void gemm16_db_pipeline(
+    hls::stream<axis_w<W> >& s_in,
+    hls::stream<axis_w<W> >& s_out,
+    float A_panel[KT_MAX][N][N],
+    int jobs,
+    int Ntiles,
+    int Ktiles,
+    int cblock,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int *last_job,
+    uint32_t *perf_recv,
+    uint32_t *perf_in_stall,
+    uint32_t *perf_mac,
+    uint32_t *perf_mac_stall,
+    uint32_t *perf_send,
+    uint32_t *perf_out_stall,
+    uint32_t *perf_frames,
+    uint32_t *perf_tiles
+){
+#pragma HLS DATAFLOW
+    hls::stream_of_blocks<tiles_t>  a_blocks;     // depth 2 = ping-pong
+    hls::stream_of_blocks<tiles_t>  b_blocks;
+    hls::stream_of_blocks<ctiles_t> c_blocks;     // two C block accumulators
+    hls::stream<mac_job_t>          job_s;
+    hls::stream<tile_info_t>        info_s;
+#pragma HLS STREAM variable=job_s depth=4
+#pragma HLS STREAM variable=info_s depth=4
+
+    recv_frames<W>(s_in, a_blocks, b_blocks, job_s, info_s, jobs, Ntiles, Ktiles, cblock,
+                   a_mode, Jtiles, edge, epilogue, fmt, perf_recv, perf_in_stall);
+    mac_frames(a_blocks, b_blocks, job_s, c_blocks, A_panel, perf_mac, perf_mac_stall, perf_frames);
+    send_result<W>(c_blocks, info_s, s_out, alpha, last_job, perf_send, perf_out_stall, perf_tiles);
+}
+
+// ==============================================================
+// Double-Buffered GEMM16 accumulate, W-bit stream
+// (inlined into the top functions below, one instance per width)
+// ==============================================================
+template<int W>
+static void gemm16_accum_axis_db_w(
+    hls::stream<axis_w<W> >& s_in,
+    hls::stream<axis_w<W> >& s_out,
+    int Ktiles,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int Ntiles,
+    int cblock,
+    int jobs,
+    int *last_job,
+    uint32_t *perf_recv,
+    uint32_t *perf_in_stall,
+    uint32_t *perf_mac,
+    uint32_t *perf_mac_stall,
+    uint32_t *perf_send,
+    uint32_t *perf_out_stall,
+    uint32_t *perf_frames,
+    uint32_t *perf_tiles
+){
+#pragma HLS INLINE
+    // ---- On-chip A row panel, kept across invocations ----
+    static float A_panel[KT_MAX][N][N];
+#pragma HLS ARRAY_PARTITION variable=A_panel complete dim=3
+
+    // ---- CTRL protocol: the run shape is checked up front ----
+    // (job queue: per descriptor in recv_frames)
+    if (!jobs) {
+        if (Ktiles <= 0) return;
+        if (a_mode != AMODE_STREAM && Ktiles * cblk_dim(CBLK_ROWS(cblock)) > KT_MAX) return;
+        if (Ntiles < 1) Ntiles = 1;      // 0 / 1: one C block per run
     }
+
+    gemm16_db_pipeline<W>(s_in, s_out, A_panel, jobs, Ntiles, Ktiles, cblock, a_mode, Jtiles,
+                          edge, epilogue, alpha, fmt, last_job, perf_recv, perf_in_stall, perf_mac,
+                          perf_mac_stall, perf_send, perf_out_stall, perf_frames, perf_tiles);
 }
 
 // ==============================================================
-// Top: Double-Buffered GEMM16 accumulate
+// Top functions (same CTRL map, one per stream width)
 // ==============================================================
 void gemm16_accum_axis_db(
     hls::stream<axis_t>& s_in,
     hls::stream<axis_t>& s_out,
-    int Ktiles
+    int Ktiles,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int Ntiles,
+    int cblock,
+    int jobs,
+    int *last_job,
+    uint32_t *perf_recv,
+    uint32_t *perf_in_stall,
+    uint32_t *perf_mac,
+    uint32_t *perf_mac_stall,
+    uint32_t *perf_send,
+    uint32_t *perf_out_stall,
+    uint32_t *perf_frames,
+    uint32_t *perf_tiles
 ){
 #pragma HLS INTERFACE axis register_mode=both port=s_in
 #pragma HLS INTERFACE axis register_mode=both port=s_out
 #pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=a_mode bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Jtiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=edge bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=epilogue bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=alpha bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=fmt bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Ntiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=cblock bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=jobs bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=last_job bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_recv bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_in_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_send bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_out_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_frames bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_tiles bundle=CTRL
 #pragma HLS INTERFACE s_axilite port=return bundle=CTRL
 
-    if (Ktiles <= 0) return;
-
-    // ---- Ping-pong buffers for A and B ----
-    float A_buf[2][N][N];
-    float B_buf[2][N][N];
-    float C[N][N];
-
-#pragma HLS ARRAY_PARTITION variable=A_buf complete dim=3
-#pragma HLS ARRAY_PARTITION variable=B_buf complete dim=2
-#pragma HLS ARRAY_PARTITION variable=C     complete dim=2
-
-    // Clear accumulator
-    CLEAR_C:
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-#pragma HLS PIPELINE II=1
-            C[i][j] = 0.0f;
-        }
-    }
-
-    // ================================================================
-    // Double-buffering loop:
-    //
-    //  Iteration 0           : recv -> buf[0]
-    //  Iteration 1           : recv -> buf[1]  ||  compute buf[0]
-    //  Iteration 2           : recv -> buf[0]  ||  compute buf[1]
-    //  ...
-    //  Iteration Ktiles      :                     compute buf[last]
-    //
-    //  Total iterations = Ktiles + 1
-    //  - iteration 0:       recv only  (prolog)
-    //  - iteration 1..K-1:  recv || compute  (steady state)
-    //  - iteration Ktiles:  compute only (epilog)
-    // ================================================================
-    for (int phase = 0; phase < Ktiles + 1; phase++) {
-
-        int recv_buf = phase & 1;         // buffer index for receiving
-        int comp_buf = (phase - 1) & 1;   // buffer index for computing (previous tile)
-
-        bool do_recv    = (phase < Ktiles);
-        bool do_compute = (phase > 0);
-
-        // --- FIFOs to decouple stream read from BRAM write ---
-        hls::stream<float> fifo_A("fifo_A");
-        hls::stream<float> fifo_B("fifo_B");
-#pragma HLS STREAM variable=fifo_A depth=256
-#pragma HLS STREAM variable=fifo_B depth=256
-
-        // --- DATAFLOW region: recv and compute run concurrently ---
-#pragma HLS DATAFLOW
+    gemm16_accum_axis_db_w<32>(s_in, s_out, Ktiles, a_mode, Jtiles, edge, epilogue, alpha, fmt, Ntiles, cblock,
+                               jobs, last_job, perf_recv, perf_in_stall, perf_mac, perf_mac_stall,
+                               perf_send, perf_out_stall, perf_frames, perf_tiles);
+}
 
-        // Stage 1: Receive next tile from AXI-Stream into FIFOs
-        if (do_recv) {
-            recv_tile(s_in, fifo_A, fifo_B);
-        }
+void gemm16_accum_axis_db_x64(
+    hls::stream<axis_w<64> >& s_in,
+    hls::stream<axis_w<64> >& s_out,
+    int Ktiles,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int Ntiles,
+    int cblock,
+    int jobs,
+    int *last_job,
+    uint32_t *perf_recv,
+    uint32_t *perf_in_stall,
+    uint32_t *perf_mac,
+    uint32_t *perf_mac_stall,
+    uint32_t *perf_send,
+    uint32_t *perf_out_stall,
+    uint32_t *perf_frames,
+    uint32_t *perf_tiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=a_mode bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Jtiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=edge bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=epilogue bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=alpha bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=fmt bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Ntiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=cblock bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=jobs bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=last_job bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_recv bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_in_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_send bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_out_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_frames bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_tiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
 
-        // Stage 2: Load FIFOs into ping-pong BRAM
-        if (do_recv) {
-            load_tile(fifo_A, fifo_B, A_buf[recv_buf], B_buf[recv_buf]);
-        }
+    gemm16_accum_axis_db_w<64>(s_in, s_out, Ktiles, a_mode, Jtiles, edge, epilogue, alpha, fmt, Ntiles, cblock,
+                               jobs, last_job, perf_recv, perf_in_stall, perf_mac, perf_mac_stall,
+                               perf_send, perf_out_stall, perf_frames, perf_tiles);
+}
 
-        // Stage 3: MAC accumulate using previous tile's buffer
-        if (do_compute) {
-            mac_tile(A_buf[comp_buf], B_buf[comp_buf], C);
-        }
-    }
+void gemm16_accum_axis_db_x128(
+    hls::stream<axis_w<128> >& s_in,
+    hls::stream<axis_w<128> >& s_out,
+    int Ktiles,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int Ntiles,
+    int cblock,
+    int jobs,
+    int *last_job,
+    uint32_t *perf_recv,
+    uint32_t *perf_in_stall,
+    uint32_t *perf_mac,
+    uint32_t *perf_mac_stall,
+    uint32_t *perf_send,
+    uint32_t *perf_out_stall,
+    uint32_t *perf_frames,
+    uint32_t *perf_tiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=a_mode bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Jtiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=edge bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=epilogue bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=alpha bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=fmt bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Ntiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=cblock bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=jobs bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=last_job bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_recv bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_in_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_mac_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_send bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_out_stall bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_frames bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=perf_tiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
 
-    // ---- Send result ----
-    send_result(C, s_out);
+    gemm16_accum_axis_db_w<128>(s_in, s_out, Ktiles, a_mode, Jtiles, edge, epilogue, alpha, fmt, Ntiles, cblock,
+                               jobs, last_job, perf_recv, perf_in_stall, perf_mac, perf_mac_stall,
+                               perf_send, perf_out_stall, perf_frames, perf_tiles);
 }
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cmath>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 #include <hls_stream.h>
 #include <ap_axi_sdata.h>
 #include <ap_int.h>
@@ -13,12 +15,65 @@ const int Ktiles_tb = 3;
 
 typedef ap_axiu<32,0,0,0> axis_t;
 
-// DUT prototype
-void gemm16_accum_axis(
+// a_mode (CTRL)
+#define AMODE_STREAM 0
+#define AMODE_LOAD   1
+#define AMODE_REUSE  2
+#define AMODE_ROW    3
+
+// epilogue (CTRL)
+#define EPI_NONE     0
+#define EPI_RELU     1
+#define EPI_RELU6    2
+#define EPI_LEAKY    3
+#define EPI_BIAS     0x10
+
+// fmt (CTRL)
+#define FMT_FP32     0
+#define FMT_FP16     1
+#define FMT_BF16     2
+
+// DUT prototypes (32 / 64 / 128-bit stream)
+void gemm16_accum_axis_db(
     hls::stream<axis_t>& s_in,
     hls::stream<axis_t>& s_out,
-    int Ktiles
+    int Ktiles,
+    int a_mode,
+    int Jtiles,
+    int edge,
+    int epilogue,
+    float alpha,
+    int fmt,
+    int Ntiles,
+    int cblock,
+    int jobs,
+    int *last_job,
+    uint32_t *perf_recv, uint32_t *perf_in_stall, uint32_t *perf_mac, uint32_t *perf_mac_stall,
+    uint32_t *perf_send, uint32_t *perf_out_stall, uint32_t *perf_frames, uint32_t *perf_tiles
+);
+void gemm16_accum_axis_db_x64(
+    hls::stream<ap_axiu<64,0,0,0> >& s_in,
+    hls::stream<ap_axiu<64,0,0,0> >& s_out,
+    int Ktiles, int a_mode, int Jtiles, int edge, int epilogue, float alpha, int fmt, int Ntiles,
+    int cblock, int jobs, int *last_job,
+    uint32_t *perf_recv, uint32_t *perf_in_stall, uint32_t *perf_mac, uint32_t *perf_mac_stall,
+    uint32_t *perf_send, uint32_t *perf_out_stall, uint32_t *perf_frames, uint32_t *perf_tiles
 );
+void gemm16_accum_axis_db_x128(
+    hls::stream<ap_axiu<128,0,0,0> >& s_in,
+    hls::stream<ap_axiu<128,0,0,0> >& s_out,
+    int Ktiles, int a_mode, int Jtiles, int edge, int epilogue, float alpha, int fmt, int Ntiles,
+    int cblock, int jobs, int *last_job,
+    uint32_t *perf_recv, uint32_t *perf_in_stall, uint32_t *perf_mac, uint32_t *perf_mac_stall,
+    uint32_t *perf_send, uint32_t *perf_out_stall, uint32_t *perf_frames, uint32_t *perf_tiles
+);
+
+static int last_job_tb;    // last_job output of the DUT calls
+
+// perf counter outputs: recv, in_stall, mac, mac_stall, send, out_stall, frames, tiles
+#define PERF_NUM 8
+static uint32_t perf_tb[PERF_NUM];
+#define PERF_ARGS(p) &p[0], &p[1], &p[2], &p[3], &p[4], &p[5], &p[6], &p[7]
 
 // =====================================================
 // bit cast helpers (CSIM-safe)
@@ -50,6 +105,871 @@ void gemm16_sw(float A[N][N], float B[N][N], float C[N][N])
         }
 }
 
+// =====================================================
+// A-panel reuse helpers
+// =====================================================
+static void push_tile(hls::stream<axis_t>& s, float M[N][N], bool last_at_end)
+{
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++){
+            axis_t w;
+            w.data = f2u(M[i][j]);
+            w.keep = 0xF;
+            w.strb = 0xF;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = (last_at_end && i==N-1 && j==N-1) ? 1 : 0;
+            s.write(w);
+        }
+}
+
+// C(bj) = sum_k A[k] * B[bj][k]
+static void ref_tile(float A[Ktiles_tb][N][N], float B[Ktiles_tb][N][N], float C[N][N])
+{
+    float Ctmp[N][N];
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++)
+            C[i][j] = 0;
+    for(int kt=0; kt<Ktiles_tb; kt++){
+        gemm16_sw(A[kt],B[kt],Ctmp);
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++)
+                C[i][j] += Ctmp[i][j];
+    }
+}
+
+static float check_tile(hls::stream<axis_t>& s_out, float Cref[N][N])
+{
+    float max_err = 0;
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++){
+            float e = fabs(Cref[i][j] - u2f(s_out.read().data));
+            if(e > max_err) max_err = e;
+        }
+    return max_err;
+}
+
+// Row bi = one A panel, Jt output tiles (bj) with different B columns.
+// Pass 1: explicit LOAD (bj=0) / REUSE (bj>0)
+// Pass 2: AMODE_ROW with Jtiles=Jt, twice (two rows, counter wraps)
+static bool test_a_panel_reuse()
+{
+    const int Jt = 3;
+    static float A[2][Ktiles_tb][N][N];
+    static float B[Jt][Ktiles_tb][N][N];
+    static float Cref[2][Jt][N][N];
+
+    for(int r=0; r<2; r++)
+        for(int kt=0; kt<Ktiles_tb; kt++)
+            for(int i=0;i<N;i++)
+                for(int j=0;j<N;j++)
+                    A[r][kt][i][j] = i*0.5f - j*0.1f + kt + r*0.7f;
+    for(int bj=0; bj<Jt; bj++)
+        for(int kt=0; kt<Ktiles_tb; kt++)
+            for(int i=0;i<N;i++)
+                for(int j=0;j<N;j++)
+                    B[bj][kt][i][j] = j*0.3f + i*0.2f - kt*0.4f + bj;
+    for(int r=0; r<2; r++)
+        for(int bj=0; bj<Jt; bj++)
+            ref_tile(A[r], B[bj], Cref[r][bj]);
+
+    float max_err = 0;
+    int   words   = 0;
+
+    // ---- Pass 1: explicit LOAD / REUSE ----
+    for(int bj=0; bj<Jt; bj++){
+        hls::stream<axis_t> s_in, s_out;
+        for(int kt=0; kt<Ktiles_tb; kt++){
+            if(bj == 0) push_tile(s_in, A[0][kt], false);
+            push_tile(s_in, B[bj][kt], true);
+        }
+        words += s_in.size();
+        gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, bj == 0 ? AMODE_LOAD : AMODE_REUSE, 0, 0, EPI_NONE, 0.0f, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+        float e = check_tile(s_out, Cref[0][bj]);
+        if(e > max_err) max_err = e;
+        if(!s_in.empty()) { std::cout << "REUSE: input left over\n"; return false; }
+    }
+
+    // ---- Pass 2: AMODE_ROW over two rows ----
+    for(int r=0; r<2; r++)
+        for(int bj=0; bj<Jt; bj++){
+            hls::stream<axis_t> s_in, s_out;
+            for(int kt=0; kt<Ktiles_tb; kt++){
+                if(bj == 0) push_tile(s_in, A[r][kt], false);
+                push_tile(s_in, B[bj][kt], true);
+            }
+            gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, AMODE_ROW, Jt, 0, EPI_NONE, 0.0f, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+            float e = check_tile(s_out, Cref[r][bj]);
+            if(e > max_err) max_err = e;
+            if(!s_in.empty()) { std::cout << "ROW: input left over\n"; return false; }
+        }
+
+    std::cout << "A-panel reuse: row input words = " << words
+              << " (stream mode " << Jt*Ktiles_tb*512 << ")"
+              << ", max error = " << max_err << std::endl;
+    return max_err < EPS;
+}
+
+// =====================================================
+// Edge tiles: rows x cols C tile, last K tile kv_last wide
+// =====================================================
+static void push_words(hls::stream<axis_t>& s, float M[N][N], int r, int c)
+{
+    for(int i=0;i<r;i++)
+        for(int j=0;j<c;j++){
+            axis_t w;
+            w.data = f2u(M[i][j]);
+            w.keep = 0xF;
+            w.strb = 0xF;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = 0;
+            s.write(w);
+        }
+}
+
+static void push_hdr(hls::stream<axis_t>& s, int rows, int cols, int klast)
+{
+    axis_t w;
+    w.data = (ap_uint<32>)(rows | (cols << 8) | (klast << 16));
+    w.keep = 0xF;
+    w.strb = 0xF;
+    w.user = 0;
+    w.id   = 0;
+    w.dest = 0;
+    w.last = 1;
+    s.write(w);
+}
+
+// STREAM run, then LOAD / REUSE runs on the same (padded) A panel
+static bool test_edge_tiles()
+{
+    const int rows = 5, cols = 11, klast = 7;
+    static float A[Ktiles_tb][N][N];
+    static float B[2][Ktiles_tb][N][N];
+    bool ok = true;
+    float max_err = 0;
+
+    // Garbage outside the valid region: must never reach the MAC
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++){
+                int kv = (kt == Ktiles_tb-1) ? klast : N;
+                A[kt][i][j] = (i < rows && j < kv) ? i*0.5f - j*0.1f + kt : 1e6f;
+                for(int b=0; b<2; b++)
+                    B[b][kt][i][j] = (i < kv && j < cols) ? j*0.3f + i*0.2f - kt + b : -1e6f;
+            }
+
+    const int modes[3] = { AMODE_STREAM, AMODE_LOAD, AMODE_REUSE };
+    for(int r=0; r<3; r++){
+        int b = (r == 2) ? 1 : 0;
+        hls::stream<axis_t> s_in, s_out;
+        push_hdr(s_in, rows, cols, klast);
+        for(int kt=0; kt<Ktiles_tb; kt++){
+            int kv = (kt == Ktiles_tb-1) ? klast : N;
+            if(modes[r] != AMODE_REUSE) push_words(s_in, A[kt], rows, kv);
+            push_words(s_in, B[b][kt], kv, cols);
+        }
+        gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, modes[r], 0, 1, EPI_NONE, 0.0f, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+
+        if(!s_in.empty() || (int)s_out.size() != rows*cols){
+            std::cout << "EDGE: stream size mismatch (mode " << modes[r] << ")\n";
+            return false;
+        }
+        for(int i=0;i<rows;i++)
+            for(int j=0;j<cols;j++){
+                float ref = 0;
+                for(int kt=0; kt<Ktiles_tb; kt++){
+                    int kv = (kt == Ktiles_tb-1) ? klast : N;
+                    for(int k=0; k<kv; k++)
+                        ref += A[kt][i][k] * B[b][kt][k][j];
+                }
+                axis_t o = s_out.read();
+                float e = fabs(ref - u2f(o.data));
+                if(e > max_err) max_err = e;
+                if((int)o.last != (int)(i==rows-1 && j==cols-1)) ok = false;
+            }
+    }
+
+    std::cout << "Edge tile " << rows << "x" << cols << " (k_last " << klast
+              << "): max error = " << max_err << (ok ? "" : ", TLAST mismatch") << std::endl;
+    return ok && max_err < EPS;
+}
+
+// =====================================================
+// Fused epilogue: act(C + bias)
+// =====================================================
+static float epi_ref(float v, int act, float alpha)
+{
+    switch(act){
+    case EPI_RELU:  return v > 0 ? v : 0;
+    case EPI_RELU6: return v > 6 ? 6 : (v > 0 ? v : 0);
+    case EPI_LEAKY: return v > 0 ? v : v*alpha;
+    default:        return v;
+    }
+}
+
+// Every activation with a bias on a full tile, then leaky + bias on a
+// 5 x 11 edge tile (bias = cols words after the header)
+static bool test_epilogue()
+{
+    static float A[Ktiles_tb][N][N];
+    static float B[Ktiles_tb][N][N];
+    float bias[N];
+    const float alpha = 0.125f;
+    bool ok = true;
+    float max_err = 0;
+
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++){
+                A[kt][i][j] = 0.05f*(i - 8) + 0.01f*j;
+                B[kt][i][j] = 0.03f*(j - 7) - 0.02f*i + kt*0.01f;
+            }
+    for(int j=0;j<N;j++) bias[j] = 1.0f*(j - 8);     // spans < 0 .. > 6
+
+    float Cref[N][N];
+    ref_tile(A, B, Cref);
+
+    for(int t=0; t<5; t++){
+        int act   = (t < 4) ? t : EPI_LEAKY;
+        bool edge = (t == 4);
+        int rows  = edge ? 5 : N, cols = edge ? 11 : N;
+
+        hls::stream<axis_t> s_in, s_out;
+        if(edge) push_hdr(s_in, rows, cols, N);
+        for(int j=0;j<cols;j++){
+            axis_t w;
+            w.data = f2u(bias[j]);
+            w.keep = 0xF;
+            w.strb = 0xF;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = (j == cols-1) ? 1 : 0;
+            s_in.write(w);
+        }
+        for(int kt=0; kt<Ktiles_tb; kt++){
+            push_words(s_in, A[kt], rows, N);
+            push_words(s_in, B[kt], N, cols);
+        }
+        gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, AMODE_STREAM, 0, edge,
+                             act | EPI_BIAS, alpha, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+
+        if(!s_in.empty() || (int)s_out.size() != rows*cols){
+            std::cout << "EPILOGUE: stream size mismatch (act " << act << ")\n";
+            return false;
+        }
+        for(int i=0;i<rows;i++)
+            for(int j=0;j<cols;j++){
+                axis_t o = s_out.read();
+                float e = fabs(epi_ref(Cref[i][j] + bias[j], act, alpha) - u2f(o.data));
+                if(e > max_err) max_err = e;
+                if((int)o.last != (int)(i==rows-1 && j==cols-1)) ok = false;
+            }
+    }
+
+    std::cout << "Epilogue (bias + none/relu/relu6/leaky): max error = " << max_err
+              << (ok ? "" : ", TLAST mismatch") << std::endl;
+    return ok && max_err < EPS;
+}
+
+// =====================================================
+// fp16 / bf16 input: two elements per word
+// =====================================================
+// float -> fp16 / bf16 bits (test values are exactly representable)
+static uint32_t f2h(float f, int fmt)
+{
+    uint32_t u = f2u(f).to_uint();
+    if(fmt == FMT_BF16) return u >> 16;
+    uint32_t sign = (u >> 16) & 0x8000;
+    float a = fabs(f);
+    if(a == 0.0f) return sign;
+    if(a < 6.103515625e-05f)                          // fp16 subnormal (< 2^-14)
+        return sign | (uint32_t)(a * 16777216.0f);    // man * 2^-24
+    int e = (int)((u >> 23) & 0xFF) - 127 + 15;
+    return sign | (e << 10) | ((u >> 13) & 0x3FF);
+}
+
+// r x c elements, a row of c elements = ceil(c/2) words
+static void push_half(hls::stream<axis_t>& s, float M[N][N], int r, int c, int fmt)
+{
+    for(int i=0;i<r;i++)
+        for(int j=0;j<c;j+=2){
+            uint32_t lo = f2h(M[i][j], fmt);
+            uint32_t hi = (j+1 < c) ? f2h(M[i][j+1], fmt) : 0;
+            axis_t w;
+            w.data = (ap_uint<32>)(lo | (hi << 16));
+            w.keep = 0xF;
+            w.strb = 0xF;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = 0;
+            s.write(w);
+        }
+}
+
+// Per format: full-tile STREAM run (incl. an fp16 subnormal), then
+// LOAD / REUSE runs on a 6 x 10 edge tile with k_last 4
+static bool test_half_formats()
+{
+    static float A[Ktiles_tb][N][N];
+    static float B[Ktiles_tb][N][N];
+    bool ok = true;
+    float max_err = 0;
+    int words_full = 0;
+
+    // multiples of 1/8 in [-2, 2]: exact in fp16 and bf16
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++){
+                A[kt][i][j] = 0.25f*(i - 8) + 0.125f*((j + kt) % 8);
+                B[kt][i][j] = 0.125f*(j - 7) - 0.25f*((i + kt) % 4);
+            }
+
+    const int fmts[2] = { FMT_FP16, FMT_BF16 };
+    for(int f=0; f<2; f++){
+        int fmt = fmts[f];
+        A[0][0][0] = (fmt == FMT_FP16) ? 9.5367431640625e-07f : 0.0f;   // 2^-20: fp16 subnormal
+
+        // full tile, STREAM
+        {
+            float Cref[N][N];
+            ref_tile(A, B, Cref);
+            hls::stream<axis_t> s_in, s_out;
+            for(int kt=0; kt<Ktiles_tb; kt++){
+                push_half(s_in, A[kt], N, N, fmt);
+                push_half(s_in, B[kt], N, N, fmt);
+            }
+            words_full = s_in.size();
+            gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, AMODE_STREAM, 0, 0, EPI_NONE, 0.0f, fmt, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+            if(!s_in.empty() || (int)s_out.size() != N*N){
+                std::cout << "HALF: stream size mismatch (fmt " << fmt << ")\n";
+                return false;
+            }
+            float e = check_tile(s_out, Cref);
+            if(e > max_err) max_err = e;
+        }
+
+        // edge tile, LOAD then REUSE (A panel holds widened values)
+        const int rows = 6, cols = 10, klast = 4;
+        const int modes[2] = { AMODE_LOAD, AMODE_REUSE };
+        for(int r=0; r<2; r++){
+            hls::stream<axis_t> s_in, s_out;
+            push_hdr(s_in, rows, cols, klast);
+            for(int kt=0; kt<Ktiles_tb; kt++){
+                int kv = (kt == Ktiles_tb-1) ? klast : N;
+                if(modes[r] == AMODE_LOAD) push_half(s_in, A[kt], rows, kv, fmt);
+                push_half(s_in, B[kt], kv, cols, fmt);
+            }
+            gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, modes[r], 0, 1, EPI_NONE, 0.0f, fmt, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+            if(!s_in.empty() || (int)s_out.size() != rows*cols){
+                std::cout << "HALF: edge stream size mismatch (fmt " << fmt << ")\n";
+                return false;
+            }
+            for(int i=0;i<rows;i++)
+                for(int j=0;j<cols;j++){
+                    float ref = 0;
+                    for(int kt=0; kt<Ktiles_tb; kt++){
+                        int kv = (kt == Ktiles_tb-1) ? klast : N;
+                        for(int k=0; k<kv; k++)
+                            ref += A[kt][i][k] * B[kt][k][j];
+                    }
+                    axis_t o = s_out.read();
+                    float e = fabs(ref - u2f(o.data));
+                    if(e > max_err) max_err = e;
+                    if((int)o.last != (int)(i==rows-1 && j==cols-1)) ok = false;
+                }
+        }
+    }
+
+    std::cout << "fp16 / bf16 input: " << words_full << " words per run (fp32: "
+              << Ktiles_tb*2*N*N << "), max error = " << max_err
+              << (ok ? "" : ", TLAST mismatch") << std::endl;
+    return ok && words_full == Ktiles_tb*N*N && max_err < EPS;
+}
+
+// =====================================================
+// 64 / 128-bit streams: the 32-bit runs cut into segments
+// (one DMA transfer each), every segment starting on a new beat
+// =====================================================
+typedef std::vector<uint32_t> seg_t;
+
+static seg_t take_seg(hls::stream<axis_t>& s)
+{
+    seg_t v;
+    while(!s.empty()) v.push_back(s.read().data.to_uint());
+    return v;
+}
+
+static void dut(hls::stream<ap_axiu<32,0,0,0> >& i, hls::stream<ap_axiu<32,0,0,0> >& o,
+                int kt, int am, int ed, int epi, float al, int fmt)
+{ gemm16_accum_axis_db(i, o, kt, am, 0, ed, epi, al, fmt, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb)); }
+static void dut(hls::stream<ap_axiu<64,0,0,0> >& i, hls::stream<ap_axiu<64,0,0,0> >& o,
+                int kt, int am, int ed, int epi, float al, int fmt)
+{ gemm16_accum_axis_db_x64(i, o, kt, am, 0, ed, epi, al, fmt, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb)); }
+static void dut(hls::stream<ap_axiu<128,0,0,0> >& i, hls::stream<ap_axiu<128,0,0,0> >& o,
+                int kt, int am, int ed, int epi, float al, int fmt)
+{ gemm16_accum_axis_db_x128(i, o, kt, am, 0, ed, epi, al, fmt, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb)); }
+
+// Pack segments into W-bit beats, run, unpack C (TKEEP / TLAST checked)
+template<int W>
+static bool run_wide(const std::vector<seg_t>& segs, int a_mode, int edge, int epi, float alpha,
+                     int fmt, seg_t& out, int *beats_in)
+{
+    const int WPB = W / 32;
+    hls::stream<ap_axiu<W,0,0,0> > s_in, s_out;
+    *beats_in = 0;
+    for(size_t g=0; g<segs.size(); g++)
+        for(size_t w=0; w<segs[g].size(); w+=WPB){
+            ap_axiu<W,0,0,0> b;
+            b.data = 0;
+            int n = 0;
+            for(int l=0; l<WPB && w+l<segs[g].size(); l++, n++)
+                b.data.range(32*l+31, 32*l) = segs[g][w+l];
+            b.keep = (ap_uint<W/8>)((1ull << (4*n)) - 1);
+            b.strb = b.keep;
+            b.user = 0;
+            b.id   = 0;
+            b.dest = 0;
+            b.last = (w + WPB >= segs[g].size()) ? 1 : 0;
+            s_in.write(b);
+            (*beats_in)++;
+        }
+
+    dut(s_in, s_out, Ktiles_tb, a_mode, edge, epi, alpha, fmt);
+
+    bool ok = s_in.empty();
+    out.clear();
+    while(!s_out.empty()){
+        ap_axiu<W,0,0,0> b = s_out.read();
+        int n = 0;
+        while(n < WPB && ((b.keep.to_uint64() >> (4*n)) & 0xF) == 0xF) n++;
+        if(b.keep.to_uint64() != ((1ull << (4*n)) - 1) || n == 0) ok = false;
+        if((int)b.last != (s_out.empty() ? 1 : 0)) ok = false;
+        for(int l=0; l<n; l++) out.push_back(b.data.range(32*l+31, 32*l).to_uint());
+    }
+    return ok;
+}
+
+// Full fp32 tile with bias + ReLU (STREAM), 5 x 11 edge tile with
+// k_last 7 and leaky + bias (LOAD, REUSE), 6 x 10 fp16 edge tile:
+// C must match the 32-bit IP bit for bit, with fewer input beats
+static bool test_wide_streams()
+{
+    static float A[Ktiles_tb][N][N];
+    static float B[Ktiles_tb][N][N];
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++){
+                A[kt][i][j] = 0.25f*(i - 8) + 0.125f*((j + kt) % 8);
+                B[kt][i][j] = 0.125f*(j - 7) - 0.25f*((i + kt) % 4);
+            }
+    static float bias[N][N];        // row 0 = column bias
+    for(int j=0;j<N;j++) bias[0][j] = 0.5f*(j % 5) - 1.0f;
+
+    struct run_t { int rows, cols, klast, a_mode, edge, epi, fmt; };
+    const run_t runs[4] = {
+        { N, N,  N, AMODE_STREAM, 0, EPI_RELU  | EPI_BIAS, FMT_FP32 },
+        { 5, 11, 7, AMODE_LOAD,   1, EPI_LEAKY | EPI_BIAS, FMT_FP32 },
+        { 5, 11, 7, AMODE_REUSE,  1, EPI_LEAKY | EPI_BIAS, FMT_FP32 },
+        { 6, 10, 4, AMODE_STREAM, 1, EPI_NONE,             FMT_FP16 },
+    };
+
+    bool ok = true;
+    int beats[3] = { 0, 0, 0 };     // full fp32 run, per width
+    for(int r=0; r<4; r++){
+        const run_t& R = runs[r];
+        std::vector<seg_t> segs;
+        hls::stream<axis_t> s;
+        if(R.edge){ push_hdr(s, R.rows, R.cols, R.klast); segs.push_back(take_seg(s)); }
+        if(R.epi & EPI_BIAS){
+            push_words(s, bias, 1, R.cols);
+            segs.push_back(take_seg(s));
+        }
+        for(int kt=0; kt<Ktiles_tb; kt++){
+            int kv = (kt == Ktiles_tb-1) ? R.klast : N;
+            if(R.a_mode != AMODE_REUSE){
+                if(R.fmt == FMT_FP32) push_words(s, A[kt], R.rows, kv);
+                else                  push_half(s, A[kt], R.rows, kv, R.fmt);
+                segs.push_back(take_seg(s));
+            }
+            if(R.fmt == FMT_FP32) push_words(s, B[kt], kv, R.cols);
+            else                  push_half(s, B[kt], kv, R.cols, R.fmt);
+            segs.push_back(take_seg(s));
+        }
+
+        seg_t c32, c64, c128;
+        int b32, b64, b128;
+        ok &= run_wide<32>(segs, R.a_mode, R.edge, R.epi, 0.125f, R.fmt, c32, &b32);
+        ok &= run_wide<64>(segs, R.a_mode, R.edge, R.epi, 0.125f, R.fmt, c64, &b64);
+        ok &= run_wide<128>(segs, R.a_mode, R.edge, R.epi, 0.125f, R.fmt, c128, &b128);
+        if((int)c32.size() != R.rows*R.cols || c64 != c32 || c128 != c32){
+            std::cout << "WIDE: run " << r << " output mismatch\n";
+            ok = false;
+        }
+        if(r == 0){ beats[0] = b32; beats[1] = b64; beats[2] = b128; }
+    }
+
+    std::cout << "64 / 128-bit stream: " << beats[1] << " / " << beats[2]
+              << " input beats per run (32-bit: " << beats[0] << "), C bit-exact"
+              << (ok ? "" : " FAILED") << std::endl;
+    return ok && beats[1]*2 == beats[0] && beats[2]*4 == beats[0];
+}
+
+// =====================================================
+// Ntiles: a whole 37 x 27 x 40 C (3 x 2 tiles, edge rows / cols /
+// k_last, bias + leaky, AMODE_ROW) in one run, vs. one run per tile
+// =====================================================
+static bool test_multi_tile()
+{
+    const int M = 37, Nc = 27, K = 40;
+    const int MT = (M + N-1) / N, NT = (Nc + N-1) / N;
+    const int klast = K - (Ktiles_tb-1)*N;
+    static float A[48][48], B[48][32];
+    float bias[N][N];
+    for(int i=0;i<M;i++)  for(int k=0;k<K;k++)  A[i][k] = 0.25f*((i*7 + k*3) % 11) - 1.0f;
+    for(int k=0;k<K;k++)  for(int j=0;j<Nc;j++) B[k][j] = 0.125f*((k*5 + j) % 13) - 0.75f;
+    for(int bj=0; bj<NT; bj++)
+        for(int j=0;j<N;j++) bias[bj][j] = 0.5f*((bj*N + j) % 7) - 1.5f;
+
+    // input of one output tile: header, bias, frames (A only when bj == 0)
+    float T[N][N];
+    hls::stream<axis_t> s_all, s_one[6];
+    for(int bi=0; bi<MT; bi++)
+        for(int bj=0; bj<NT; bj++){
+            int rows = (bi == MT-1) ? M - bi*N : N;
+            int cols = (bj == NT-1) ? Nc - bj*N : N;
+            for(int pass=0; pass<2; pass++){
+                hls::stream<axis_t>& s = pass ? s_one[bi*NT + bj] : s_all;
+                push_hdr(s, rows, cols, klast);
+                push_words(s, bias + bj, 1, cols);
+                for(int kt=0; kt<Ktiles_tb; kt++){
+                    int kv = (kt == Ktiles_tb-1) ? klast : N;
+                    if(bj == 0){
+                        for(int i=0;i<rows;i++) for(int k=0;k<kv;k++) T[i][k] = A[bi*N + i][kt*N + k];
+                        push_words(s, T, rows, kv);
+                    }
+                    for(int k=0;k<kv;k++) for(int j=0;j<cols;j++) T[k][j] = B[kt*N + k][bj*N + j];
+                    push_words(s, T, kv, cols);
+                }
+            }
+        }
+
+    hls::stream<axis_t> o_all, o_one;
+    gemm16_accum_axis_db(s_all, o_all, Ktiles_tb, AMODE_ROW, NT, 1, EPI_LEAKY | EPI_BIAS, 0.125f,
+                         FMT_FP32, MT*NT, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+    for(int t=0; t<MT*NT; t++)
+        gemm16_accum_axis_db(s_one[t], o_one, Ktiles_tb, AMODE_ROW, NT, 1, EPI_LEAKY | EPI_BIAS, 0.125f,
+                             FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
+
+    bool ok = s_all.empty() && o_all.size() == o_one.size() && o_all.size() == (size_t)M*Nc;
+    float max_err = 0;
+    int tlast = 0;
+    for(int bi=0; bi<MT && ok; bi++)
+        for(int bj=0; bj<NT; bj++){
+            int rows = (bi == MT-1) ? M - bi*N : N;
+            int cols = (bj == NT-1) ? Nc - bj*N : N;
+            for(int i=0;i<rows;i++)
+                for(int j=0;j<cols;j++){
+                    float ref = bias[bj][j];
+                    for(int k=0;k<K;k++) ref += A[bi*N + i][k] * B[k][bj*N + j];
+                    ref = epi_ref(ref, EPI_LEAKY, 0.125f);
+                    axis_t a = o_all.read(), b = o_one.read();
+                    if(a.data != b.data || a.last != b.last) ok = false;
+                    if((int)a.last != (int)(i==rows-1 && j==cols-1)) ok = false;
+                    tlast += a.last;
+                    float e = fabs(ref - u2f(a.data));
+                    if(e > max_err) max_err = e;
+                }
+        }
+
+    std::cout << "Ntiles=" << MT*NT << " run (" << M << "x" << Nc << "x" << K
+              << "): " << tlast << " TLASTs, max error = " << max_err
+              << (ok ? ", same as per-tile runs" : ", MISMATCH vs per-tile runs") << std::endl;
+    return ok && tlast == MT*NT && max_err < EPS;
+}
+
+// =====================================================
+// Job queue: descriptor word 0 (Ktiles, a_mode, edge, fmt, epilogue,
+// cblock), word 1 = id, word 2 = edge header (with edge only)
+// =====================================================
+static uint32_t job_d0(int kt, int a_mode, int edge, int fmt, int epi, int cblock)
+{
+    return (uint32_t)(kt | (a_mode << 8) | (edge << 10) | (fmt << 11) | (epi << 16) | (cblock << 24));
+}
+
+static void push_job(hls::stream<axis_t>& s, uint32_t d0, int id, int rows, int cols, int klast)
+{
+    uint32_t d[3] = { d0, (uint32_t)id, (uint32_t)(rows | (cols << 8) | (klast << 16)) };
+    int nd = (d0 & 0xFF) ? 2 + ((d0 >> 10) & 1) : 1;
+    for(int i=0;i<nd;i++){
+        axis_t w;
+        w.data = (ap_uint<32>)d[i];
+        w.keep = 0xF; w.strb = 0xF; w.user = 0; w.id = 0; w.dest = 0;
+        w.last = (i == nd-1);
+        s.write(w);
+    }
+}
+
+// =====================================================
+// cblock: the 37 x 45 x 40 GEMM as C blocks of br x bc tiles in one
+// Ntiles run (edge blocks, bias + leaky), 2x2 with AMODE_ROW and 2x1
+// with AMODE_STREAM; input words per C tile vs. 1x1. jobs = 1: the
+// same blocks as a job queue (ids 100.., ROW as LOAD / REUSE per job,
+// CTRL Ktiles / Ntiles / cblock left 0)
+// =====================================================
+static bool run_cblock(int br, int bc, int a_mode, int *words_in, int jobs = 0)
+{
+    const int M = 37, Nc = 45, K = 40;
+    const int BH = br*N, BW = bc*N;
+    const int MB = (M + BH-1) / BH, NB = (Nc + BW-1) / BW;
+    const int klast = K - (Ktiles_tb-1)*N;
+    static float A[48][48], B[48][48], bias[1][48];
+    for(int i=0;i<M;i++)  for(int k=0;k<K;k++)  A[i][k] = 0.25f*((i*7 + k*3) % 11) - 1.0f;
+    for(int k=0;k<K;k++)  for(int j=0;j<Nc;j++) B[k][j] = 0.125f*((k*5 + j) % 13) - 0.75f;
+    for(int j=0;j<Nc;j++) bias[0][j] = 0.5f*(j % 7) - 1.5f;
+
+    float T[N][N];
+    hls::stream<axis_t> s_in, s_out;
+    for(int bi=0; bi<MB; bi++)
+        for(int bj=0; bj<NB; bj++){
+            int rows = std::min(BH, M - bi*BH), cols = std::min(BW, Nc - bj*BW);
+            if(jobs){
+                int am = (a_mode == AMODE_ROW) ? (bj == 0 ? AMODE_LOAD : AMODE_REUSE) : a_mode;
+                push_job(s_in, job_d0(Ktiles_tb, am, 1, FMT_FP32, EPI_LEAKY | EPI_BIAS, br | (bc << 4)),
+                         100 + bi*NB + bj, rows, cols, klast);
+            } else {
+                push_hdr(s_in, rows, cols, klast);
+            }
+            for(int j=0;j<cols;j++){
+                axis_t w;
+                w.data = f2u(bias[0][bj*BW + j]);
+                w.keep = 0xF; w.strb = 0xF; w.user = 0; w.id = 0; w.dest = 0;
+                w.last = (j == cols-1);
+                s_in.write(w);
+            }
+            bool send_a = (a_mode != AMODE_ROW) || bj == 0;     // ROW: LOAD on the first block of a row
+            for(int kt=0; kt<Ktiles_tb; kt++){
+                int kv = (kt == Ktiles_tb-1) ? klast : N;
+                for(int r=0; r<br && send_a; r++){
+                    int h = std::max(0, std::min(N, rows - r*N));
+                    for(int i=0;i<h;i++) for(int k=0;k<kv;k++) T[i][k] = A[bi*BH + r*N + i][kt*N + k];
+                    push_words(s_in, T, h, kv);
+                }
+                for(int c=0; c<bc; c++){
+                    int w = std::max(0, std::min(N, cols - c*N));
+                    for(int k=0;k<kv;k++) for(int j=0;j<w;j++) T[k][j] = B[kt*N + k][bj*BW + c*N + j];
+                    push_words(s_in, T, kv, w);
+                }
+            }
+        }
+    if(jobs) push_job(s_in, 0, 0, 0, 0, 0);       // end of queue
+    *words_in = (int)s_in.size();
+
+    last_job_tb = -1;
+    if(jobs)
+        gemm16_accum_axis_db(s_in, s_out, 0, AMODE_STREAM, NB, 0, EPI_NONE, 0.125f,
+                             FMT_FP32, 0, 0, 1, &last_job_tb, PERF_ARGS(perf_tb));
+    else
+        gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, a_mode, NB, 1, EPI_LEAKY | EPI_BIAS, 0.125f,
+                             FMT_FP32, MB*NB, br | (bc << 4), 0, &last_job_tb, PERF_ARGS(perf_tb));
+
+    bool ok = s_in.empty() && (int)s_out.size() == M*Nc;
+    ok &= (last_job_tb == (jobs ? 100 : 0) + MB*NB-1);
+    int tlast = 0, ntiles = 0;
+    for(int bi=0; bi<MB && ok; bi++)
+        for(int bj=0; bj<NB; bj++)
+            for(int r=0; r<br; r++)
+                for(int c=0; c<bc; c++){
+                    int i0 = bi*BH + r*N, j0 = bj*BW + c*N;
+                    int h = std::min(N, M - i0), w = std::min(N, Nc - j0);
+                    if(h <= 0 || w <= 0) continue;
+                    ntiles++;
+                    for(int i=0;i<h;i++)
+                        for(int j=0;j<w;j++){
+                            float ref = bias[0][j0 + j];
+                            for(int k=0;k<K;k++) ref += A[i0 + i][k] * B[k][j0 + j];
+                            axis_t o = s_out.read();
+                            if(u2f(o.data) != epi_ref(ref, EPI_LEAKY, 0.125f)) ok = false;
+                            if((int)o.last != (int)(i==h-1 && j==w-1)) ok = false;
+                            tlast += o.last;
+                        }
+                }
+    return ok && tlast == ntiles;
+}
+
+static bool test_cblock()
+{
+    int w11, w22, w21;
+    bool ok = run_cblock(1, 1, AMODE_STREAM, &w11);
+    ok &= run_cblock(2, 2, AMODE_ROW, &w22);
+    ok &= run_cblock(2, 1, AMODE_STREAM, &w21);
+    std::cout << "C block 2x2 (ROW) / 2x1 / 1x1: " << w22 << " / " << w21 << " / " << w11
+              << " input words for 37x45x40" << (ok ? ", C exact" : ", MISMATCH") << std::endl;
+    return ok && w22 < w21 && w21 < w11;
+}
+
+// =====================================================
+// Job queue: the cblock GEMM as jobs in one run, then a queue of
+// different GEMMs (fp16 16x16x32 ReLU 1x1, fp32 16x20x16 1x2 edge)
+// followed by the first job of the next queue: the run stops at the
+// end-of-queue word and the next run (auto-restart) picks up from there
+// =====================================================
+static bool test_jobs()
+{
+    int w22;
+    bool ok = run_cblock(2, 2, AMODE_ROW, &w22, 1);
+
+    static float A[N][2*N], B[2*N][2*N];
+    for(int i=0;i<N;i++)   for(int k=0;k<2*N;k++) A[i][k] = 0.5f*((i + 3*k) % 9) - 2.0f;
+    for(int k=0;k<2*N;k++) for(int j=0;j<2*N;j++) B[k][j] = 0.25f*((5*k + j) % 7) - 0.5f;
+
+    float T[N][N];
+    hls::stream<axis_t> s_in, s_out;
+    // job 7: fp16, Ktiles 2, ReLU, 1x1
+    push_job(s_in, job_d0(2, AMODE_STREAM, 0, FMT_FP16, EPI_RELU, 0), 7, 0, 0, 0);
+    for(int kt=0; kt<2; kt++){
+        for(int i=0;i<N;i++) for(int k=0;k<N;k++) T[i][k] = A[i][kt*N + k];
+        push_half(s_in, T, N, N, FMT_FP16);
+        for(int k=0;k<N;k++) for(int j=0;j<N;j++) T[k][j] = B[kt*N + k][j];
+        push_half(s_in, T, N, N, FMT_FP16);
+    }
+    // job 8: fp32, Ktiles 1, 1x2 block, C 16 x 20
+    push_job(s_in, job_d0(1, AMODE_STREAM, 1, FMT_FP32, EPI_NONE, 1 | (2 << 4)), 8, N, 20, N);
+    for(int i=0;i<N;i++) for(int k=0;k<N;k++) T[i][k] = A[i][k];
+    push_words(s_in, T, N, N);
+    for(int c=0;c<2;c++){
+        int w = (c == 0) ? N : 4;
+        for(int k=0;k<N;k++) for(int j=0;j<w;j++) T[k][j] = B[k][c*N + j];
+        push_words(s_in, T, N, w);
+    }
+    push_job(s_in, 0, 0, 0, 0, 0);
+    // next queue: job 9 = job 7 in fp32 without ReLU, Ktiles 1
+    push_job(s_in, job_d0(1, AMODE_STREAM, 0, FMT_FP32, EPI_NONE, 0), 9, 0, 0, 0);
+    for(int i=0;i<N;i++) for(int k=0;k<N;k++) T[i][k] = A[i][k];
+    push_words(s_in, T, N, N);
+    for(int k=0;k<N;k++) for(int j=0;j<N;j++) T[k][j] = B[k][j];
+    push_words(s_in, T, N, N);
+    push_job(s_in, 0, 0, 0, 0, 0);
+
+    // CTRL per-block registers stay 0: everything comes from the descriptors
+    gemm16_accum_axis_db(s_in, s_out, 0, AMODE_STREAM, 0, 0, EPI_NONE, 0.0f, FMT_FP32, 0, 0, 1, &last_job_tb, PERF_ARGS(perf_tb));
+    bool run1 = (last_job_tb == 8) && !s_in.empty() && s_out.size() == (size_t)(N*N + N*20);
+    gemm16_accum_axis_db(s_in, s_out, 0, AMODE_STREAM, 0, 0, EPI_NONE, 0.0f, FMT_FP32, 0, 0, 1, &last_job_tb, PERF_ARGS(perf_tb));
+    bool run2 = (last_job_tb == 9) && s_in.empty() && s_out.size() == (size_t)(N*N + N*20 + N*N);
+
+    int bad = 0, tlast = 0;
+    for(int job=0; job<3 && run2; job++){
+        int kk = (job == 0) ? 2*N : N;
+        for(int c=0; c<(job == 1 ? 2 : 1); c++){
+            int w = (job == 1 && c == 1) ? 4 : N;
+            for(int i=0;i<N;i++)
+                for(int j=0;j<w;j++){
+                    float ref = 0;
+                    for(int k=0;k<kk;k++) ref += A[i][k] * B[k][c*N + j];
+                    if(job == 0) ref = epi_ref(ref, EPI_RELU, 0.0f);
+                    axis_t o = s_out.read();
+                    if(u2f(o.data) != ref) bad++;
+                    if((int)o.last != (int)(i==N-1 && j==w-1)) bad++;
+                    tlast += o.last;
+                }
+        }
+    }
+    ok &= run1 && run2 && bad == 0 && tlast == 4;
+
+    std::cout << "Job queue: cblock GEMM as " << w22 << " input words, fp16 / fp32 jobs "
+              << (run1 && run2 ? "stop at end of queue" : "RUN BOUNDARY WRONG")
+              << (bad ? ", MISMATCH" : ", C exact") << std::endl;
+    return ok;
+}
+
+// =====================================================
+// Perf counters: a 1x1 Ktiles_tb run on the 32 / 64-bit top, the
+// counter differences against the loop cycle counts. C simulation
+// runs the processes one after the other with all input queued, so
+// the stall counters stay 0 unless misses are injected
+// (gemm16_nb_miss: every in_every-th s_in read_nb / out_every-th s_out
+// write_nb misses once). Then in_stall / out_stall must equal the
+// injected misses, busy counts and C must not change
+// =====================================================
+void gemm16_nb_miss(int in_every, int out_every);
+void gemm16_nb_missed(long *in, long *out);
+
+template<int W>
+static bool run_perf(void (*top)(hls::stream<ap_axiu<W,0,0,0> >&, hls::stream<ap_axiu<W,0,0,0> >&,
+                                 int, int, int, int, int, float, int, int, int, int, int *,
+                                 uint32_t *, uint32_t *, uint32_t *, uint32_t *,
+                                 uint32_t *, uint32_t *, uint32_t *, uint32_t *),
+                     int in_every, int out_every, std::vector<ap_uint<W> > *out)
+{
+    const int WPB = W / 32;
+    uint32_t p[PERF_NUM], before[PERF_NUM];
+    long in_missed, out_missed;
+
+    // three runs: the first one reads the free-running counters,
+    // the other two are counted
+    hls::stream<ap_axiu<W,0,0,0> > s_in, s_out;
+    for(int f=0; f<3*2*Ktiles_tb; f++)
+        for(int b=0; b<N*N/WPB; b++){
+            ap_axiu<W,0,0,0> w;
+            for(int l=0;l<WPB;l++) w.data.range(32*l+31, 32*l) = f2u(0.5f*((f + b + l) % 5));
+            w.keep = -1; w.strb = -1; w.user = 0; w.id = 0; w.dest = 0;
+            w.last = (b == N*N/WPB-1);
+            s_in.write(w);
+        }
+    for(int run=0; run<3; run++){
+        if(run == 1) gemm16_nb_miss(in_every, out_every);
+        top(s_in, s_out, Ktiles_tb, AMODE_STREAM, 0, 0, EPI_NONE, 0.0f, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(p));
+        if(run == 0) std::memcpy(before, p, sizeof(p));
+    }
+    gemm16_nb_missed(&in_missed, &out_missed);
+    gemm16_nb_miss(0, 0);
+    out->clear();
+    while(!s_out.empty()) out->push_back(s_out.read().data);
+
+    // per run: bias loop CB_MAX*N + 2 tiles per K step; C clear
+    // CB_MAX^2*N + N*N per K step; N*N send iterations
+    const uint32_t exp[PERF_NUM] = { (uint32_t)(2*(32 + 2*Ktiles_tb*N*N/(WPB == 1 ? 1 : 2))), (uint32_t)in_missed,
+                                     (uint32_t)(2*(64 + Ktiles_tb*N*N)), 0,
+                                     2*N*N, (uint32_t)out_missed, 2*Ktiles_tb, 2 };
+    bool ok = (in_every < 2 || in_missed > 0) && (out_every < 2 || out_missed > 0);
+    for(int i=0;i<PERF_NUM;i++) if(p[i] - before[i] != exp[i]) ok = false;
+    std::cout << W << "-bit perf counters (2 runs): recv " << p[0]-before[0] << " mac " << p[2]-before[2]
+              << " send " << p[4]-before[4] << " frames " << p[6]-before[6] << " tiles " << p[7]-before[7]
+              << " stalls " << p[1]-before[1] << "/" << p[3]-before[3] << "/" << p[5]-before[5];
+    if(in_every >= 2 || out_every >= 2)
+        std::cout << " (injected in " << in_missed << ", out " << out_missed << ")";
+    std::cout << (ok ? "" : "  <-- expected other counts") << std::endl;
+    return ok;
+}
+
+template<int W>
+static bool run_perf_stalls(void (*top)(hls::stream<ap_axiu<W,0,0,0> >&, hls::stream<ap_axiu<W,0,0,0> >&,
+                                        int, int, int, int, int, float, int, int, int, int, int *,
+                                        uint32_t *, uint32_t *, uint32_t *, uint32_t *,
+                                        uint32_t *, uint32_t *, uint32_t *, uint32_t *))
+{
+    std::vector<ap_uint<W> > clean, stalled;
+    bool ok = run_perf<W>(top, 0, 0, &clean);
+    ok &= run_perf<W>(top, 7, 5, &stalled);
+    if(stalled != clean){
+        std::cout << W << "-bit C differs with injected stalls" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+static bool test_perf_counters()
+{
+    bool ok = run_perf_stalls<32>(gemm16_accum_axis_db);
+    ok &= run_perf_stalls<64>(gemm16_accum_axis_db_x64);
+    return ok;
+}
+
 // =====================================================
 // Main Testbench
 // =====================================================
@@ -137,7 +1057,7 @@ int main()
     // -------------------------------------------------
     // Run DUT
     // -------------------------------------------------
-    gemm16_accum_axis_db(s_in, s_out, Ktiles_tb);
+    gemm16_accum_axis_db(s_in, s_out, Ktiles_tb, AMODE_STREAM, 0, 0, EPI_NONE, 0.0f, FMT_FP32, 1, 0, 0, &last_job_tb, PERF_ARGS(perf_tb));
 
     // -------------------------------------------------
     // Read output
@@ -174,10 +1094,55 @@ int main()
 
     std::cout << "Max error = " << max_err << std::endl;
 
+    // -------------------------------------------------
+    // A-panel reuse modes
+    // -------------------------------------------------
+    bool reuse_ok = test_a_panel_reuse();
+
+    // -------------------------------------------------
+    // Edge tiles (M, N, K not multiples of 16)
+    // -------------------------------------------------
+    bool edge_ok = test_edge_tiles();
+
+    // -------------------------------------------------
+    // Fused bias + activation epilogue
+    // -------------------------------------------------
+    bool epi_ok = test_epilogue();
+
+    // -------------------------------------------------
+    // fp16 / bf16 packed input
+    // -------------------------------------------------
+    bool half_ok = test_half_formats();
+
+    // -------------------------------------------------
+    // 64 / 128-bit AXIS
+    // -------------------------------------------------
+    bool wide_ok = test_wide_streams();
+
+    // -------------------------------------------------
+    // Ntiles output tiles per run (C ping-pong)
+    // -------------------------------------------------
+    bool multi_ok = test_multi_tile();
+
+    // -------------------------------------------------
+    // C blocks of br x bc tiles (register blocking)
+    // -------------------------------------------------
+    bool cblock_ok = test_cblock();
+
+    // -------------------------------------------------
+    // Job descriptor queue (jobs = 1)
+    // -------------------------------------------------
+    bool jobs_ok = test_jobs();
+
+    // -------------------------------------------------
+    // Stage perf counters
+    // -------------------------------------------------
+    bool perf_ok = test_perf_counters();
+
     // -------------------------------------------------
     // Result
     // -------------------------------------------------
-    if(max_err < EPS && last_seen && words_out==256)
+    if(max_err < EPS && last_seen && words_out==256 && reuse_ok && edge_ok && epi_ok && half_ok && wide_ok && multi_ok && cblock_ok && jobs_ok && perf_ok)
         std::cout << "\nPASS ✅\n";
     else
         std::cout << "\nFAIL ❌\n";
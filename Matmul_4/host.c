@@ -1,9 +1,60 @@
 /********************************************************************
  * SAFE Generic GEMM Host (Correct protocol for Ktiles-accum IP)
- *  - N = 16*k
+ *  - C(M x N) = A(M x K) * B(K x N), any M, N, K (no host padding)
+ *  - A, B packed ONCE into tile-major panels (gemm_pack); edge tiles
+ *    are packed compact and zero-padded inside the IP (edge header)
  *  - Tile (bi,bj):
- *      S2MM (256 floats) ONCE
- *      MM2S (512 floats) Ktiles times
+ *      S2MM (256 floats) ONCE, straight into packed C
+ *      MM2S (A tile 256 + B tile 256 floats) Ktiles times,
+ *           straight out of packed A / B (no per-frame copy)
+ *      edge shapes (M, N or K % 16 != 0): 1 header word per block
+ *           (rows, cols, valid k of the last K tile), then only the
+ *           valid words of each A / B / C tile
+ *  - Fused epilogue (EPI_ACT, EPI_USE_BIAS): C = act(A*B + bias) in
+ *    the IP; the bias slice of block (BI,BJ) (cols floats straight
+ *    out of the bias vector) follows the header
+ *  - DMA mode (XAxiDma_HasSg at runtime, DMA IRQ lines at build time):
+ *      simple : SimpleTransfer + busy-wait per tile transfer
+ *      async  : SimpleTransfer chained from the DMA completion IRQ
+ *               (gemm_dma_async); A/C row panels ping-pong so the CPU
+ *               packs / unpacks while the previous row is on the wire
+ *      SG     : all frames of all output tiles as BD chains
+ *               (gemm_dma_sg) -> continuous stream
+ *  - Register blocking (CB, default 2): the IP accumulates a CB x CB
+ *    block of C tiles at once; per K step the block's CB A tiles and
+ *    CB B tiles are sent, each reused CB times on chip → MM2S words
+ *    per C tile / CB. The header / bias / A-panel / run units below
+ *    are blocks; each C tile of a block is still its own S2MM
+ *  - Multi-tile run (MULTI_TILE, default): Ntiles = MB*NB blocks, the
+ *    IP is started once for the whole C and ping-pongs two C blocks,
+ *    so the S2MM of block t overlaps the accumulation of block t+1.
+ *    MULTI_TILE=0: one IP run per block (simple: start per block,
+ *    SG / async: auto-restart)
+ *  - A-panel reuse (A_REUSE, CB*Ktiles <= KT_MAX): the IP keeps the
+ *    A row panel of block row BI on chip from its first block, the
+ *    other blocks of the row send B-only K steps
+ *  - Half input (FMT = FMT_FP16 / FMT_BF16): A / B converted once
+ *    while packing (gemm_half, vectorized), 2 elements per AXIS word
+ *    → MM2S bytes / 2; the IP still accumulates and returns fp32
+ *  - Job queue (JOB_QUEUE, default): the IP is started once with
+ *    auto-restart and stays running; every block carries its own job
+ *    descriptor (Ktiles, A mode, edge, epilogue, fmt, cblock, id) in
+ *    front of its input, so no CTRL access or AP_START / AP_DONE
+ *    handshake per block or per GEMM. Completion = the S2MM of the
+ *    last tile, cross-checked with the IP's last_job register.
+ *    JOB_QUEUE=0: CTRL protocol (Ntiles / auto-restart runs)
+ *  - Stage counters (PERF_COUNTERS, default): the IP's free-running
+ *    recv / mac / send busy and stall cycles, K steps and C tiles are
+ *    read before and after the HW run and printed as per-run deltas
+ *  - Runtime shape: M / N / K / CB are variables (-D values = initial
+ *    shape). Benchmark sweep (BENCH=1, gemm_bench): N x cblock list,
+ *    warm-up + R timed runs per point, min / median / p95 / p99,
+ *    GFLOPS, DMA bytes, CSV / JSON report
+ *  - Cache maintenance (gemm_buf): packed A / B flushed and packed C
+ *    invalidated once per GEMM, none per transfer. BUF_MODE=1 / 2:
+ *    the packed pool is non-cacheable / ACP-coherent, no maintenance
+ *  - Phase trace (TRACE_PHASES, gemm_trace): pack / cache / DMA submit
+ *    / DMA wait / IP poll / unpack totals and histograms + Chrome trace
  ********************************************************************/
 
 #include <stdio.h>
@@ -17,79 +68,346 @@
 #include "xtime_l.h"
 #include "xil_io.h"
 
-#define N 32              // 16의 배수
+#include "sgemm_cpu.h"
+#include "gemm_pack.h"
+#include "gemm_half.h"
+#include "gemm_dma_sg.h"
+#include "gemm_dma_async.h"
+#include "gemm_bench.h"
+#include "gemm_trace.h"
+#include "gemm_buf.h"
+
+#ifndef N
+#define N 32              // C의 column 수 (에뮬레이션 빌드에서는 -DN=... 로 지정)
+#endif
+#ifndef M
+#define M N               // C / A의 row 수 (기본: 정방 행렬)
+#endif
+#ifndef K
+#define K N               // A의 column 수 = B의 row 수
+#endif
 #define TILE 16           // 가속기 자체는 16*16 행렬 곱셈 & 누적
-#define NB (N/TILE)       // Tile의 수
-#define KTILES NB         // Tile의 수 (한 차원 측면에서)
+#ifndef CB
+#define CB 2              // C block 한 변의 tile 수 (IP 안에서 CB x CB tile 동시 누적, 1: 기존 protocol)
+#endif
 
 #define MAXN 256*3        // 최대 행렬의 크기
+#if M > MAXN || N > MAXN || K > MAXN
+#error "M, N, K must be <= MAXN"
+#endif
 #define DMA_DEV_ID XPAR_AXIDMA_0_DEVICE_ID
 #define GEMM_CTRL_BASE XPAR_GEMM16_ACCUM_AXIS_0_S_AXI_CTRL_BASEADDR
 
 #define REG_AP_CTRL  0x00
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define AP_AUTO_RESTART 0x80
 #define REG_KTILES   0x10    // Tile의 수를 가속기에 제공하여 가속기 내부에서 KTILES번 곱셈누적하도록 함.
+#define REG_AMODE    0x18    // A 공급 방식 (AMODE_*)
+#define REG_JTILES   0x20    // AMODE_ROW: row 당 output tile 수
+#define REG_EDGE     0x28    // 1: run마다 header word (rows | cols<<8 | k_last<<16)
+#define REG_EPI      0x30    // epilogue: [1:0] activation, [4] bias
+#define REG_ALPHA    0x38    // leaky-ReLU 기울기 (float bit pattern)
+#define REG_FMT      0x40    // A / B 입력 format (FMT_*)
+#define REG_NTILES   0x48    // start 1회에 처리할 output block 수 (0 / 1: 1개)
+#define REG_CBLK     0x50    // C block 모양: [3:0] tile rows, [7:4] tile cols (0 / 1: tile 1개)
+#define REG_JOBS     0x58    // 1: job queue (block마다 입력 앞의 descriptor가 설정, end-of-queue까지 run)
+#define REG_LASTJOB  0x60    // (read) 마지막으로 출력을 끝낸 block의 job id
+#define REG_PERF     0x70    // (read) stage counter 8개, 0x10 간격: recv, in_stall, mac, mac_stall, send, out_stall, frames, tiles
+#define PERF_NUM     8
+
+#define EPI_NONE     0
+#define EPI_RELU     1
+#define EPI_RELU6    2
+#define EPI_LEAKY    3
+#define EPI_BIAS     0x10
+
+#ifndef EPI_ACT
+#define EPI_ACT EPI_NONE     // -DEPI_ACT=1: ReLU, 2: ReLU6, 3: leaky-ReLU
+#endif
+#ifndef EPI_USE_BIAS
+#define EPI_USE_BIAS 0       // -DEPI_USE_BIAS=1: column bias를 IP에서 더함
+#endif
+#define LEAKY_ALPHA 0.01f
+#define EPI_ON (EPI_ACT != EPI_NONE || EPI_USE_BIAS)
+
+#define FMT_FP32     0       // word당 float 1개 (기존)
+#define FMT_FP16     1       // word당 fp16 2개 (low half = 앞 column)
+#define FMT_BF16     2       // word당 bf16 2개
+
+#ifndef FMT
+#define FMT FMT_FP32         // -DFMT=1: fp16, 2: bf16 입력 (누적 / 출력은 fp32)
+#endif
+#define ESZ ((FMT == FMT_FP32) ? 4 : 2)    // packed A / B의 원소 크기 (byte)
+#if FMT != FMT_FP32 && ((K % 2) || (N % 2))
+#error "FMT_FP16 / FMT_BF16: K and N must be even (tile rows must fill whole words)"
+#endif
+
+#define AMODE_STREAM 0       // frame = A + B (기존)
+#define AMODE_LOAD   1       // frame = A + B, A는 IP 내부 panel에도 저장
+#define AMODE_REUSE  2       // frame = B만, A는 panel에서
+#define AMODE_ROW    3       // Jtiles run마다 첫 run LOAD, 나머지 REUSE (auto-restart용)
+
+#define KT_MAX 48            // IP 내부 A panel 크기 (tile 수)
+
+#ifndef A_REUSE
+#define A_REUSE 1            // -DA_REUSE=0: 매 frame A 전송 (기존 protocol)
+#endif
+#define USE_A_PANEL (A_REUSE && shape.cb*KTILES <= KT_MAX)
+
+#ifndef MULTI_TILE
+#define MULTI_TILE 1         // -DMULTI_TILE=0: tile마다 IP run (기존 protocol)
+#endif
+// MULTI_TILE: C 전체(MB*NB block)가 IP run 1회 → start 1회, auto-restart 불필요
+//  (IP 내부 C 누적기 2개 ping-pong: tile t 출력 S2MM과 tile t+1 누적이 겹침)
+#ifndef JOB_QUEUE
+#define JOB_QUEUE 1          // -DJOB_QUEUE=0: CTRL register로 run 설정 (Ntiles / auto-restart)
+#endif
+// JOB_QUEUE: IP는 main에서 auto-restart로 1회 start 후 계속 동작 (persistent)
+//  block마다 descriptor {d0, job id, [edge header]}가 입력 앞에 붙음 → GEMM / block마다 CTRL 접근 없음
+#define AUTO_RESTART (!JOB_QUEUE && !MULTI_TILE && MB*NB > 1)
+
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS 1      // -DPERF_COUNTERS=0: IP stage counter 읽기 / 출력 생략
+#endif
+#define PL_MHZ 100.0         // PL clock (counter cycle ↔ us 환산)
+
+#ifndef BUF_MODE
+#define BUF_MODE 0           // packed A / B / C pool: 0 cached (GEMM당 flush / invalidate 1회), 1 non-cacheable, 2 ACP coherent
+#endif
+// packed A / B / C 3개, 1 MB section 단위
+#define DMA_POOL_BYTES ((3*MAXN*MAXN*sizeof(float) + GEMM_BUF_SECTION-1) & ~(GEMM_BUF_SECTION-1))
+
+#ifndef TRACE_PHASES
+#define TRACE_PHASES 0       // -DTRACE_PHASES=1: host 구간 timer (gemm_trace) → phase별 합계 / histogram + Chrome trace
+#endif
+#ifndef TRACE_FILE
+#define TRACE_FILE "matmul4_trace.json"   // Chrome trace 경로 (standalone: UART, "trace " prefix)
+#endif
+// PHASE(ph) 문장: 그 문장 / block의 시간을 phase ph로 기록, PHASE_TILE(t): 이후 구간의 block 번호
+#if TRACE_PHASES
+#define PHASE(ph)     GEMM_TRACE_SCOPE(ph)
+#define PHASE_TILE(t) gemm_trace_tile(t)
+#else
+#define PHASE(ph)
+#define PHASE_TILE(t)
+#endif
+
+#define SW_THREADS 0       // CPU SGEMM thread 수 (0: 전체 core, standalone은 1)
+#define SW_REPS 3          // SW(simd) 측정 횟수 (warm-up 1회 뒤 최소값)
+
+// CPU / PL routing (opt-in fallback build): HW 실행 전에 예측 시간 비교 → CPU가 빠르면 sgemm_cpu로 계산 (PL 미사용, BENCH sweep 제외)
+//  CPU rate는 직전 sgemm_cpu 측정값, PL은 보드 측정값 (README: N=512 rate, N=32 시간 - flops / rate)
+#ifndef ROUTE
+#define ROUTE 0                    // -DROUTE=1: CPU fallback build (기본은 항상 PL)
+#endif
+#ifndef ROUTE_ACCEL_GFLOPS
+#define ROUTE_ACCEL_GFLOPS   0.137 // PL steady-state rate
+#endif
+#ifndef ROUTE_ACCEL_FIXED_US
+#define ROUTE_ACCEL_FIXED_US 210.0 // 호출당 고정 비용 (AXI-Lite, DMA 설정, cache)
+#endif
+
+#ifndef BENCH
+#define BENCH 0              // -DBENCH=1: N / cblock sweep + warm-up + 반복 측정 (gemm_bench, CSV / JSON)
+#endif
+#define CB_MAX 2             // IP의 최대 C block (cblock CB_MAX x CB_MAX tile)
+#if CB < 1 || CB > CB_MAX
+#error "CB must be 1..CB_MAX"
+#endif
+
+// shape / C block은 runtime: -DM / -DN / -DK / -DCB 값은 초기값 (위의 compile-time 검사도 이 값 기준)
+// BENCH sweep은 GEMM마다 바꿈 → static 배열은 MAXN / CB_MAX 크기
+typedef struct {
+    int m, n, k;          // C(m x n) = A(m x k) * B(k x n)
+    int cb;               // C block 한 변의 tile 수
+} gemm_shape_t;
+static gemm_shape_t shape = { M, N, K, CB };
+#undef M
+#undef N
+#undef K
+#undef CB
+#define MT ((shape.m+TILE-1)/TILE)    // row 방향 tile 수 (마지막 tile은 partial 가능)
+#define NT ((shape.n+TILE-1)/TILE)    // column 방향 tile 수
+#define KTILES ((shape.k+TILE-1)/TILE) // K 방향 tile 수
+#define MB ((MT+shape.cb-1)/shape.cb) // row 방향 block 수 (마지막 block은 일부 tile만 가능)
+#define NB ((NT+shape.cb-1)/shape.cb) // column 방향 block 수
+#define EDGE ((shape.m%TILE) || (shape.n%TILE) || (shape.k%TILE) || (MT%shape.cb) || (NT%shape.cb))   // edge tile / block 존재 → block마다 header
+
+// block design에 DMA interrupt (IRQ_F2P)가 연결되어 있으면 async mode
+// (-DDMA_USE_IRQ=0: 기존 polling simple mode 강제)
+#ifndef DMA_USE_IRQ
+#ifdef XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID
+#define DMA_USE_IRQ 1
+#else
+#define DMA_USE_IRQ 0
+#endif
+#endif
+
+enum { DMA_SIMPLE, DMA_ASYNC, DMA_SG };
+static const char *dma_mode_name[] = { "simple", "async (IRQ)", "SG" };
+
+#define SG_TX_BDS 256      // MM2S BD ring (16 KB): 128 frame, half ring씩 refill
+#define SG_RX_BDS 64       // S2MM BD ring: output tile 64개
 
 #define DMA_TIMEOUT 100000000
 #define EPS 1e-6f
 
 static XAxiDma AxiDma;
 
-static inline int idx(int r,int c){ return r*N+c; }         // 입력 행렬의 주소 index 반환
-static inline int idx16(int r,int c){ return r*TILE+c; }    // tile 행렬의 주소 index 반환
+static XAxiDma_Bd TxBds[SG_TX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+static XAxiDma_Bd RxBds[SG_RX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+
+static inline int idx(int r,int c,int ld){ return r*ld+c; }  // 입력 행렬의 주소 index 반환
+
+static u32 BlkHdr[(MAXN/TILE)*(MAXN/TILE)][4] __attribute__((aligned(64))); // block t의 [job descriptor] + [edge header]
+static float Bias[MAXN] __attribute__((aligned(64)));                      // column bias (epilogue)
 
 static inline double cycles_to_us(XTime c){
     return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
 }
 
-static void flush(void* p,int sz){ Xil_DCacheFlushRange((UINTPTR)p,sz); }    // Cache Flush for READs
-static void inval(void* p,int sz){ Xil_DCacheInvalidateRange((UINTPTR)p,sz); }    // Cache Invalidate for WRITEs
+// cache 관리는 buffer 전체 단위로 GEMM마다 1회 (gemm_buf: line 정렬, 큰 buffer는 전체 cache flush,
+// non-cacheable / ACP region은 생략) → 전송 loop 안에는 cache 작업 없음
+static void flush(void* p,int sz){ PHASE(GEMM_PH_CACHE) gemm_buf_to_dev(p,sz); }      // Cache Flush for READs
+static void inval(void* p,int sz){ PHASE(GEMM_PH_CACHE) gemm_buf_from_dev(p,sz); }    // Cache Invalidate for WRITEs
 
 // ---------------- SW GEMM ----------------
+// sgemm_set_impl()로 naive / blocked / SIMD 선택
+// epilogue가 켜져 있으면 C 전체를 한 번 더 도는 bias + activation pass (HW는 IP 안에서 처리)
 void gemm_sw(float*A,float*B,float*C){
-    for(int i=0;i<N;i++)
-        for(int j=0;j<N;j++){
-            float s=0;
-            for(int k=0;k<N;k++)
-                s+=A[idx(i,k)]*B[idx(k,j)];
-            C[idx(i,j)]=s;
+    sgemm_cpu(shape.m,shape.n,shape.k, A,shape.k, B,shape.n, C,shape.n);
+    if (!EPI_ON) return;
+    for(int i=0;i<shape.m;i++)
+        for(int j=0;j<shape.n;j++){
+            float v = C[i*shape.n+j] + (EPI_USE_BIAS ? Bias[j] : 0.0f);
+            if      (EPI_ACT == EPI_RELU)  v = (v > 0.0f) ? v : 0.0f;
+            else if (EPI_ACT == EPI_RELU6) v = (v > 6.0f) ? 6.0f : ((v > 0.0f) ? v : 0.0f);
+            else if (EPI_ACT == EPI_LEAKY) v = (v > 0.0f) ? v : v*LEAKY_ALPHA;
+            C[i*shape.n+j] = v;
         }
 }
 
-// ---------------- Tile helpers ----------------
-void extract_block(float*src,int br,int bc,float*dst){
-    int r0=br*TILE, c0=bc*TILE;
-    for(int i=0;i<TILE;i++)
-        for(int j=0;j<TILE;j++)
-            dst[idx16(i,j)] = src[idx(r0+i,c0+j)];
+// ---------------- Packed tile access ----------------
+// A: row panel 순서 (A(bi,0..KTILES-1) 연속), B: column panel 순서 (B(0..KTILES-1,bj) 연속)
+// edge tile은 compact (rows x cols) → 전송 크기도 tile마다 다름
+// A / B는 ESZ byte 원소 (fp16 / bf16이면 2 byte), C는 항상 float
+static inline void* tileA(void*Ap,int br,int bc){ return (char*)Ap + gemm_tile_off(shape.m,shape.k,TILE,GEMM_TILES_ROW_MAJOR,br,bc)*ESZ; }
+static inline void* tileB(void*Bp,int br,int bc){ return (char*)Bp + gemm_tile_off(shape.k,shape.n,TILE,GEMM_TILES_COL_MAJOR,br,bc)*ESZ; }
+static inline float* tileC(float*Cp,int br,int bc){ return gemm_tile_ptr(Cp,shape.m,shape.n,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+
+static inline int rows_m(int bi){ return gemm_tile_dim(shape.m,TILE,bi); }
+static inline int cols_k(int bk){ return gemm_tile_dim(shape.k,TILE,bk); }
+static inline int cols_n(int bj){ return gemm_tile_dim(shape.n,TILE,bj); }
+
+static inline int bytesA(int bi,int bk){ return rows_m(bi)*cols_k(bk)*ESZ; }
+static inline int bytesB(int bk,int bj){ return cols_k(bk)*cols_n(bj)*ESZ; }
+static inline int bytesC(int bi,int bj){ return rows_m(bi)*cols_n(bj)*sizeof(float); }
+
+// C block (BI,BJ): tile 수 / 원소 크기 (matrix 끝의 block은 일부 tile만)
+static inline int blk_mt(int BI){ return gemm_tile_dim(MT,shape.cb,BI); }
+static inline int blk_nt(int BJ){ return gemm_tile_dim(NT,shape.cb,BJ); }
+static inline int blk_rows(int BI){ return gemm_tile_dim(shape.m,shape.cb*TILE,BI); }
+static inline int blk_cols(int BJ){ return gemm_tile_dim(shape.n,shape.cb*TILE,BJ); }
+
+// block t (= BI*NB + BJ)의 q번째 출력 tile: block 안 row-major (IP의 출력 순서)
+static inline int out_tiles(int t){ return blk_mt(t / NB) * blk_nt(t % NB); }
+static inline void out_tile(int t, int q, int *bi, int *bj){
+    *bi = (t / NB)*shape.cb + q / blk_nt(t % NB);
+    *bj = (t % NB)*shape.cb + q % blk_nt(t % NB);
 }
 
-void store_block(float*dst,int br,int bc,float*src){
-    int r0=br*TILE, c0=bc*TILE;
-    for(int i=0;i<TILE;i++)
-        for(int j=0;j<TILE;j++)
-            dst[idx(r0+i,c0+j)] = src[idx16(i,j)];
+// A / B packing: fp32는 그대로, fp16 / bf16은 packing하면서 변환 (tile row 단위 SIMD)
+static void pack_in(const float *src, int rows, int cols, int ld, gemm_tile_order_t order, void *dst){
+    PHASE(GEMM_PH_PACK) {
+        if (FMT == FMT_FP32)
+            gemm_pack_tiles(src, rows, cols, ld, TILE, order, (float*)dst);
+        else
+            gemm_pack_tiles_half(src, rows, cols, ld, TILE, order, (gemm_fmt_t)FMT, (uint16_t*)dst);
+    }
 }
 
+// block 입력 앞의 word 수: job queue는 descriptor (d0, id, [edge header]), 아니면 [edge header]
+static inline int hdr_bytes(void){ return ((JOB_QUEUE ? 2 : 0) + EDGE) * (int)sizeof(u32); }
+
+// job descriptor d0: [7:0] Ktiles, [9:8] a_mode, [10] edge, [12:11] fmt, [20:16] epilogue, [31:24] cblock
+static inline u32 job_d0(int BJ){
+    int a_mode = USE_A_PANEL ? ((BJ == 0) ? AMODE_LOAD : AMODE_REUSE) : AMODE_STREAM;
+    int epi    = EPI_ACT | (EPI_USE_BIAS ? EPI_BIAS : 0);
+    return KTILES | (a_mode << 8) | (EDGE << 10) | (FMT << 11) | (epi << 16) | ((shape.cb | (shape.cb << 4)) << 24);
+}
+
+// block header 1회 생성 (job id = block 번호 t)
+//  edge header: block의 원소 rows / cols (16*CB → 0으로 쓰지 않고 그대로 기록)
+static void make_blk_hdrs(void){
+    for(int BI=0; BI<MB; BI++)
+        for(int BJ=0; BJ<NB; BJ++){
+            u32 *h = BlkHdr[BI*NB+BJ];
+            u32 edge = blk_rows(BI) | (blk_cols(BJ) << 8) | (cols_k(KTILES-1) << 16);
+            if (JOB_QUEUE) { h[0] = job_d0(BJ); h[1] = BI*NB+BJ; h[2] = edge; }
+            else           { h[0] = edge; }
+        }
+    flush(BlkHdr, MB*NB*sizeof(BlkHdr[0]));
+}
+
+// IP 완료 확인: job queue는 last_job = 마지막 block (IP는 다음 descriptor를 기다리며 계속 동작),
+// 아니면 AP_CTRL의 mask bit (AP_DONE / AP_IDLE)
+static int ip_wait_done(u32 mask){
+    int t=DMA_TIMEOUT;
+    PHASE(GEMM_PH_POLL) {
+        if (JOB_QUEUE) while(Xil_In32(GEMM_CTRL_BASE+REG_LASTJOB) != (u32)(MB*NB-1) && t--);
+        else           while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & mask) && t--);
+    }
+    return (t<=0) ? -1 : 0;
+}
+
+#if !BENCH
+// ---------------- IP stage counters ----------------
+// free-running (IP가 reset하지 않음, 32-bit wrap) → run 전후 snapshot의 차이 = run 1회 분
+static void perf_read(u32 p[PERF_NUM]){
+    for(int i=0; i<PERF_NUM; i++) p[i] = Xil_In32(GEMM_CTRL_BASE+REG_PERF+0x10*i);
+}
+
+// stage별 busy / stall cycle과 HW 시간 (hw_us * PL_MHZ cycle) 대비 비율
+//  busy가 100%에 가까운 stage = 병목, stall이 큰 stage = 앞 / 뒤 stage (또는 DMA)를 기다림
+static void perf_print(const u32 a[PERF_NUM], const u32 b[PERF_NUM], double hw_us){
+    static const char *stage[3] = { "recv", "mac", "send" };
+    double total = hw_us * PL_MHZ;
+    u32 d[PERF_NUM];
+    for(int i=0; i<PERF_NUM; i++) d[i] = b[i] - a[i];     // wrap-around도 u32 뺄셈으로 그대로
+    for(int s=0; s<3; s++)
+        printf("PL %-4s busy %9u stall %9u cycles (%5.1f%% / %5.1f%% of %.0f)\n", stage[s],
+               (unsigned)d[2*s], (unsigned)d[2*s+1], 100.0*d[2*s]/total, 100.0*d[2*s+1]/total, total);
+    printf("PL %u K steps, %u C tiles\n", (unsigned)d[6], (unsigned)d[7]);
+}
+#endif
+
 // ---------------- DMA helpers ----------------
-// MM2S: send 512 floats (2KB)
-static int dma_send_frame(float *in512){
-    const int in_bytes = 512*sizeof(float);        // 16*16 행렬 2개: 16*16*2 = 512
-    flush(in512, in_bytes);
+// MM2S: tile 1개 (최대 256 floats = 1KB) 또는 header word 1회
+// (packed A / B, block header, bias는 GEMM 시작 전에 전체 flush 완료)
+static int dma_send_buf(void *in, int in_bytes){
+    int rc = XST_FAILURE;
 
-    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)in512, in_bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+    PHASE(GEMM_PH_SUBMIT) rc = XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)in, in_bytes, XAXIDMA_DMA_TO_DEVICE);
+    if (rc != XST_SUCCESS)
         return -1;
 
     int t=DMA_TIMEOUT;
-    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE) && t--);
+    PHASE(GEMM_PH_WAIT) while(XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE) && t--);
     return (t<=0) ? -1 : 0;
 }
 
-// S2MM: receive 256 floats (1KB) - tile당 1번만!
-static int dma_recv_tile(float *out256){
-    const int out_bytes = 256*sizeof(float);        // 출력 행렬 1개: 16*16 = 256
-    inval(out256, out_bytes);
+// block row의 첫 block만 A 전송 (A panel 재사용 시)
+static inline int send_a(int BJ){ return !USE_A_PANEL || BJ == 0; }
+
+// S2MM: receive 256 floats (1KB, edge tile은 rows x cols) - tile당 1번만!
+// (packed C는 GEMM 전후로 전체 invalidate)
+static int dma_recv_tile(float *out256, int out_bytes){
+    int rc = XST_FAILURE;
 
-    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)out256, out_bytes, XAXIDMA_DEVICE_TO_DMA) != XST_SUCCESS)
+    PHASE(GEMM_PH_SUBMIT) rc = XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)out256, out_bytes, XAXIDMA_DEVICE_TO_DMA);
+    if (rc != XST_SUCCESS)
         return -1;
 
     return 0;
@@ -97,94 +415,678 @@ static int dma_recv_tile(float *out256){
 
 static int dma_wait_recv_done(void){
     int t=DMA_TIMEOUT;
-    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DEVICE_TO_DMA) && t--);
+    PHASE(GEMM_PH_WAIT) while(XAxiDma_Busy(&AxiDma, XAXIDMA_DEVICE_TO_DMA) && t--);
     return (t<=0) ? -1 : 0;
 }
 
-int main(){
-    printf("\n===== GEMM (N=%d) correct Ktiles protocol =====\n", N);
+// block (BI,BJ)의 입력: [job descriptor / edge header] + [bias] + Ktiles K step을 MM2S로 연속 전송
+// K step = A tile blk_mt개 (A panel 재사용이면 없음) + B tile blk_nt개, packed buffer에서 바로 (복사 없음)
+static int dma_send_block_in(void *Ap, void *Bp, int BI, int BJ){
+    PHASE_TILE(BI*NB + BJ);
+    if((hdr_bytes() && dma_send_buf(BlkHdr[BI*NB+BJ], hdr_bytes())!=0) ||
+       (EPI_USE_BIAS && dma_send_buf(&Bias[BJ*shape.cb*TILE], blk_cols(BJ)*sizeof(float))!=0)){
+        printf("MM2S header send fail\n");
+        return -1;
+    }
+    for(int bk=0; bk<KTILES; bk++){
+        for(int r=0; r<blk_mt(BI) && send_a(BJ); r++){
+            if(dma_send_buf(tileA(Ap, BI*shape.cb+r, bk), bytesA(BI*shape.cb+r, bk))!=0){
+                printf("MM2S frame send fail\n");
+                return -1;
+            }
+        }
+        for(int c=0; c<blk_nt(BJ); c++){
+            if(dma_send_buf(tileB(Bp, bk, BJ*shape.cb+c), bytesB(bk, BJ*shape.cb+c))!=0){
+                printf("MM2S frame send fail\n");
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
 
-    XAxiDma_Config* cfg = XAxiDma_LookupConfig(DMA_DEV_ID);
-    XAxiDma_CfgInitialize(&AxiDma,cfg);
+// block t의 출력 수신: tile마다 S2MM 완료 대기 → 다음 tile 제출 (S2MM은 한 번에 1개만)
+//  - block t 첫 tile의 S2MM은 미리 걸려 있어야 함
+//  - 마지막 tile 뒤에는 block next의 첫 tile 제출 (next < 0: 없음)
+static int dma_recv_block(float *Cp, int t, int next){
+    PHASE_TILE(t);
+    for(int q=0; q<out_tiles(t); q++){
+        int bi, bj;
+        out_tile(t, q, &bi, &bj);
+        if(dma_wait_recv_done()!=0){
+            printf("S2MM wait timeout\n");
+            return -1;
+        }
 
-    static float A[MAXN*MAXN] __attribute__((aligned(64)));
-    static float B[MAXN*MAXN] __attribute__((aligned(64)));
-    static float Csw[MAXN*MAXN] __attribute__((aligned(64)));
-    static float Chw[MAXN*MAXN] __attribute__((aligned(64)));
+        if (q+1 < out_tiles(t)) out_tile(t, q+1, &bi, &bj);
+        else if (next >= 0)     out_tile(next, 0, &bi, &bj);
+        else                    break;
+        if(dma_recv_tile(tileC(Cp, bi, bj), bytesC(bi, bj))!=0){
+            printf("S2MM submit fail\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// ---------------- HW GEMM: simple mode ----------------
+#if MULTI_TILE || JOB_QUEUE
+// IP start 1회 (Ntiles = MB*NB, job queue는 main에서 이미 start), block마다 MM2S (A + B tile) Ktiles 회
+// + S2MM tile 수만큼 (전송마다 busy-wait)
+//  - block t 입력을 먼저 보내고 나서 block t-1 출력을 받음
+//    → IP가 block t를 누적하는 동안 block t-1의 C가 S2MM으로 나감
+static int gemm_hw_simple(void *Ap, void *Bp, float *Cp){
+    const int nblk = MB*NB;
+    int bi, bj;
+
+    if (!JOB_QUEUE) PHASE(GEMM_PH_POLL) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START);
+    out_tile(0, 0, &bi, &bj);
+    if(dma_recv_tile(tileC(Cp, bi, bj), bytesC(bi, bj))!=0){
+        printf("S2MM submit fail\n");
+        return -1;
+    }
+
+    for(int t=0; t<nblk; t++){
+        // (1) block t 입력 전송
+        if(dma_send_block_in(Ap, Bp, t / NB, t % NB)!=0) return -1;
+
+        // (2) block t-1 출력 수신 → 마지막 tile 뒤에 block t의 첫 S2MM 제출
+        if(t > 0 && dma_recv_block(Cp, t-1, t)!=0) return -1;
+    }
+
+    // (3) 마지막 block 출력 + IP done 확인
+    if(dma_recv_block(Cp, nblk-1, -1)!=0) return -1;
+    if(ip_wait_done(AP_DONE)!=0){
+        printf("IP done timeout\n");
+        return -1;
+    }
+
+    return 0;
+}
+#else
+// block마다 IP start + MM2S (A + B tile) Ktiles 회 + S2MM tile 수만큼 (전송마다 busy-wait)
+static int gemm_hw_simple(void *Ap, void *Bp, float *Cp){
+    for(int BI=0; BI<MB; BI++){                // MB: row 방향 block의 수
+        for(int BJ=0; BJ<NB; BJ++){            // NB: column 방향 block의 수
+            int t = BI*NB + BJ, bi, bj;
+
+            // (1) block 첫 출력 tile의 S2MM을 먼저 걸어둔다
+            out_tile(t, 0, &bi, &bj);
+            if(dma_recv_tile(tileC(Cp, bi, bj), bytesC(bi, bj))!=0){
+                printf("S2MM submit fail\n");
+                return -1;
+            }
+
+            // (2) IP start (block마다 A panel 모드 지정)
+            PHASE(GEMM_PH_POLL) {
+                if (USE_A_PANEL)
+                    Xil_Out32(GEMM_CTRL_BASE+REG_AMODE, (BJ == 0) ? AMODE_LOAD : AMODE_REUSE);
+                Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START);
+            }
 
-    static float frame_buf[512] __attribute__((aligned(64)));    // Two tile matrices (A16*16, B16*16)
-    static float out_buf[256]   __attribute__((aligned(64)));    // One tile matrix (C16*16)
+            // (3) [edge header] + [bias] + Ktiles K step
+            if(dma_send_block_in(Ap, Bp, BI, BJ)!=0) return -1;
 
-    static float A16[256], B16[256];
+            // (4) block의 출력 tile 수신 (여기서 packed C의 tile이 채워짐)
+            if(dma_recv_block(Cp, t, -1)!=0) return -1;
 
-    for(int i=0;i<N;i++)
-        for(int j=0;j<N;j++){
-            A[idx(i,j)] = i + j*0.1f;
-            B[idx(i,j)] = j + i*0.2f;
+            // (5) IP done도 확인(안전)
+            PHASE(GEMM_PH_POLL) while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_DONE));
         }
+    }
 
-    // SW
-    XTime t0,t1;
-    XTime_GetTime(&t0);
-    gemm_sw(A,B,Csw);
-    XTime_GetTime(&t1);
-    double sw_us=cycles_to_us(t1-t0);
+    return 0;
+}
+#endif
 
-    // HW
-    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
+// ---------------- HW GEMM: scatter-gather mode ----------------
+// 전체 GEMM의 K step을 BD chain으로 연속 제출, CPU는 ring refill 때만 개입
+//  - JOB_QUEUE: IP는 이미 동작 중, block마다 descriptor BD만 추가 (start / done 없음)
+//  - MULTI_TILE: IP run 1회가 모든 block을 처리 (start 1회)
+//  - MULTI_TILE=0: IP는 auto-restart, block이 끝나면 바로 다음 block 시작
+//    (block당 AP start 없음). 마지막 block은 직전 block까지 끝난 뒤
+//    auto-restart를 해제하고 나서 전송 → IP가 마지막 block 후 재시작되어
+//    입력을 기다리는 상태로 남지 않음
+static int gemm_hw_sg(void *Ap, void *Bp, float *Cp){
+    static gemm_sg_seg_t seg[2*CB_MAX*(MAXN/TILE)+2];
+    static gemm_sg_seg_t out[CB_MAX*CB_MAX];
+    XAxiDma_BdRing *tx = XAxiDma_GetTxRing(&AxiDma);
+    XAxiDma_BdRing *rx = XAxiDma_GetRxRing(&AxiDma);
+    const int nblk = MB*NB;
+    int rc;
 
-    XTime_GetTime(&t0);
+    if (!JOB_QUEUE)
+        PHASE(GEMM_PH_POLL) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AUTO_RESTART ? (AP_AUTO_RESTART|AP_START) : AP_START);
 
-    for(int bi=0; bi<NB; bi++){                // NB: 한 축으로의 tile의 수
-        for(int bj=0; bj<NB; bj++){            // NB: 한 축으로의 tile의 수
+    for(int t=0; t<nblk; t++){
+        int BI = t / NB, BJ = t % NB;
+        PHASE_TILE(t);
 
-            // (1) 타일 출력 S2MM을 먼저 1회만 걸어둔다
-            if(dma_recv_tile(out_buf)!=0){
-                printf("S2MM submit fail\n");
+        if (t == nblk-1 && AUTO_RESTART) {
+            // 마지막 block: 앞의 block 출력이 모두 끝남 = IP가 마지막 run으로 재시작됨
+            PHASE(GEMM_PH_WAIT) rc = gemm_sg_wait(rx, DMA_TIMEOUT);
+            if (rc!=0){
+                printf("S2MM SG wait fail\n");
                 return -1;
             }
+            PHASE(GEMM_PH_POLL) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 0);    // auto-restart 해제
+        }
+
+        // (1) 출력 tile마다 S2MM BD 1개 (IP가 tile마다 TLAST)
+        for(int q=0; q<out_tiles(t); q++){
+            int bi, bj;
+            out_tile(t, q, &bi, &bj);
+            out[q].addr = (UINTPTR)tileC(Cp, bi, bj);
+            out[q].len  = bytesC(bi, bj);
+            out[q].ctrl = 0;
+        }
+        PHASE(GEMM_PH_SUBMIT) rc = gemm_sg_submit(rx, out, out_tiles(t), DMA_TIMEOUT);
+        if (rc!=0){
+            printf("S2MM SG submit fail\n");
+            return -1;
+        }
+
+        // (2) [descriptor / edge header BD] + [bias BD] + Ktiles K step = A tile BD들 + B tile BD들
+        //     (K step의 첫 BD SOF, 마지막 BD EOF / A panel 재사용 block: B tile BD들만)
+        int nseg = 0;
+        if (hdr_bytes()) {
+            seg[nseg].addr = (UINTPTR)BlkHdr[t];
+            seg[nseg].len  = hdr_bytes();
+            seg[nseg].ctrl = XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK;
+            nseg++;
+        }
+        if (EPI_USE_BIAS) {
+            seg[nseg].addr = (UINTPTR)&Bias[BJ*shape.cb*TILE];
+            seg[nseg].len  = blk_cols(BJ)*sizeof(float);
+            seg[nseg].ctrl = XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK;
+            nseg++;
+        }
+        for(int bk=0; bk<KTILES; bk++){
+            int first = nseg;
+            for(int r=0; r<blk_mt(BI) && send_a(BJ); r++){
+                seg[nseg].addr = (UINTPTR)tileA(Ap, BI*shape.cb+r, bk);
+                seg[nseg].len  = bytesA(BI*shape.cb+r, bk);
+                seg[nseg].ctrl = 0;
+                nseg++;
+            }
+            for(int c=0; c<blk_nt(BJ); c++){
+                seg[nseg].addr = (UINTPTR)tileB(Bp, bk, BJ*shape.cb+c);
+                seg[nseg].len  = bytesB(bk, BJ*shape.cb+c);
+                seg[nseg].ctrl = 0;
+                nseg++;
+            }
+            seg[first].ctrl  |= XAXIDMA_BD_CTRL_TXSOF_MASK;
+            seg[nseg-1].ctrl |= XAXIDMA_BD_CTRL_TXEOF_MASK;
+        }
+        PHASE(GEMM_PH_SUBMIT) rc = gemm_sg_submit(tx, seg, nseg, DMA_TIMEOUT);
+        if (rc!=0){
+            printf("MM2S SG submit fail\n");
+            return -1;
+        }
+    }
+
+    // (3) 모든 BD 완료 대기 + IP idle 확인
+    PHASE_TILE(-1);
+    PHASE(GEMM_PH_WAIT) rc = (gemm_sg_wait(tx, DMA_TIMEOUT)!=0 || gemm_sg_wait(rx, DMA_TIMEOUT)!=0);
+    if (rc){
+        printf("SG wait timeout\n");
+        return -1;
+    }
+    if (ip_wait_done(AP_IDLE)!=0){
+        printf("IP idle timeout\n");
+        return -1;
+    }
 
-            // (2) IP start
-            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 1);
+    return 0;
+}
+
+#if DMA_USE_IRQ
+// ---------------- HW GEMM: interrupt-driven async mode ----------------
+// DMA 완료 interrupt에서 다음 전송을 바로 시작 (gemm_dma_async) → busy-wait 없음
+//  - IP start는 SG mode와 같음 (JOB_QUEUE: 없음, MULTI_TILE: 1회, 아니면 auto-restart를 마지막 block 직전에 해제)
+//  - A row panel / C row panel (block 높이 CB*TILE rows)을 ping-pong 2개로 운용:
+//    block row BI가 전송되는 동안 CPU는 A panel BI+1 packing, C panel BI-1 unpack
+static XScuGic Intc;
+
+static float Apan[2][CB_MAX*TILE*MAXN] __attribute__((aligned(64)));
+static float Cpan[2][CB_MAX*TILE*MAXN] __attribute__((aligned(64)));
+static volatile int apan_free[2];     // panel의 마지막 MM2S 완료 (callback에서 set)
+static volatile int cpan_full[2];     // panel의 마지막 S2MM 완료 (callback에서 set)
+
+static void apan_done(void *ctx){ apan_free[(INTPTR)ctx] = 1; }
+static void cpan_done(void *ctx){ cpan_full[(INTPTR)ctx] = 1; }
+
+// row panel 안의 tile (br, bc) (rows x cols panel, tile-major row 순서, esz byte 원소)
+static inline void* panel_tile(void *pan, int rows, int cols, int br, int bc, int esz){
+    return (char*)pan + gemm_tile_off(rows, cols, TILE, GEMM_TILES_ROW_MAJOR, br, bc)*esz;
+}
 
-            // (3) Ktiles 프레임을 MM2S로 연속 전송 (각 512 floats)
-            for(int bk=0; bk<NB; bk++){
-                extract_block(A, bi, bk, A16);
-                extract_block(B, bk, bj, B16);
+static int gemm_hw_async(float *A, float *B, void *Bp, float *C){
+    int rc;
 
-                memcpy(&frame_buf[0],   A16, 256*sizeof(float));
-                memcpy(&frame_buf[256], B16, 256*sizeof(float));
+    // (0) B 전체 + A panel 0 packing
+    PHASE_TILE(-1);
+    pack_in(B, shape.k, shape.n, shape.n, GEMM_TILES_COL_MAJOR, Bp);
+    flush(Bp, shape.k*shape.n*ESZ);
+    pack_in(A, blk_rows(0), shape.k, shape.k, GEMM_TILES_ROW_MAJOR, Apan[0]);
+    flush(Apan[0], blk_rows(0)*shape.k*ESZ);
+    apan_free[0] = apan_free[1] = 1;
+    cpan_full[0] = cpan_full[1] = 0;
 
-                if(dma_send_frame(frame_buf)!=0){
-                    printf("MM2S frame send fail\n");
+    if (!JOB_QUEUE)
+        PHASE(GEMM_PH_POLL) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AUTO_RESTART ? (AP_AUTO_RESTART|AP_START) : AP_START);
+
+    for(int BI=0; BI<MB; BI++){
+        int s = BI & 1;
+        int h = blk_rows(BI);
+        apan_free[s] = 0;
+        cpan_full[s] = 0;
+        PHASE_TILE(BI*NB);
+        inval(Cpan[s], h*shape.n*sizeof(float));
+
+        // (1) block row BI 전송 예약: block마다 S2MM tile 수만큼 + [header] + [bias] + K step Ktiles개
+        //     (IRQ가 차례로 시작, 요청 queue가 차 있으면 submit 안에서 대기)
+        for(int BJ=0; BJ<NB; BJ++){
+            int t = BI*NB + BJ;
+            PHASE_TILE(t);
+            if (t == MB*NB-1 && AUTO_RESTART) {
+                // 마지막 block: 앞 block 출력 완료 = IP가 마지막 run으로 재시작됨
+                PHASE(GEMM_PH_WAIT) rc = gemm_async_wait(XAXIDMA_DEVICE_TO_DMA, 0, DMA_TIMEOUT);
+                if (rc!=0){
+                    printf("S2MM async wait fail\n");
                     return -1;
                 }
+                PHASE(GEMM_PH_POLL) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 0);    // auto-restart 해제
             }
 
-            // (4) S2MM 완료 대기 (여기서 out_buf 채워짐)
-            if(dma_wait_recv_done()!=0){
-                printf("S2MM wait timeout\n");
+            PHASE(GEMM_PH_SUBMIT) {
+                for(int q=0; q<out_tiles(t); q++){
+                    int bi, bj;
+                    out_tile(t, q, &bi, &bj);
+                    int last = (BJ == NB-1 && q == out_tiles(t)-1);
+                    if (gemm_async_recv(panel_tile(Cpan[s], h, shape.n, bi - BI*shape.cb, bj, sizeof(float)), bytesC(bi, bj),
+                                        last ? cpan_done : 0, (void*)(INTPTR)s, DMA_TIMEOUT)!=0){
+                        printf("S2MM async submit fail\n");
+                        return -1;
+                    }
+                }
+                if ((hdr_bytes() && gemm_async_send(BlkHdr[t], hdr_bytes(), 0, 0, DMA_TIMEOUT)!=0) ||
+                    (EPI_USE_BIAS && gemm_async_send(&Bias[BJ*shape.cb*TILE], blk_cols(BJ)*sizeof(float), 0, 0, DMA_TIMEOUT)!=0)){
+                    printf("MM2S async submit fail\n");
+                    return -1;
+                }
+                for(int bk=0; bk<KTILES; bk++){
+                    for(int r=0; r<blk_mt(BI) && send_a(BJ); r++){
+                        if (gemm_async_send(panel_tile(Apan[s], h, shape.k, r, bk, ESZ), bytesA(BI*shape.cb+r, bk), 0, 0, DMA_TIMEOUT)!=0){
+                            printf("MM2S async submit fail\n");
+                            return -1;
+                        }
+                    }
+                    for(int c=0; c<blk_nt(BJ); c++){
+                        int last = (BJ == NB-1 && bk == KTILES-1 && c == blk_nt(BJ)-1);
+                        if (gemm_async_send(tileB(Bp, bk, BJ*shape.cb+c), bytesB(bk, BJ*shape.cb+c),
+                                            last ? apan_done : 0, (void*)(INTPTR)s, DMA_TIMEOUT)!=0){
+                            printf("MM2S async submit fail\n");
+                            return -1;
+                        }
+                    }
+                }
+            }
+        }
+
+        // (2) block row BI가 전송되는 동안: 다음 A panel packing, 이전 C panel unpack
+        if (BI+1 < MB) {
+            PHASE_TILE((BI+1)*NB);
+            PHASE(GEMM_PH_WAIT) rc = gemm_async_wait_flag(&apan_free[s^1], DMA_TIMEOUT);
+            if (rc!=0){
+                printf("MM2S async wait fail\n");
+                return -1;
+            }
+            pack_in(A + (BI+1)*shape.cb*TILE*shape.k, blk_rows(BI+1), shape.k, shape.k, GEMM_TILES_ROW_MAJOR, Apan[s^1]);
+            flush(Apan[s^1], blk_rows(BI+1)*shape.k*ESZ);
+        }
+        if (BI > 0) {
+            PHASE_TILE((BI-1)*NB);
+            PHASE(GEMM_PH_WAIT) rc = gemm_async_wait_flag(&cpan_full[s^1], DMA_TIMEOUT);
+            if (rc!=0){
+                printf("S2MM async wait fail\n");
                 return -1;
             }
+            inval(Cpan[s^1], shape.cb*TILE*shape.n*sizeof(float));
+            PHASE(GEMM_PH_UNPACK)
+                gemm_unpack_tiles(Cpan[s^1], shape.cb*TILE, shape.n, TILE, GEMM_TILES_ROW_MAJOR, C + (BI-1)*shape.cb*TILE*shape.n, shape.n);
+        }
+    }
 
-            // (5) IP done도 확인(안전)
-            while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & 0x2));
+    // (3) 마지막 block row unpack + IP idle 확인
+    int s = (MB-1) & 1;
+    PHASE_TILE((MB-1)*NB);
+    PHASE(GEMM_PH_WAIT) rc = gemm_async_wait_flag(&cpan_full[s], DMA_TIMEOUT);
+    if (rc!=0){
+        printf("S2MM async wait fail\n");
+        return -1;
+    }
+    inval(Cpan[s], blk_rows(MB-1)*shape.n*sizeof(float));
+    PHASE(GEMM_PH_UNPACK)
+        gemm_unpack_tiles(Cpan[s], blk_rows(MB-1), shape.n, TILE, GEMM_TILES_ROW_MAJOR, C + (MB-1)*shape.cb*TILE*shape.n, shape.n);
+
+    PHASE_TILE(-1);
+    if (ip_wait_done(AP_IDLE)!=0){
+        printf("IP idle timeout\n");
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+// ---------------- GEMM 1회 구성 요소 ----------------
+// 입력 A, B, bias (현재 shape). fp16 / bf16 입력: A, B를 미리 같은 format으로 반올림
+// → SW 기준도 HW와 같은 입력으로 계산 (반올림된 값은 packing 때 다시 변환해도 그대로)
+static void make_inputs(float *A, float *B){
+    for(int i=0;i<shape.m;i++)
+        for(int j=0;j<shape.k;j++)
+            A[idx(i,j,shape.k)] = i + j*0.1f;
+    for(int i=0;i<shape.k;i++)
+        for(int j=0;j<shape.n;j++)
+            B[idx(i,j,shape.n)] = j + i*0.2f;
+    for(int j=0;j<shape.n;j++)
+        Bias[j] = (j % 7) * 50.0f - 150.0f;
+
+    if (FMT != FMT_FP32) {
+        static uint16_t hbuf[MAXN*MAXN];
+        float *mats[2] = { A, B };
+        int    cnt[2]  = { shape.m*shape.k, shape.k*shape.n };
+        for(int m=0; m<2; m++){
+            gemm_f32_to_half(mats[m], hbuf, cnt[m], (gemm_fmt_t)FMT);
+            for(int i=0; i<cnt[m]; i++) mats[m][i] = gemm_half_to_f32(hbuf[i], (gemm_fmt_t)FMT);
+        }
+    }
+}
+
+// IP 설정 (현재 shape / C block)
+//  JOB_QUEUE: Ktiles / Ntiles / amode / edge / epilogue / fmt / cblock는 descriptor가 대신함,
+//  Jtiles / alpha만 사용 → IP가 동작 중에 shape를 바꿔도 됨
+static void ip_config(void){
+    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
+    Xil_Out32(GEMM_CTRL_BASE+REG_NTILES, MULTI_TILE ? MB*NB : 1);
+    Xil_Out32(GEMM_CTRL_BASE+REG_CBLK, shape.cb | (shape.cb << 4));
+    // MULTI_TILE / auto-restart (SG / async): IP가 block row의 첫 block을 스스로 LOAD로 처리
+    // (block counter는 row마다 0으로 돌아옴, MULTI_TILE=0 simple mode는 block마다 LOAD/REUSE 지정)
+    Xil_Out32(GEMM_CTRL_BASE+REG_AMODE, USE_A_PANEL ? AMODE_ROW : AMODE_STREAM);
+    Xil_Out32(GEMM_CTRL_BASE+REG_JTILES, NB);
+    Xil_Out32(GEMM_CTRL_BASE+REG_EDGE, EDGE);
+    if (hdr_bytes()) make_blk_hdrs();
+    // epilogue: act(C + bias)는 IP가 send 직전에 적용 → host의 C 후처리 pass 없음
+    u32 alpha_bits;
+    float alpha = LEAKY_ALPHA;
+    memcpy(&alpha_bits, &alpha, sizeof(u32));
+    Xil_Out32(GEMM_CTRL_BASE+REG_EPI, EPI_ACT | (EPI_USE_BIAS ? EPI_BIAS : 0));
+    Xil_Out32(GEMM_CTRL_BASE+REG_ALPHA, alpha_bits);
+    Xil_Out32(GEMM_CTRL_BASE+REG_FMT, FMT);
+    if (EPI_USE_BIAS) flush(Bias, shape.n*sizeof(float));
+    Xil_Out32(GEMM_CTRL_BASE+REG_JOBS, JOB_QUEUE);
+}
+
+// HW GEMM 1회 = 측정 구간: packing + 전송 + unpack
+typedef struct {
+    int    dma_mode;
+    float *A, *B, *Chw;
+    void  *Ap, *Bp;
+    float *Cp;
+} hw_run_t;
+
+static int gemm_hw(void *ctx){
+    hw_run_t *h = (hw_run_t*)ctx;
+    int rc;
+#if DMA_USE_IRQ
+    if (h->dma_mode == DMA_ASYNC) {
+        // A panel packing / C panel unpack을 전송과 겹쳐서 수행
+        return gemm_hw_async(h->A, h->B, h->Bp, h->Chw);
+    }
+#endif
+    // (0) A, B를 1회만 tile-major로 packing (fp16 / bf16은 이때 변환)
+    PHASE_TILE(-1);
+    pack_in(h->A, shape.m, shape.k, shape.k, GEMM_TILES_ROW_MAJOR, h->Ap);
+    pack_in(h->B, shape.k, shape.n, shape.n, GEMM_TILES_COL_MAJOR, h->Bp);
 
-            // (6) 타일 저장
-            inval(out_buf, 256*sizeof(float));
-            store_block(Chw, bi, bj, out_buf);
+    // packed 행렬 전체를 1회만 flush / invalidate (simple / SG 공통, 전송마다 cache 작업 없음)
+    flush(h->Ap, shape.m*shape.k*ESZ);
+    flush(h->Bp, shape.k*shape.n*ESZ);
+    inval(h->Cp, shape.m*shape.n*sizeof(float));
+
+    rc = (h->dma_mode == DMA_SG) ? gemm_hw_sg(h->Ap, h->Bp, h->Cp) : gemm_hw_simple(h->Ap, h->Bp, h->Cp);
+    if (rc == 0) inval(h->Cp, shape.m*shape.n*sizeof(float));     // S2MM 중 prefetch된 line 제거
+
+    // (6) packed C → row-major Chw 1회 unpack
+    PHASE_TILE(-1);
+    if (rc == 0) PHASE(GEMM_PH_UNPACK) gemm_unpack_tiles(h->Cp, shape.m, shape.n, TILE, GEMM_TILES_ROW_MAJOR, h->Chw, shape.n);
+    return rc;
+}
+
+// GEMM 1회의 DMA 전송량 (byte): MM2S = block마다 [descriptor / header] + [bias] + K step의 A / B tile,
+// S2MM = C 전체
+static double hw_bytes(void){
+    double bytes = (double)shape.m*shape.n*sizeof(float);
+    for(int t=0; t<MB*NB; t++){
+        int BI = t / NB, BJ = t % NB;
+        bytes += hdr_bytes() + (EPI_USE_BIAS ? blk_cols(BJ)*sizeof(float) : 0);
+        for(int bk=0; bk<KTILES; bk++){
+            for(int r=0; r<blk_mt(BI) && send_a(BJ); r++) bytes += bytesA(BI*shape.cb+r, bk);
+            for(int c=0; c<blk_nt(BJ); c++)               bytes += bytesB(bk, BJ*shape.cb+c);
         }
     }
+    return bytes;
+}
 
+// 결과 검증 (SW 기준)
+static float max_abs_err(const float *Chw, const float *Csw){
+    float max_err=0;
+    for(int i=0;i<shape.m*shape.n;i++){
+        float e=fabsf(Chw[i]-Csw[i]);
+        if(e>max_err) max_err=e;
+    }
+    return max_err;
+}
+
+#if BENCH
+// ---------------- benchmark sweep (gemm_bench) ----------------
+// 정방 N x N x N shape마다 C block variant (cblock 1 / 2)별로: SW 기준 1회 → warm-up → reps회 측정
+//  → min / median / p95 / p99, GFLOPS, 전송량 출력 + CSV / JSON
+//  Host_Emu: ./host --sizes 32,64,128 --variants 1,2 --reps 50 --csv m4.csv --json m4.json
+//  보드 (argc = 0): 기본 sweep, CSV는 UART ("csv," prefix)
+static int bench_main(int argc, char **argv, hw_run_t *hw, float *Csw){
+    static gemm_bench_result_t res[GEMM_BENCH_MAX_LIST*GEMM_BENCH_MAX_LIST];
+    static char tag[64];
+    gemm_bench_cfg_t cfg;
+    int n = 0;
+
+    gemm_bench_defaults(&cfg);
+    cfg.variants[0] = 1;
+    cfg.variants[1] = 2;
+    cfg.nvariants   = 2;
+    snprintf(tag, sizeof(tag), "Matmul_4/%s", (hw->dma_mode == DMA_SG) ? "sg" : (hw->dma_mode == DMA_ASYNC) ? "async" : "simple");
+    cfg.tag = tag;
+    if (gemm_bench_parse(&cfg, argc, argv)!=0) return -1;
+    printf("Bench warm-up %d, reps %d, tag %s\n", cfg.warmup, cfg.reps, cfg.tag);
+
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+
+    for(int i=0; i<cfg.nsizes; i++)
+        for(int v=0; v<cfg.nvariants; v++){
+            int sz = cfg.sizes[i], cb = cfg.variants[v];
+            if (sz > MAXN || cb > CB_MAX || (FMT != FMT_FP32 && (sz % 2))) {
+                printf("skip N=%d cblock %d\n", sz, cb);
+                continue;
+            }
+            shape.m = shape.n = shape.k = sz;
+            shape.cb = cb;
+
+            make_inputs(hw->A, hw->B);
+            gemm_sw(hw->A, hw->B, Csw);
+            ip_config();
+
+            gemm_bench_result_t *r = &res[n++];
+            memset(r, 0, sizeof(*r));
+            r->m = shape.m; r->n = shape.n; r->k = shape.k; r->variant = shape.cb;
+            if (gemm_bench_time(&cfg, gemm_hw, hw, r)!=0) return -1;
+            r->bytes   = hw_bytes();
+            r->max_err = max_abs_err(hw->Chw, Csw);    // 마지막 반복의 결과
+            gemm_bench_rates(r);
+            gemm_bench_print(r, n == 1);
+#if TRACE_PHASES
+            // 측정 뒤 1회 더: 이 point의 phase 구성 (host 작업 vs DMA / PL 대기)
+            XTime t0, t1;
+            gemm_trace_reset();
+            XTime_GetTime(&t0);
+            if (gemm_hw(hw)!=0) return -1;
+            XTime_GetTime(&t1);
+            gemm_trace_print(cycles_to_us(t1-t0));
+#endif
+        }
+
+    gemm_bench_write_csv(&cfg, res, n);
+    gemm_bench_write_json(&cfg, res, n);
+    return 0;
+}
+#endif
+
+int main(int argc, char **argv){
+#if BENCH
+    printf("\n===== GEMM benchmark sweep =====\n");
+#else
+    if (shape.m == shape.n && shape.k == shape.n)
+        printf("\n===== GEMM (N=%d) correct Ktiles protocol =====\n", shape.n);
+    else
+        printf("\n===== GEMM (M=%d, K=%d, N=%d) correct Ktiles protocol =====\n", shape.m, shape.k, shape.n);
+#endif
+    XAxiDma_Config* cfg = XAxiDma_LookupConfig(DMA_DEV_ID);
+    XAxiDma_CfgInitialize(&AxiDma,cfg);
+
+    // SG engine이 있으면 BD ring, 없으면 IRQ async (연결된 경우) 또는 polling simple mode
+    int dma_mode = DMA_SIMPLE;
+    if (XAxiDma_HasSg(&AxiDma)) {
+        if (gemm_sg_setup(&AxiDma, TxBds, SG_TX_BDS, RxBds, SG_RX_BDS)!=0){
+            printf("SG ring setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_SG;
+    }
+#if DMA_USE_IRQ
+    else {
+        if (gemm_async_init(&AxiDma, &Intc, XPAR_SCUGIC_SINGLE_DEVICE_ID,
+                            XPAR_FABRIC_AXIDMA_0_MM2S_INTROUT_VEC_ID,
+                            XPAR_FABRIC_AXIDMA_0_S2MM_INTROUT_VEC_ID)!=0){
+            printf("DMA interrupt setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_ASYNC;
+    }
+#endif
+    printf("DMA %s\n", dma_mode_name[dma_mode]);
+
+    static float A[MAXN*MAXN] __attribute__((aligned(64)));
+    static float B[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Csw[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Chw[MAXN*MAXN] __attribute__((aligned(64)));
+
+    // tile-major packed buffers (DMA가 직접 읽고 씀): 1 MB section 정렬 pool 1개
+    //  → BUF_MODE로 pool 전체를 non-cacheable / ACP region으로 지정하면 flush / invalidate가 없어짐
+    static u8 DmaPool[DMA_POOL_BYTES] __attribute__((aligned(GEMM_BUF_SECTION)));
+    float *Ap = (float*)DmaPool;
+    float *Bp = Ap + MAXN*MAXN;
+    float *Cp = Bp + MAXN*MAXN;
+    if (gemm_buf_region(DmaPool, sizeof(DmaPool), (gemm_buf_mode_t)BUF_MODE)!=0){
+        printf("DMA buffer region setup fail\n");
+        return -1;
+    }
+    printf("Buffers %s\n", gemm_buf_mode_name((gemm_buf_mode_t)BUF_MODE));
+
+    hw_run_t hw = { dma_mode, A, B, Chw, Ap, Bp, Cp };
+
+    if (FMT != FMT_FP32)
+        printf("Input %s (%s)\n", (FMT == FMT_FP16) ? "fp16" : "bf16", gemm_half_impl_name((gemm_fmt_t)FMT));
+
+    make_inputs(A, B);
+
+#if BENCH
+    // job queue: persistent IP, 여기서 1회만 start (auto-restart → end-of-queue 없이 계속 다음 descriptor 대기)
+    ip_config();
+    if (JOB_QUEUE) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_AUTO_RESTART|AP_START);
+    return bench_main(argc, argv, &hw, Csw);
+#else
+    (void)argc; (void)argv;
+
+    // SW: naive ijk (기존 기준)
+    XTime t0,t1;
+    sgemm_set_impl(SGEMM_NAIVE);
+    XTime_GetTime(&t0);
+    gemm_sw(A,B,Csw);
     XTime_GetTime(&t1);
-    double hw_us=cycles_to_us(t1-t0);
+    double sw_naive_us=cycles_to_us(t1-t0);
+
+    // SW: packed panel + SIMD micro-kernel + threads (정직한 CPU 기준)
+    //  첫 호출은 pack buffer malloc / thread 생성 포함 → warm-up 1회 뒤 SW_REPS회 중 최소 (routing의 CPU rate)
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+    gemm_sw(A,B,Csw);
+    double sw_us=0;
+    for(int r=0; r<SW_REPS; r++){
+        XTime_GetTime(&t0);
+        gemm_sw(A,B,Csw);
+        XTime_GetTime(&t1);
+        double us=cycles_to_us(t1-t0);
+        if (r==0 || us<sw_us) sw_us=us;
+    }
+
+    double flops = 2.0 * (double)shape.m * (double)shape.n * (double)shape.k;
 
-    double flops = 2.0 * (double)N * (double)N * (double)N;
+    printf("SW(naive) %.3f us\n", sw_naive_us);
+    printf("SW(%s x%d) %.3f us\n", sgemm_impl_name(SGEMM_SIMD), sgemm_get_threads(), sw_us);
+
+    // CPU / PL 선택 (HW 실행 전): 위 sgemm_cpu 측정 rate vs PL rate + 호출당 고정 비용 (edge tile은 IP가 처리 → shape 제약 없음)
+    sgemm_route_t route = { TILE, flops/(sw_us*1e3), ROUTE_ACCEL_GFLOPS, ROUTE_ACCEL_FIXED_US, 1 };
+    int to_cpu = ROUTE && sgemm_route_to_cpu(&route, shape.m, shape.n, shape.k);
+    if (ROUTE)
+        printf("Route %s (CPU %.3f GFLOPS, PL %.3f GFLOPS + %.1f us)\n", to_cpu ? "CPU" : "PL",
+               route.cpu_gflops, route.accel_gflops, route.accel_fixed_us);
+    if (to_cpu) {
+        // PL 미사용: 같은 sgemm_cpu 설정 (SIMD, SW_THREADS)으로 결과 계산
+        XTime_GetTime(&t0);
+        gemm_sw(A,B,Chw);
+        XTime_GetTime(&t1);
+        printf("CPU %.3f us\n", cycles_to_us(t1-t0));
+        printf("max_abs_err %.6f\n", max_abs_err(Chw, Csw));
+        return 0;
+    }
+
+    // job queue: persistent IP, routing 뒤 (PL일 때만) 1회 start (auto-restart → end-of-queue 없이 계속 다음 descriptor 대기)
+    ip_config();
+    if (JOB_QUEUE) Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_AUTO_RESTART|AP_START);
+
+    u32 perf0[PERF_NUM], perf1[PERF_NUM];
+    if (PERF_COUNTERS) perf_read(perf0);
+
+    // HW
+    if (TRACE_PHASES) gemm_trace_reset();
+    XTime_GetTime(&t0);
+    if (gemm_hw(&hw) != 0) return -1;
+    XTime_GetTime(&t1);
+    double hw_us=cycles_to_us(t1-t0);
+    if (PERF_COUNTERS) perf_read(perf1);
 
-    printf("SW %.3f us\n", sw_us);
     printf("HW %.3f us\n", hw_us);
-    printf("Speedup %.2fx\n", sw_us/hw_us);
+    if (PERF_COUNTERS) perf_print(perf0, perf1, hw_us);
+    if (TRACE_PHASES) {
+        gemm_trace_print(hw_us);
+        gemm_trace_write_chrome(TRACE_FILE);
+    }
+    printf("Speedup %.2fx (vs naive %.2fx)\n", sw_us/hw_us, sw_naive_us/hw_us);
     printf("GFLOPS %.3f\n", flops/(hw_us*1e-6)/1e9);
+    printf("DMA %.3f MB (%.3f GB/s)\n", hw_bytes()/1e6, hw_bytes()/(hw_us*1e3));
+
+    printf("max_abs_err %.6f\n", max_abs_err(Chw, Csw));
 
     return 0;
+#endif
 }
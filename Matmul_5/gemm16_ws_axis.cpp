@@ -0,0 +1,277 @@
+// ================================================================
+// gemm16_ws_axis.cpp  (Weight-Stationary version)
+//  - Target: Zynq-7000 (xc7z020) @ 100MHz class
+//  - AXI4-Stream in/out (32-bit float packed in TDATA)
+//  - AXI-Lite control: cmd, Ktiles, Jtiles, Mtiles
+//
+//  - Inference use: the weight matrix W (K x N) is the same for every
+//    request, only the activations X (M x K) change. W is loaded into
+//    an on-chip block once (CMD_LOAD_W), then any number of X row
+//    tiles are streamed through it (CMD_RUN): per-inference traffic
+//    is activations in + results out only
+//
+//  - Key optimizations:
+//    1) WEIGHT BLOCK ON CHIP: W(0..Ktiles-1, 0..Jtiles-1) tiles in
+//       W_blk[WT_MAX], kept across invocations
+//    2) DOUBLE BUFFERING: recv of the next X tile overlaps the MAC of
+//       the current one, and the send of a finished C row overlaps
+//       the MAC of the next row (ping-pong C) - one DATAFLOW loop
+//       over all Mtiles*Ktiles X tiles, no bubble between rows
+//    3) MANUAL ADDER TREE: 8-way MAC chunk with balanced tree
+//
+//  - Protocol:
+//      CMD_LOAD_W: Input : Jtiles*Ktiles W tiles (256 words each),
+//                          column panel order: W(0..Kt-1, 0), W(0..Kt-1, 1), ...
+//                  Output: none
+//                  (Ktiles, Jtiles are latched for the following runs)
+//      CMD_RUN   : Input : Mtiles row panels X(m, 0..Kt-1) = Kt*256 words each
+//                  Output: Mtiles rows C(m, 0..Jt-1) = Jt*256 words each,
+//                          TLAST asserted on the last word of every row
+//      Input TLAST is ignored (no axis_tlast_gen needed)
+//
+//  - Limits: Ktiles*Jtiles <= WT_MAX, Jtiles <= JT_MAX
+//    (else LOAD_W consumes nothing; RUN before a valid LOAD_W does nothing)
+//
+//  - CSIM-safe float<->u32 bitcast via memcpy
+// ================================================================
+
+#include <hls_stream.h>
+#include <ap_int.h>
+#include <ap_axi_sdata.h>
+#include <cstring>
+#include <stdint.h>
+
+#define N 16
+#define KCHUNK 8
+#define WT_MAX 128       // weight block size in tiles (128 KB)
+#define JT_MAX 8         // output tiles per row (C ping-pong depth)
+
+#define CMD_LOAD_W 0
+#define CMD_RUN    1
+
+typedef ap_axiu<32, 0, 0, 0> axis_t;
+
+// ------------------------------
+// CSIM-safe bit reinterpretation
+// ------------------------------
+static inline float u32_to_f(ap_uint<32> u) {
+#pragma HLS INLINE
+    float f;
+    uint32_t tmp = (uint32_t)u.to_uint();
+    std::memcpy(&f, &tmp, sizeof(float));
+    return f;
+}
+static inline ap_uint<32> f_to_u32(float f) {
+#pragma HLS INLINE
+    uint32_t tmp;
+    std::memcpy(&tmp, &f, sizeof(uint32_t));
+    return ap_uint<32>(tmp);
+}
+
+// ------------------------------
+// 8-way adder-tree reduction
+// ------------------------------
+static inline float reduce8_tree(float p0, float p1, float p2, float p3,
+                                 float p4, float p5, float p6, float p7) {
+#pragma HLS INLINE
+    float s0 = p0 + p1;
+    float s1 = p2 + p3;
+    float s2 = p4 + p5;
+    float s3 = p6 + p7;
+    float s4 = s0 + s1;
+    float s5 = s2 + s3;
+    return s4 + s5;
+}
+
+// ==============================================================
+// Sub-functions
+// ==============================================================
+
+// ---- Load Jtiles*Ktiles W tiles into the on-chip block ----
+// stream order j-major: tile t = j*Ktiles + k
+static void load_weights(
+    hls::stream<axis_t>& s_in,
+    float W_blk[WT_MAX][N][N],
+    int   ntiles)
+{
+    for (int t = 0; t < ntiles; t++) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+                axis_t w = s_in.read();
+                W_blk[t][i][j] = u32_to_f(w.data);
+            }
+        }
+    }
+}
+
+// ---- Receive one X tile (256 floats) into a ping-pong buffer ----
+static void recv_x(
+    hls::stream<axis_t>& s_in,
+    float X[N][N])
+{
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+            axis_t w = s_in.read();
+            X[i][j] = u32_to_f(w.data);
+        }
+    }
+}
+
+// ---- MAC: C[j] (+)= X * W(k, j) for all Jtiles output tiles ----
+// first: k == 0, C[j] is overwritten (no separate clear pass)
+static void mac_row(
+    float X[N][N],
+    float W_blk[WT_MAX][N][N],
+    float C[JT_MAX][N][N],
+    int   k,
+    int   Ktiles,
+    int   Jtiles,
+    bool  first)
+{
+#pragma HLS ARRAY_PARTITION variable=X complete dim=2
+#pragma HLS ARRAY_PARTITION variable=C complete dim=3
+
+    for (int jt = 0; jt < Jtiles; jt++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=JT_MAX
+        int w = jt * Ktiles + k;
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+
+                float sum = 0.0f;
+
+                for (int kb = 0; kb < N; kb += KCHUNK) {
+#pragma HLS UNROLL
+                    float p0 = X[i][kb+0] * W_blk[w][kb+0][j];
+                    float p1 = X[i][kb+1] * W_blk[w][kb+1][j];
+                    float p2 = X[i][kb+2] * W_blk[w][kb+2][j];
+                    float p3 = X[i][kb+3] * W_blk[w][kb+3][j];
+                    float p4 = X[i][kb+4] * W_blk[w][kb+4][j];
+                    float p5 = X[i][kb+5] * W_blk[w][kb+5][j];
+                    float p6 = X[i][kb+6] * W_blk[w][kb+6][j];
+                    float p7 = X[i][kb+7] * W_blk[w][kb+7][j];
+
+                    float part = reduce8_tree(p0,p1,p2,p3,p4,p5,p6,p7);
+                    sum += part;
+                }
+
+                C[jt][i][j] = first ? sum : C[jt][i][j] + sum;
+            }
+        }
+    }
+}
+
+// ---- Send one C row (Jtiles tiles), TLAST on the last word ----
+static void send_row(
+    float C[JT_MAX][N][N],
+    int   Jtiles,
+    hls::stream<axis_t>& s_out)
+{
+    for (int jt = 0; jt < Jtiles; jt++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=JT_MAX
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+                axis_t o;
+                o.data = f_to_u32(C[jt][i][j]);
+                o.keep = (ap_uint<4>)0xF;
+                o.strb = (ap_uint<4>)0xF;
+                o.user = 0;
+                o.id   = 0;
+                o.dest = 0;
+                o.last = ((jt == Jtiles-1) && (i == N-1) && (j == N-1)) ? 1 : 0;
+                s_out.write(o);
+            }
+        }
+    }
+}
+
+// ==============================================================
+// Top: Weight-Stationary GEMM16
+// ==============================================================
+void gemm16_ws_axis(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int cmd,
+    int Ktiles,
+    int Jtiles,
+    int Mtiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=cmd    bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Jtiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=Mtiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    // ---- On-chip weight block, kept across invocations ----
+    static float W_blk[WT_MAX][N][N];
+#pragma HLS ARRAY_PARTITION variable=W_blk complete dim=2
+    static int w_kt = 0;             // Ktiles / Jtiles of the loaded block
+    static int w_jt = 0;
+
+    if (cmd == CMD_LOAD_W) {
+        if (Ktiles <= 0 || Jtiles <= 0 || Jtiles > JT_MAX || Ktiles * Jtiles > WT_MAX) {
+            w_kt = w_jt = 0;
+            return;
+        }
+        load_weights(s_in, W_blk, Ktiles * Jtiles);
+        w_kt = Ktiles;
+        w_jt = Jtiles;
+        return;
+    }
+
+    if (cmd != CMD_RUN || w_kt == 0 || Mtiles <= 0) return;
+
+    const int Kt = w_kt;
+    const int Jt = w_jt;
+    const int T  = Mtiles * Kt;      // X tiles in this run
+
+    // ---- Ping-pong X and C buffers ----
+    float X_buf[2][N][N];
+    float C_buf[2][JT_MAX][N][N];
+
+#pragma HLS ARRAY_PARTITION variable=X_buf complete dim=3
+#pragma HLS ARRAY_PARTITION variable=C_buf complete dim=4
+
+    // ================================================================
+    // Flattened pipeline over all X tiles t = m*Kt + k:
+    //
+    //  phase p : recv X(t=p)  ||  MAC X(t=p-1)  ||  send C row of t=p-2
+    //                                               (if t was the last k)
+    //
+    //  Total phases = T + 2 (recv prolog, MAC + send epilog).
+    //  MAC writes C_buf[m & 1] while send reads the previous row's
+    //  buffer, so rows follow each other without a drain.
+    // ================================================================
+    for (int phase = 0; phase < T + 2; phase++) {
+
+        const int tm = phase - 1;        // tile in MAC
+        const int ts = phase - 2;        // tile whose row may be sent
+
+        bool do_recv    = (phase < T);
+        bool do_compute = (tm >= 0 && tm < T);
+        bool do_send    = (ts >= 0 && (ts % Kt) == Kt - 1);
+
+#pragma HLS DATAFLOW
+
+        // Stage 1: next X tile -> X_buf[ping]
+        if (do_recv) {
+            recv_x(s_in, X_buf[phase & 1]);
+        }
+
+        // Stage 2: MAC previous X tile into its row's C buffer
+        if (do_compute) {
+            mac_row(X_buf[tm & 1], W_blk, C_buf[(tm / Kt) & 1],
+                    tm % Kt, Kt, Jt, (tm % Kt) == 0);
+        }
+
+        // Stage 3: send the finished row
+        if (do_send) {
+            send_row(C_buf[(ts / Kt) & 1], Jt, s_out);
+        }
+    }
+}
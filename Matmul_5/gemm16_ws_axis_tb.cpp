@@ -0,0 +1,179 @@
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <hls_stream.h>
+#include <ap_axi_sdata.h>
+#include <ap_int.h>
+
+#define N 16
+#define EPS 0.005
+
+// ⭐ 매크로 대신 const 사용 (CSIM 안전)
+const int Ktiles_tb = 3;
+const int Jtiles_tb = 2;
+const int Mtiles_tb = 4;
+
+typedef ap_axiu<32,0,0,0> axis_t;
+
+// cmd (CTRL)
+#define CMD_LOAD_W 0
+#define CMD_RUN    1
+
+// DUT prototype
+void gemm16_ws_axis(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int cmd,
+    int Ktiles,
+    int Jtiles,
+    int Mtiles
+);
+
+// =====================================================
+// bit cast helpers (CSIM-safe)
+// =====================================================
+static inline ap_uint<32> f2u(float f){
+    uint32_t tmp;
+    std::memcpy(&tmp, &f, sizeof(float));
+    return ap_uint<32>(tmp);
+}
+
+static inline float u2f(ap_uint<32> u){
+    uint32_t tmp = u.to_uint();
+    float f;
+    std::memcpy(&f, &tmp, sizeof(float));
+    return f;
+}
+
+static void push_tile(hls::stream<axis_t>& s, float M[N][N])
+{
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++){
+            axis_t w;
+            w.data = f2u(M[i][j]);
+            w.keep = 0xF;
+            w.strb = 0xF;
+            w.user = 0;
+            w.id   = 0;
+            w.dest = 0;
+            w.last = (i==N-1 && j==N-1) ? 1 : 0;
+            s.write(w);
+        }
+}
+
+// =====================================================
+// Test data: W(k, j) tiles, X(m, k) tiles
+// =====================================================
+static float W[Jtiles_tb][Ktiles_tb][N][N];
+static float X[2][Mtiles_tb][Ktiles_tb][N][N];      // two batches
+
+// C(m, j) = sum_k X(m,k) * W(k,j)
+static float ref_elem(int b, int m, int jt, int i, int j)
+{
+    float s = 0;
+    for(int kt=0; kt<Ktiles_tb; kt++)
+        for(int k=0; k<N; k++)
+            s += X[b][m][kt][i][k] * W[jt][kt][k][j];
+    return s;
+}
+
+// One RUN of Mt rows from batch b; checks values and TLAST (row end only)
+static bool run_batch(int b, int Mt, float &max_err)
+{
+    hls::stream<axis_t> s_in, s_out;
+    for(int m=0; m<Mt; m++)
+        for(int kt=0; kt<Ktiles_tb; kt++)
+            push_tile(s_in, X[b][m][kt]);
+
+    gemm16_ws_axis(s_in, s_out, CMD_RUN, 0, 0, Mt);
+
+    if(!s_in.empty()) { std::cout << "RUN: input left over\n"; return false; }
+    if((int)s_out.size() != Mt*Jtiles_tb*N*N) {
+        std::cout << "RUN: output size " << s_out.size() << "\n";
+        return false;
+    }
+
+    bool tlast_ok = true;
+    for(int m=0; m<Mt; m++)
+        for(int jt=0; jt<Jtiles_tb; jt++)
+            for(int i=0;i<N;i++)
+                for(int j=0;j<N;j++){
+                    axis_t o = s_out.read();
+                    float e = fabs(ref_elem(b, m, jt, i, j) - u2f(o.data));
+                    if(e > max_err) max_err = e;
+                    bool last = (jt==Jtiles_tb-1 && i==N-1 && j==N-1);
+                    if((int)o.last != (int)last) tlast_ok = false;
+                }
+    if(!tlast_ok) std::cout << "RUN: TLAST placement mismatch\n";
+    return tlast_ok;
+}
+
+// =====================================================
+// Main Testbench
+// =====================================================
+int main()
+{
+    std::cout << "\n===== GEMM16_WS_AXIS CSIM TEST =====\n";
+
+    for(int jt=0; jt<Jtiles_tb; jt++)
+        for(int kt=0; kt<Ktiles_tb; kt++)
+            for(int i=0;i<N;i++)
+                for(int j=0;j<N;j++)
+                    W[jt][kt][i][j] = j*0.3f + i*0.2f - kt*0.4f + jt;
+    for(int b=0; b<2; b++)
+        for(int m=0; m<Mtiles_tb; m++)
+            for(int kt=0; kt<Ktiles_tb; kt++)
+                for(int i=0;i<N;i++)
+                    for(int j=0;j<N;j++)
+                        X[b][m][kt][i][j] = i*0.5f - j*0.1f + kt + m*0.7f - b*1.3f;
+
+    bool ok = true;
+
+    // -------------------------------------------------
+    // LOAD_W: out-of-range block consumes nothing
+    // -------------------------------------------------
+    {
+        hls::stream<axis_t> s_in, s_out;
+        push_tile(s_in, W[0][0]);
+        gemm16_ws_axis(s_in, s_out, CMD_LOAD_W, 64, 4, 0);   // 256 tiles > WT_MAX
+        if(s_in.size() != (size_t)(N*N) || !s_out.empty()) {
+            std::cout << "LOAD_W: oversized block not rejected\n";
+            ok = false;
+        }
+    }
+
+    // -------------------------------------------------
+    // LOAD_W: column panel order W(0..Kt-1, j)
+    // -------------------------------------------------
+    {
+        hls::stream<axis_t> s_in, s_out;
+        for(int jt=0; jt<Jtiles_tb; jt++)
+            for(int kt=0; kt<Ktiles_tb; kt++)
+                push_tile(s_in, W[jt][kt]);
+        gemm16_ws_axis(s_in, s_out, CMD_LOAD_W, Ktiles_tb, Jtiles_tb, 0);
+        if(!s_in.empty() || !s_out.empty()) {
+            std::cout << "LOAD_W: stream mismatch\n";
+            ok = false;
+        }
+    }
+
+    // -------------------------------------------------
+    // RUN: two batches against the same weights
+    // (Mtiles=1 exercises the single-row epilog)
+    // -------------------------------------------------
+    float max_err = 0;
+    ok &= run_batch(0, Mtiles_tb, max_err);
+    ok &= run_batch(1, Mtiles_tb, max_err);
+    ok &= run_batch(1, 1, max_err);
+
+    std::cout << "Weight-stationary: W words = " << Jtiles_tb*Ktiles_tb*N*N
+              << " once, X words per batch = " << Mtiles_tb*Ktiles_tb*N*N
+              << ", max error = " << max_err << std::endl;
+
+    if(ok && max_err < EPS)
+        std::cout << "\nPASS ✅\n";
+    else
+        std::cout << "\nFAIL ❌\n";
+
+    return 0;
+}
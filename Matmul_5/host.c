@@ -0,0 +1,338 @@
+/********************************************************************
+ * Weight-Stationary GEMM Host (batched inference, gemm16_ws_axis IP)
+ *  - C(M x N) = X(M x N) * W(N x N), N = 16*k, M = 16*m (batch rows)
+ *  - W: fixed weights, packed ONCE in column panel order (gemm_pack)
+ *    and loaded into the IP's on-chip block with CMD_LOAD_W
+ *    (block = Ktiles x JT column tiles, JT = min(NB, JT_MAX, WT_MAX/Ktiles))
+ *  - X: NBATCH batches of activations, streamed with CMD_RUN
+ *      MM2S : X row panel (Ktiles tiles of 256 floats) per output row
+ *      S2MM : C row (JT tiles, one TLAST) per output row
+ *  - Weights fit in one block (N <= 128 at JT_MAX=8): loaded once,
+ *    every batch after the first moves activations / results only.
+ *    Otherwise each block is reloaded once per batch
+ *  - DMA mode (XAxiDma_HasSg at runtime):
+ *      simple : 1 row per run, SimpleTransfer + busy-wait
+ *      SG     : up to SG_RX_BDS rows per run as BD chains
+ *  - Cache maintenance (gemm_buf): W flushed once after packing,
+ *    X flushed / C invalidated once per batch, none per transfer
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "xparameters.h"
+#include "xaxidma.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "xil_io.h"
+
+#include "sgemm_cpu.h"
+#include "gemm_pack.h"
+#include "gemm_dma_sg.h"
+#include "gemm_buf.h"
+
+#ifndef N
+#define N 128             // 16의 배수 (에뮬레이션 빌드에서는 -DN=... 로 지정)
+#endif
+#ifndef M
+#define M 64              // batch 당 activation row 수 (16의 배수)
+#endif
+#ifndef NBATCH
+#define NBATCH 4          // 같은 weight로 처리할 batch 수
+#endif
+#define TILE 16           // 가속기 자체는 16*16 행렬 곱셈 & 누적
+#define NB (N/TILE)       // W의 tile 수 (한 차원)
+#define MB (M/TILE)       // X의 row tile 수
+#define KTILES NB
+
+#define MAXN 256*3        // 최대 행렬의 크기
+#define MAXM 256          // 최대 batch row 수
+#define DMA_DEV_ID XPAR_AXIDMA_0_DEVICE_ID
+#define GEMM_CTRL_BASE XPAR_GEMM16_WS_AXIS_0_S_AXI_CTRL_BASEADDR
+
+#define REG_AP_CTRL  0x00
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define REG_CMD      0x10    // CMD_LOAD_W / CMD_RUN
+#define REG_KTILES   0x18    // LOAD_W: weight block의 K 방향 tile 수
+#define REG_JTILES   0x20    // LOAD_W: weight block의 column tile 수
+#define REG_MTILES   0x28    // RUN: 처리할 X row tile 수
+
+#define CMD_LOAD_W 0
+#define CMD_RUN    1
+
+#define WT_MAX 128           // IP 내부 weight block 크기 (tile 수)
+#define JT_MAX 8             // row 당 최대 output tile 수
+
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#define JT MIN(MIN(NB, JT_MAX), WT_MAX/KTILES)    // block 당 column tile 수
+#define NBLK ((NB + JT - 1) / JT)                 // weight block 수
+
+#define SW_THREADS 0       // CPU SGEMM thread 수 (0: 전체 core, standalone은 1)
+
+enum { DMA_SIMPLE, DMA_SG };
+static const char *dma_mode_name[] = { "simple", "SG" };
+
+#define SG_TX_BDS 256      // MM2S BD ring (16 KB), half ring씩 refill
+#define SG_RX_BDS 64       // S2MM BD ring: run 당 최대 row 수
+
+#define DMA_TIMEOUT 100000000
+
+static XAxiDma AxiDma;
+static int dma_mode = DMA_SIMPLE;
+
+static XAxiDma_Bd TxBds[SG_TX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+static XAxiDma_Bd RxBds[SG_RX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+
+static inline int idx(int r,int c){ return r*N+c; }         // 입력 행렬의 주소 index 반환
+
+static inline double cycles_to_us(XTime c){
+    return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+}
+
+// cache 관리는 buffer 전체 단위로 batch마다 1회 (gemm_buf) → 전송 loop 안에는 cache 작업 없음
+static void flush(void* p,int sz){ gemm_buf_to_dev(p,sz); }      // Cache Flush for READs
+static void inval(void* p,int sz){ gemm_buf_from_dev(p,sz); }    // Cache Invalidate for WRITEs
+
+// ---------------- Packed tile access ----------------
+// X, C: row panel 순서 (C(m, bj0..bj0+JT-1) 연속 → row 1개 = S2MM 1회)
+// W   : column panel 순서 (block = W(0..K-1, bj0..bj0+JT-1) 연속)
+static inline float* tileX(float*Xp,int br,int bc){ return gemm_tile_ptr(Xp,M,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+static inline float* tileW(float*Wp,int br,int bc){ return gemm_tile_ptr(Wp,N,N,TILE,GEMM_TILES_COL_MAJOR,br,bc); }
+static inline float* tileC(float*Cp,int br,int bc){ return gemm_tile_ptr(Cp,M,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+
+// ---------------- DMA helpers (simple mode) ----------------
+// MM2S: 256 floats (1KB) 1회
+static int dma_send_tile(float *in256){
+    const int in_bytes = 256*sizeof(float);
+
+    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)in256, in_bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+        return -1;
+
+    int t=DMA_TIMEOUT;
+    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE) && t--);
+    return (t<=0) ? -1 : 0;
+}
+
+// S2MM: C row 1개 (jt tiles) 수신 예약
+static int dma_recv_row(float *out, int jt){
+    const int out_bytes = jt*256*sizeof(float);
+
+    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)out, out_bytes, XAXIDMA_DEVICE_TO_DMA) != XST_SUCCESS)
+        return -1;
+
+    return 0;
+}
+
+static int dma_wait_recv_done(void){
+    int t=DMA_TIMEOUT;
+    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DEVICE_TO_DMA) && t--);
+    return (t<=0) ? -1 : 0;
+}
+
+static void ip_start(void){ Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START); }
+static void ip_wait_done(void){ while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_DONE)); }
+
+// packed 배열의 연속된 tile cnt개를 MM2S로 전송 (simple: tile마다 busy-wait, SG: BD chain)
+static int send_tiles(float *p, int cnt){
+    if (dma_mode == DMA_SG) {
+        static gemm_sg_seg_t seg[SG_TX_BDS/2];
+        XAxiDma_BdRing *tx = XAxiDma_GetTxRing(&AxiDma);
+        for (int t0 = 0; t0 < cnt; t0 += SG_TX_BDS/2) {
+            int n = MIN(cnt - t0, SG_TX_BDS/2);
+            for (int t = 0; t < n; t++) {
+                seg[t].addr = (UINTPTR)(p + (long)(t0 + t)*256);
+                seg[t].len  = 256*sizeof(float);
+                seg[t].ctrl = XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK;
+            }
+            if (gemm_sg_submit(tx, seg, n, DMA_TIMEOUT)!=0) return -1;
+        }
+        return 0;
+    }
+    for (int t = 0; t < cnt; t++)
+        if (dma_send_tile(p + (long)t*256)!=0) return -1;
+    return 0;
+}
+
+// ---------------- CMD_LOAD_W ----------------
+// weight block W(0..K-1, bj0..bj0+jt-1) → IP 내부 block (연속 jt*KTILES tiles)
+static int ws_load(float *Wp, int bj0, int jt){
+    Xil_Out32(GEMM_CTRL_BASE+REG_CMD,    CMD_LOAD_W);
+    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
+    Xil_Out32(GEMM_CTRL_BASE+REG_JTILES, jt);
+    ip_start();
+
+    if (send_tiles(tileW(Wp, 0, bj0), jt*KTILES)!=0){
+        printf("MM2S weight send fail\n");
+        return -1;
+    }
+    if (dma_mode == DMA_SG && gemm_sg_wait(XAxiDma_GetTxRing(&AxiDma), DMA_TIMEOUT)!=0){
+        printf("MM2S SG wait fail\n");
+        return -1;
+    }
+    ip_wait_done();
+    return 0;
+}
+
+// ---------------- CMD_RUN ----------------
+// X row m0..m0+rows-1 → C(m, bj0..bj0+jt-1)
+//  - simple: rows = 1 (S2MM 1개 예약 후 X row panel 전송)
+//  - SG    : S2MM BD rows개를 먼저 걸고 X tile BD chain 연속 제출
+static int ws_run(float *Xp, float *Cp, int m0, int rows, int bj0, int jt){
+    Xil_Out32(GEMM_CTRL_BASE+REG_CMD,    CMD_RUN);
+    Xil_Out32(GEMM_CTRL_BASE+REG_MTILES, rows);
+
+    if (dma_mode == DMA_SG) {
+        static gemm_sg_seg_t out[SG_RX_BDS];
+        XAxiDma_BdRing *rx = XAxiDma_GetRxRing(&AxiDma);
+        for (int r = 0; r < rows; r++) {
+            out[r].addr = (UINTPTR)tileC(Cp, m0 + r, bj0);
+            out[r].len  = jt*256*sizeof(float);
+            out[r].ctrl = 0;
+        }
+        if (gemm_sg_submit(rx, out, rows, DMA_TIMEOUT)!=0){
+            printf("S2MM SG submit fail\n");
+            return -1;
+        }
+    } else if (dma_recv_row(tileC(Cp, m0, bj0), jt)!=0){
+        printf("S2MM submit fail\n");
+        return -1;
+    }
+
+    ip_start();
+
+    // X row panel들은 packed X 안에서 연속
+    if (send_tiles(tileX(Xp, m0, 0), rows*KTILES)!=0){
+        printf("MM2S activation send fail\n");
+        return -1;
+    }
+
+    if (dma_mode == DMA_SG) {
+        if (gemm_sg_wait(XAxiDma_GetTxRing(&AxiDma), DMA_TIMEOUT)!=0 ||
+            gemm_sg_wait(XAxiDma_GetRxRing(&AxiDma), DMA_TIMEOUT)!=0){
+            printf("SG wait timeout\n");
+            return -1;
+        }
+    } else if (dma_wait_recv_done()!=0){
+        printf("S2MM wait timeout\n");
+        return -1;
+    }
+    ip_wait_done();
+    return 0;
+}
+
+// ---------------- HW: 1 batch ----------------
+// weight block이 1개면 첫 batch에서만 LOAD_W (이후 batch는 activation만 전송)
+static int gemm_hw_ws(float *Xp, float *Wp, float *Cp, int first_batch, double *load_us){
+    const int run_rows = (dma_mode == DMA_SG) ? SG_RX_BDS : 1;
+    XTime t0, t1;
+
+    // packed 행렬 전체를 1회만 flush / invalidate (simple / SG 공통, 전송마다 하지 않음)
+    flush(Xp, M*N*sizeof(float));
+    inval(Cp, M*N*sizeof(float));
+
+    for (int bj0 = 0; bj0 < NB; bj0 += JT) {
+        int jt = MIN(JT, NB - bj0);
+
+        if (NBLK > 1 || first_batch) {
+            XTime_GetTime(&t0);
+            if (ws_load(Wp, bj0, jt)!=0) return -1;
+            XTime_GetTime(&t1);
+            *load_us += cycles_to_us(t1-t0);
+        }
+
+        for (int m0 = 0; m0 < MB; m0 += run_rows)
+            if (ws_run(Xp, Cp, m0, MIN(run_rows, MB - m0), bj0, jt)!=0) return -1;
+    }
+
+    inval(Cp, M*N*sizeof(float));
+    return 0;
+}
+
+int main(){
+    printf("\n===== WS GEMM (M=%d, N=%d, %d batches) =====\n", M, N, NBATCH);
+
+    XAxiDma_Config* cfg = XAxiDma_LookupConfig(DMA_DEV_ID);
+    XAxiDma_CfgInitialize(&AxiDma,cfg);
+
+    if (XAxiDma_HasSg(&AxiDma)) {
+        if (gemm_sg_setup(&AxiDma, TxBds, SG_TX_BDS, RxBds, SG_RX_BDS)!=0){
+            printf("SG ring setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_SG;
+    }
+    printf("DMA %s, weight block %d x %d tiles, %d block(s)\n",
+           dma_mode_name[dma_mode], KTILES, JT, NBLK);
+
+    static float X[MAXM*MAXN] __attribute__((aligned(64)));
+    static float W[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Csw[MAXM*MAXN] __attribute__((aligned(64)));
+    static float Chw[MAXM*MAXN] __attribute__((aligned(64)));
+
+    // tile-major packed buffers (DMA가 직접 읽고 씀)
+    static float Xp[MAXM*MAXN] __attribute__((aligned(64)));
+    static float Wp[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Cp[MAXM*MAXN] __attribute__((aligned(64)));
+
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++)
+            W[idx(i,j)] = j + i*0.2f;
+
+    // W는 1회만 packing + flush (고정 weight)
+    gemm_pack_tiles(W, N, N, N, TILE, GEMM_TILES_COL_MAJOR, Wp);
+    flush(Wp, N*N*sizeof(float));
+
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+
+    double sw_us = 0, hw_us = 0, hw_first_us = 0, load_us = 0;
+    float max_err = 0;
+
+    for (int b = 0; b < NBATCH; b++) {
+        for(int i=0;i<M;i++)
+            for(int j=0;j<N;j++)
+                X[idx(i,j)] = i + j*0.1f - b*0.5f;
+
+        // SW: packed panel + SIMD micro-kernel + threads
+        XTime t0,t1;
+        XTime_GetTime(&t0);
+        sgemm_cpu(M,N,N, X,N, W,N, Csw,N);
+        XTime_GetTime(&t1);
+        sw_us += cycles_to_us(t1-t0);
+
+        // HW: X packing + (LOAD_W) + RUN + C unpack
+        XTime_GetTime(&t0);
+        gemm_pack_tiles(X, M, N, N, TILE, GEMM_TILES_ROW_MAJOR, Xp);
+        if (gemm_hw_ws(Xp, Wp, Cp, b == 0, &load_us)!=0) return -1;
+        gemm_unpack_tiles(Cp, M, N, TILE, GEMM_TILES_ROW_MAJOR, Chw, N);
+        XTime_GetTime(&t1);
+        if (b == 0) hw_first_us = cycles_to_us(t1-t0);
+        else        hw_us      += cycles_to_us(t1-t0);
+
+        for(int i=0;i<M*N;i++){
+            float e=fabsf(Chw[i]-Csw[i]);
+            if(e>max_err) max_err=e;
+        }
+    }
+
+    double flops  = 2.0 * (double)M * (double)N * (double)N;
+    double x_mb   = (double)M*N*sizeof(float) * NBLK / 1e6;     // X는 block마다 1회
+    double w_mb   = (double)N*N*sizeof(float) / 1e6;
+    int    steady = (NBATCH > 1) ? NBATCH-1 : 1;
+    if (NBATCH == 1) hw_us = hw_first_us;
+
+    printf("SW(%s x%d) %.3f us / batch\n", sgemm_impl_name(SGEMM_SIMD), sgemm_get_threads(), sw_us/NBATCH);
+    printf("HW first batch %.3f us\n", hw_first_us);
+    printf("LOAD_W %d x, total %.3f us\n", (NBLK > 1) ? NBLK*NBATCH : 1, load_us);
+    printf("HW %.3f us / batch\n", hw_us/steady);
+    printf("MM2S / batch: X %.3f MB + W %.3f MB\n", x_mb, (NBLK > 1) ? w_mb : 0.0);
+    printf("Speedup %.2fx\n", (sw_us/NBATCH)/(hw_us/steady));
+    printf("GFLOPS %.3f\n", flops/((hw_us/steady)*1e-6)/1e9);
+    printf("max_abs_err %.6f\n", max_err);
+
+    return 0;
+}
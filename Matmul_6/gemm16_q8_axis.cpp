@@ -0,0 +1,279 @@
+// ================================================================
+// gemm16_q8_axis.cpp  (INT8 quantized version)
+//  - Target: Zynq-7000 (xc7z020) @ 100MHz class
+//  - AXI4-Stream in/out, 32-bit TDATA = 4 x int8 (byte b = element 4q+b)
+//  - AXI-Lite control: Ktiles, qmode, scale, zp_out
+//
+//  - Quantized inference: A, B are symmetric int8 (zero point 0),
+//    C is accumulated exactly in int32 and requantized to int8 on
+//    the way out. One beat carries 4 operands, so a 16x16 tile is
+//    64 words instead of 256: MM2S traffic / 4
+//
+//  - Key optimizations:
+//    1) PACKED BEATS: recv unpacks 4 int8 per cycle, an A+B frame
+//       is 128 cycles (float: 512)
+//    2) DOUBLE BUFFERING: recv of the next A/B tile overlaps the MAC
+//       of the current one (ping-pong + DATAFLOW, as Matmul_4)
+//    3) 2 OUTPUTS / CYCLE: int8 multipliers are cheap (LUT or half a
+//       DSP48), so the MAC does JPAR=2 columns x 16 k per cycle:
+//       128 cycles per tile = the recv time of a frame
+//    4) FUSED REQUANT: scale, round, zero point and int8 saturation
+//       in send_result, 4 results packed per output word
+//
+//  - Protocol:
+//      Input:  [Q_CHANNEL: 16 float scale words, one per C column]
+//              Ktiles frames, each frame = A16(64) + B16(64) = 128 words
+//              (tiles row-major, 4 consecutive columns per word)
+//      Output: Q_RAW     : C16 as int32, 256 words
+//              Q_TENSOR /
+//              Q_CHANNEL : C16 as int8, 64 words
+//              TLAST asserted on the last output word
+//
+//  - qmode (CTRL 0x18):
+//      Q_RAW     : no requantization (int32 accumulators)
+//      Q_TENSOR  : q = sat8(round(acc * scale) + zp_out), scale CTRL 0x20
+//      Q_CHANNEL : same with a per-column scale from the stream
+//    zp_out (CTRL 0x28): output zero point
+//
+//  - acc is exact for Ktiles <= 64 (|acc| < 2^24 also keeps the float
+//    conversion in the requant exact)
+// ================================================================
+
+#include <hls_stream.h>
+#include <ap_int.h>
+#include <ap_axi_sdata.h>
+#include <cstring>
+#include <stdint.h>
+
+#define N 16
+#define QW (N/4)         // packed words per tile row
+#define JPAR 2           // output columns per MAC cycle
+
+#define Q_RAW     0
+#define Q_TENSOR  1
+#define Q_CHANNEL 2
+
+typedef ap_axiu<32, 0, 0, 0> axis_t;
+typedef ap_int<8>  q8_t;
+typedef ap_int<32> acc_t;
+
+// ------------------------------
+// CSIM-safe bit reinterpretation
+// ------------------------------
+static inline float u32_to_f(ap_uint<32> u) {
+#pragma HLS INLINE
+    float f;
+    uint32_t tmp = (uint32_t)u.to_uint();
+    std::memcpy(&f, &tmp, sizeof(float));
+    return f;
+}
+
+// ------------------------------
+// 16-way int8 dot product, balanced tree
+// (16-bit products, 20-bit tree: fits the 48-bit DSP adders or LUTs)
+// ------------------------------
+static inline acc_t dot16(const q8_t a[N], q8_t b0, q8_t b1, q8_t b2, q8_t b3,
+                          q8_t b4, q8_t b5, q8_t b6, q8_t b7,
+                          q8_t b8, q8_t b9, q8_t b10, q8_t b11,
+                          q8_t b12, q8_t b13, q8_t b14, q8_t b15) {
+#pragma HLS INLINE
+    ap_int<16> p0  = a[0]  * b0,  p1  = a[1]  * b1,  p2  = a[2]  * b2,  p3  = a[3]  * b3;
+    ap_int<16> p4  = a[4]  * b4,  p5  = a[5]  * b5,  p6  = a[6]  * b6,  p7  = a[7]  * b7;
+    ap_int<16> p8  = a[8]  * b8,  p9  = a[9]  * b9,  p10 = a[10] * b10, p11 = a[11] * b11;
+    ap_int<16> p12 = a[12] * b12, p13 = a[13] * b13, p14 = a[14] * b14, p15 = a[15] * b15;
+
+    ap_int<17> s0 = p0 + p1,   s1 = p2 + p3,   s2 = p4 + p5,   s3 = p6 + p7;
+    ap_int<17> s4 = p8 + p9,   s5 = p10 + p11, s6 = p12 + p13, s7 = p14 + p15;
+    ap_int<18> t0 = s0 + s1,   t1 = s2 + s3,   t2 = s4 + s5,   t3 = s6 + s7;
+    ap_int<19> u0 = t0 + t1,   u1 = t2 + t3;
+    return (acc_t)(u0 + u1);
+}
+
+// ==============================================================
+// Sub-functions
+// ==============================================================
+
+// ---- Receive one packed A+B frame (64 + 64 words) into a ping-pong buffer ----
+static void recv_tile(
+    hls::stream<axis_t>& s_in,
+    q8_t A[N][N],
+    q8_t B[N][N])
+{
+    for (int w = 0; w < N*QW; w++) {
+#pragma HLS PIPELINE II=1
+        ap_uint<32> d = s_in.read().data;
+        int i = w / QW, q = w % QW;
+        for (int b = 0; b < 4; b++) {
+#pragma HLS UNROLL
+            A[i][4*q + b] = (q8_t)d.range(8*b + 7, 8*b);
+        }
+    }
+    for (int w = 0; w < N*QW; w++) {
+#pragma HLS PIPELINE II=1
+        ap_uint<32> d = s_in.read().data;
+        int i = w / QW, q = w % QW;
+        for (int b = 0; b < 4; b++) {
+#pragma HLS UNROLL
+            B[i][4*q + b] = (q8_t)d.range(8*b + 7, 8*b);
+        }
+    }
+}
+
+// ---- MAC: C += A * B, JPAR columns per cycle ----
+static void mac_tile(
+    q8_t  A[N][N],
+    q8_t  B[N][N],
+    acc_t C[N][N])
+{
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j += JPAR) {
+#pragma HLS PIPELINE II=1
+            for (int jj = 0; jj < JPAR; jj++) {
+#pragma HLS UNROLL
+                int c = j + jj;
+                C[i][c] += dot16(A[i],
+                                 B[0][c],  B[1][c],  B[2][c],  B[3][c],
+                                 B[4][c],  B[5][c],  B[6][c],  B[7][c],
+                                 B[8][c],  B[9][c],  B[10][c], B[11][c],
+                                 B[12][c], B[13][c], B[14][c], B[15][c]);
+            }
+        }
+    }
+}
+
+// ---- Requantize: sat8(round(acc * scale) + zp), round half away from zero ----
+static inline q8_t requant(acc_t acc, float scale, int zp) {
+#pragma HLS INLINE
+    float v = (float)acc.to_int() * scale;
+    int   r = (int)((v >= 0.0f) ? (v + 0.5f) : (v - 0.5f)) + zp;
+    if (r >  127) r =  127;
+    if (r < -128) r = -128;
+    return (q8_t)r;
+}
+
+// ---- Send C: int32 (Q_RAW, 256 words) or packed int8 (64 words), TLAST on last ----
+static void send_result(
+    acc_t C[N][N],
+    const float scale[N],
+    hls::stream<axis_t>& s_out,
+    int qmode,
+    int zp_out)
+{
+    if (qmode == Q_RAW) {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+                axis_t o;
+                o.data = (ap_uint<32>)C[i][j];
+                o.keep = (ap_uint<4>)0xF;
+                o.strb = (ap_uint<4>)0xF;
+                o.user = 0;
+                o.id   = 0;
+                o.dest = 0;
+                o.last = ((i == N-1) && (j == N-1)) ? 1 : 0;
+                s_out.write(o);
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < N; i++) {
+        for (int q = 0; q < QW; q++) {
+#pragma HLS PIPELINE II=1
+            uint32_t d = 0;
+            for (int b = 0; b < 4; b++) {
+#pragma HLS UNROLL
+                int j = 4*q + b;
+                d |= (uint32_t)(requant(C[i][j], scale[j], zp_out).to_int() & 0xFF) << (8*b);
+            }
+            axis_t o;
+            o.data = d;
+            o.keep = (ap_uint<4>)0xF;
+            o.strb = (ap_uint<4>)0xF;
+            o.user = 0;
+            o.id   = 0;
+            o.dest = 0;
+            o.last = ((i == N-1) && (q == QW-1)) ? 1 : 0;
+            s_out.write(o);
+        }
+    }
+}
+
+// ==============================================================
+// Top: INT8 GEMM16 accumulate
+// ==============================================================
+void gemm16_q8_axis(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int Ktiles,
+    int qmode,
+    float scale,
+    int zp_out
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=qmode bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=scale bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=zp_out bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    if (Ktiles <= 0) return;
+
+    // ---- Requant scale per C column (per-tensor: all the same) ----
+    float qscale[N];
+#pragma HLS ARRAY_PARTITION variable=qscale complete
+    for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+        qscale[j] = (qmode == Q_CHANNEL) ? u32_to_f(s_in.read().data) : scale;
+    }
+
+    // ---- Ping-pong buffers for A and B ----
+    // A: a row is read whole by the MAC and written 4 wide by recv
+    // B: a column is read whole, 4 consecutive columns written per cycle
+    q8_t  A_buf[2][N][N];
+    q8_t  B_buf[2][N][N];
+    acc_t C[N][N];
+
+#pragma HLS ARRAY_PARTITION variable=A_buf complete dim=3
+#pragma HLS ARRAY_PARTITION variable=B_buf complete dim=2
+#pragma HLS ARRAY_PARTITION variable=B_buf cyclic factor=4 dim=3
+#pragma HLS ARRAY_PARTITION variable=C     cyclic factor=4 dim=2
+
+    // Clear accumulator
+    CLEAR_C:
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+            C[i][j] = 0;
+        }
+    }
+
+    // ================================================================
+    // Double-buffering loop (Ktiles + 1 iterations):
+    //  recv frame k -> buf[k & 1]  ||  MAC buf[(k-1) & 1]
+    // ================================================================
+    for (int phase = 0; phase < Ktiles + 1; phase++) {
+
+        int recv_buf = phase & 1;
+        int comp_buf = (phase - 1) & 1;
+
+        bool do_recv    = (phase < Ktiles);
+        bool do_compute = (phase > 0);
+
+#pragma HLS DATAFLOW
+
+        // Stage 1: unpack next frame into buf[ping]
+        if (do_recv) {
+            recv_tile(s_in, A_buf[recv_buf], B_buf[recv_buf]);
+        }
+
+        // Stage 2: MAC accumulate using previous frame's buffer
+        if (do_compute) {
+            mac_tile(A_buf[comp_buf], B_buf[comp_buf], C);
+        }
+    }
+
+    // ---- Send result ----
+    send_result(C, qscale, s_out, qmode, zp_out);
+}
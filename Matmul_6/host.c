@@ -0,0 +1,413 @@
+/********************************************************************
+ * INT8 Quantized GEMM Host (gemm16_q8_axis IP)
+ *  - C(N x N) = A(N x N) * B(N x N), N = 16*k
+ *  - float A (activations) / B (weights) are quantized once:
+ *      A: per-tensor symmetric int8   (sa = max|A| / 127)
+ *      B: per-column symmetric int8   (sb[j] = max|B(:,j)| / 127)
+ *         or per-tensor (-DQMODE=1)
+ *      C: int8, sc = max|C| / 127 (calibrated on the float reference)
+ *    IP requant scale = sa * sb[j] / sc (per column: Q_CHANNEL)
+ *  - A, B packed ONCE into int8 tile-major panels (gemm_pack_tiles_esz)
+ *  - Tile (bi,bj):
+ *      S2MM : C tile, 64 words (int8) or 256 words (-DQMODE=0, int32)
+ *      MM2S : [16 scale words] + Ktiles frames of A tile 64 + B tile 64 words
+ *  - DMA mode (XAxiDma_HasSg at runtime):
+ *      simple : SimpleTransfer + busy-wait per tile transfer
+ *      SG     : all frames of all output tiles as BD chains,
+ *               IP in auto-restart
+ *  - Cache maintenance (gemm_buf): packed A / B / scales flushed and
+ *    packed C invalidated once per GEMM in both modes
+ *  - Check: HW int8 == CPU integer reference (bit exact),
+ *    dequantized C vs float SGEMM (quantization error)
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "xparameters.h"
+#include "xaxidma.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "xil_io.h"
+
+#include "sgemm_cpu.h"
+#include "gemm_pack.h"
+#include "gemm_dma_sg.h"
+#include "gemm_buf.h"
+
+#ifndef N
+#define N 128             // 16의 배수 (에뮬레이션 빌드에서는 -DN=... 로 지정)
+#endif
+#define TILE 16           // 가속기 자체는 16*16 행렬 곱셈 & 누적
+#define NB (N/TILE)       // Tile의 수
+#define KTILES NB         // Tile의 수 (한 차원 측면에서)
+
+#define MAXN 256*3        // 최대 행렬의 크기 (int32 누적 exact: Ktiles <= 64)
+#define DMA_DEV_ID XPAR_AXIDMA_0_DEVICE_ID
+#define GEMM_CTRL_BASE XPAR_GEMM16_Q8_AXIS_0_S_AXI_CTRL_BASEADDR
+
+#define REG_AP_CTRL  0x00
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define AP_AUTO_RESTART 0x80
+#define REG_KTILES   0x10    // K 방향 tile 수
+#define REG_QMODE    0x18    // Q_RAW / Q_TENSOR / Q_CHANNEL
+#define REG_SCALE    0x20    // Q_TENSOR: requant scale (float bit pattern)
+#define REG_ZP_OUT   0x28    // 출력 zero point
+
+#define Q_RAW     0
+#define Q_TENSOR  1
+#define Q_CHANNEL 2
+
+#ifndef QMODE
+#define QMODE Q_CHANNEL      // -DQMODE=1: per-tensor, 0: int32 출력 (host에서 dequant)
+#endif
+
+#if N % TILE != 0 || N > MAXN
+#error "N must be a multiple of 16 and <= MAXN"
+#endif
+
+#define TILE_BYTES  (TILE*TILE)                                   // int8 tile 256 B = 64 words
+#define CTILE_BYTES (TILE*TILE*((QMODE == Q_RAW) ? 4 : 1))        // C tile
+#define SCALE_BYTES (TILE*sizeof(float))                          // Q_CHANNEL: tile 당 scale 16개
+
+#define SW_THREADS 0       // CPU SGEMM thread 수 (0: 전체 core, standalone은 1)
+
+enum { DMA_SIMPLE, DMA_SG };
+static const char *dma_mode_name[] = { "simple", "SG" };
+
+#define SG_TX_BDS 256      // MM2S BD ring (16 KB), half ring씩 refill
+#define SG_RX_BDS 64       // S2MM BD ring: output tile 64개
+
+#define DMA_TIMEOUT 100000000
+
+static XAxiDma AxiDma;
+
+static XAxiDma_Bd TxBds[SG_TX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+static XAxiDma_Bd RxBds[SG_RX_BDS] __attribute__((aligned(XAXIDMA_BD_MINIMUM_ALIGNMENT)));
+
+static float Qscale[MAXN] __attribute__((aligned(64)));          // column j의 requant scale
+
+static inline int idx(int r,int c){ return r*N+c; }         // 입력 행렬의 주소 index 반환
+
+static inline double cycles_to_us(XTime c){
+    return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+}
+
+// cache 관리는 buffer 전체 단위로 GEMM마다 1회 (gemm_buf) → 전송 loop 안에는 cache 작업 없음
+static void flush(void* p,int sz){ gemm_buf_to_dev(p,sz); }      // Cache Flush for READs
+static void inval(void* p,int sz){ gemm_buf_from_dev(p,sz); }    // Cache Invalidate for WRITEs
+
+// ---------------- Quantization ----------------
+// IP의 requant와 같은 연산 (float 곱 + 반올림 + zero point + saturation)
+static inline int8_t requant(int32_t acc, float scale, int zp){
+    float v = (float)acc * scale;
+    int   r = (int)((v >= 0.0f) ? (v + 0.5f) : (v - 0.5f)) + zp;
+    if (r >  127) r =  127;
+    if (r < -128) r = -128;
+    return (int8_t)r;
+}
+
+// symmetric int8 (zero point 0, -127..127)
+static inline int8_t quant(float x, float s){
+    float q = roundf(x / s);
+    return (int8_t)fmaxf(-127.0f, fminf(127.0f, q));
+}
+
+// ---------------- CPU INT8 reference ----------------
+// int32 누적 + requant (IP와 bit 단위로 같은 결과)
+static void gemm_q8_sw(const int8_t *A, const int8_t *B, int32_t *Cacc){
+    for(int i=0;i<N;i++){
+        int32_t *c = Cacc + i*N;
+        for(int j=0;j<N;j++) c[j] = 0;
+        for(int k=0;k<N;k++){
+            int32_t a = A[idx(i,k)];
+            const int8_t *b = B + k*N;
+            for(int j=0;j<N;j++) c[j] += a * b[j];
+        }
+    }
+}
+
+// ---------------- Packed tile access (int8 / C: QMODE에 따라 int8 or int32) ----------------
+static inline int8_t* tileA(int8_t*Ap,int br,int bc){ return Ap + gemm_tile_off(N,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc); }
+static inline int8_t* tileB(int8_t*Bp,int br,int bc){ return Bp + gemm_tile_off(N,N,TILE,GEMM_TILES_COL_MAJOR,br,bc); }
+static inline char*   tileC(char*Cp,int br,int bc){
+    return Cp + gemm_tile_off(N,N,TILE,GEMM_TILES_ROW_MAJOR,br,bc) * (CTILE_BYTES/(TILE*TILE));
+}
+
+// ---------------- DMA helpers (simple mode) ----------------
+static int dma_send_buf(const void *p, int bytes){
+    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)p, bytes, XAXIDMA_DMA_TO_DEVICE) != XST_SUCCESS)
+        return -1;
+
+    int t=DMA_TIMEOUT;
+    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DMA_TO_DEVICE) && t--);
+    return (t<=0) ? -1 : 0;
+}
+
+// S2MM: C tile 1개 (int8 256 B / int32 1 KB)
+static int dma_recv_tile(char *out){
+    if (XAxiDma_SimpleTransfer(&AxiDma, (UINTPTR)out, CTILE_BYTES, XAXIDMA_DEVICE_TO_DMA) != XST_SUCCESS)
+        return -1;
+
+    return 0;
+}
+
+static int dma_wait_recv_done(void){
+    int t=DMA_TIMEOUT;
+    while(XAxiDma_Busy(&AxiDma, XAXIDMA_DEVICE_TO_DMA) && t--);
+    return (t<=0) ? -1 : 0;
+}
+
+// ---------------- HW GEMM: simple mode ----------------
+static int gemm_hw_simple(int8_t *Ap, int8_t *Bp, char *Cp){
+    // packed 행렬 전체를 1회만 flush / invalidate (SG mode와 같음)
+    flush(Ap, N*N);
+    flush(Bp, N*N);
+    flush(Qscale, N*sizeof(float));
+    inval(Cp, N*N*(CTILE_BYTES/(TILE*TILE)));
+
+    for(int bi=0; bi<NB; bi++){
+        for(int bj=0; bj<NB; bj++){
+
+            // (1) 타일 출력 S2MM을 먼저 1회만 걸어둔다
+            char *out_tile = tileC(Cp, bi, bj);
+            if(dma_recv_tile(out_tile)!=0){
+                printf("S2MM submit fail\n");
+                return -1;
+            }
+
+            // (2) IP start
+            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START);
+
+            // (3) [column scale 16개] + Ktiles 프레임 (각 A 64 + B 64 words)
+            if(QMODE == Q_CHANNEL && dma_send_buf(&Qscale[bj*TILE], SCALE_BYTES)!=0){
+                printf("MM2S scale send fail\n");
+                return -1;
+            }
+            for(int bk=0; bk<KTILES; bk++){
+                if(dma_send_buf(tileA(Ap, bi, bk), TILE_BYTES)!=0 ||
+                   dma_send_buf(tileB(Bp, bk, bj), TILE_BYTES)!=0){
+                    printf("MM2S frame send fail\n");
+                    return -1;
+                }
+            }
+
+            // (4) S2MM 완료 대기 + IP done
+            if(dma_wait_recv_done()!=0){
+                printf("S2MM wait timeout\n");
+                return -1;
+            }
+            while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_DONE));
+        }
+    }
+
+    inval(Cp, N*N*(CTILE_BYTES/(TILE*TILE)));     // S2MM 중 prefetch된 line 제거
+    return 0;
+}
+
+// ---------------- HW GEMM: scatter-gather mode ----------------
+// Matmul_3과 같은 auto-restart protocol: 마지막 tile 직전에 앞 tile 출력을 모두 기다린 뒤 해제
+static int gemm_hw_sg(int8_t *Ap, int8_t *Bp, char *Cp){
+    static gemm_sg_seg_t seg[2*KTILES+1];
+    XAxiDma_BdRing *tx = XAxiDma_GetTxRing(&AxiDma);
+    XAxiDma_BdRing *rx = XAxiDma_GetRxRing(&AxiDma);
+    const int ntiles = NB*NB;
+
+    // packed 행렬 전체를 1회만 flush / invalidate (BD는 cache 작업 없음)
+    flush(Ap, N*N);
+    flush(Bp, N*N);
+    flush(Qscale, N*sizeof(float));
+    inval(Cp, N*N*(CTILE_BYTES/(TILE*TILE)));
+
+    Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, (ntiles > 1) ? (AP_AUTO_RESTART|AP_START) : AP_START);
+
+    for(int t=0; t<ntiles; t++){
+        int bi = t / NB, bj = t % NB;
+
+        if (t == ntiles-1 && ntiles > 1) {
+            if (gemm_sg_wait(rx, DMA_TIMEOUT)!=0){
+                printf("S2MM SG wait fail\n");
+                return -1;
+            }
+            Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, 0);    // auto-restart 해제
+        }
+
+        // (1) 출력 tile S2MM BD
+        gemm_sg_seg_t out = { (UINTPTR)tileC(Cp, bi, bj), CTILE_BYTES, 0 };
+        if (gemm_sg_submit(rx, &out, 1, DMA_TIMEOUT)!=0){
+            printf("S2MM SG submit fail\n");
+            return -1;
+        }
+
+        // (2) [scale BD(SOF|EOF)] + Ktiles frame = A tile BD(SOF) + B tile BD(EOF)
+        int nseg = 0;
+        if (QMODE == Q_CHANNEL) {
+            seg[nseg].addr = (UINTPTR)&Qscale[bj*TILE];
+            seg[nseg].len  = SCALE_BYTES;
+            seg[nseg].ctrl = XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK;
+            nseg++;
+        }
+        for(int bk=0; bk<KTILES; bk++){
+            seg[nseg].addr = (UINTPTR)tileA(Ap, bi, bk);
+            seg[nseg].len  = TILE_BYTES;
+            seg[nseg].ctrl = XAXIDMA_BD_CTRL_TXSOF_MASK;
+            nseg++;
+            seg[nseg].addr = (UINTPTR)tileB(Bp, bk, bj);
+            seg[nseg].len  = TILE_BYTES;
+            seg[nseg].ctrl = XAXIDMA_BD_CTRL_TXEOF_MASK;
+            nseg++;
+        }
+        if (gemm_sg_submit(tx, seg, nseg, DMA_TIMEOUT)!=0){
+            printf("MM2S SG submit fail\n");
+            return -1;
+        }
+    }
+
+    // (3) 모든 BD 완료 대기 + IP idle 확인
+    if (gemm_sg_wait(tx, DMA_TIMEOUT)!=0 || gemm_sg_wait(rx, DMA_TIMEOUT)!=0){
+        printf("SG wait timeout\n");
+        return -1;
+    }
+    while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_IDLE));
+
+    inval(Cp, N*N*(CTILE_BYTES/(TILE*TILE)));
+    return 0;
+}
+
+static float max_abs(const float *p, int n, int stride){
+    float m = 0;
+    for(int i=0;i<n;i++) m = fmaxf(m, fabsf(p[(long)i*stride]));
+    return m;
+}
+
+int main(){
+    printf("\n===== INT8 GEMM (N=%d, qmode %d) =====\n", N, QMODE);
+
+    XAxiDma_Config* cfg = XAxiDma_LookupConfig(DMA_DEV_ID);
+    XAxiDma_CfgInitialize(&AxiDma,cfg);
+
+    int dma_mode = DMA_SIMPLE;
+    if (XAxiDma_HasSg(&AxiDma)) {
+        if (gemm_sg_setup(&AxiDma, TxBds, SG_TX_BDS, RxBds, SG_RX_BDS)!=0){
+            printf("SG ring setup fail\n");
+            return -1;
+        }
+        dma_mode = DMA_SG;
+    }
+    printf("DMA %s\n", dma_mode_name[dma_mode]);
+
+    static float A[MAXN*MAXN] __attribute__((aligned(64)));
+    static float B[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Cf[MAXN*MAXN] __attribute__((aligned(64)));
+
+    static int8_t  A8[MAXN*MAXN], B8[MAXN*MAXN];
+    static int32_t Cacc[MAXN*MAXN];
+    static int8_t  Csw8[MAXN*MAXN];
+    static int32_t Chw[MAXN*MAXN];     // int8 결과도 int32로 unpack 후 비교
+
+    // tile-major packed buffers (DMA가 직접 읽고 씀)
+    static int8_t Ap[MAXN*MAXN] __attribute__((aligned(64)));
+    static int8_t Bp[MAXN*MAXN] __attribute__((aligned(64)));
+    static char   Cp[MAXN*MAXN*4] __attribute__((aligned(64)));
+
+    // activation: 부호가 섞인 값, weight: column마다 크기가 다름 (per-channel이 유리한 분포)
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++){
+            A[idx(i,j)] = sinf(0.37f*i + 0.11f*j) + 0.25f*cosf(0.05f*i*j);
+            B[idx(i,j)] = cosf(0.23f*i - 0.41f*j) * (0.1f + (j % 8) * 0.3f);
+        }
+
+    // SW float: packed panel + SIMD micro-kernel + threads
+    XTime t0,t1;
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+    XTime_GetTime(&t0);
+    sgemm_cpu(N,N,N, A,N, B,N, Cf,N);
+    XTime_GetTime(&t1);
+    double sw_us=cycles_to_us(t1-t0);
+
+    // ---- Quantization parameters ----
+    float sa = max_abs(A, N*N, 1) / 127.0f;
+    float sb[MAXN];
+    for(int j=0;j<N;j++)
+        sb[j] = (QMODE == Q_CHANNEL) ? max_abs(B + j, N, N) / 127.0f : max_abs(B, N*N, 1) / 127.0f;
+    float sc = max_abs(Cf, N*N, 1) / 127.0f;
+    const int zp_out = 0;
+
+    for(int i=0;i<N*N;i++) A8[i] = quant(A[i], sa);
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++) B8[idx(i,j)] = quant(B[idx(i,j)], sb[j]);
+    for(int j=0;j<N;j++) Qscale[j] = sa * sb[j] / sc;
+
+    // SW int8 reference (bit exact 기준)
+    XTime_GetTime(&t0);
+    gemm_q8_sw(A8, B8, Cacc);
+    if (QMODE != Q_RAW)
+        for(int i=0;i<N;i++)
+            for(int j=0;j<N;j++) Csw8[idx(i,j)] = requant(Cacc[idx(i,j)], Qscale[j], zp_out);
+    XTime_GetTime(&t1);
+    double sw_q8_us=cycles_to_us(t1-t0);
+
+    // HW
+    u32 scale_bits;
+    memcpy(&scale_bits, &Qscale[0], sizeof(u32));
+    Xil_Out32(GEMM_CTRL_BASE+REG_KTILES, KTILES);
+    Xil_Out32(GEMM_CTRL_BASE+REG_QMODE,  QMODE);
+    Xil_Out32(GEMM_CTRL_BASE+REG_SCALE,  scale_bits);
+    Xil_Out32(GEMM_CTRL_BASE+REG_ZP_OUT, (u32)zp_out);
+
+    XTime_GetTime(&t0);
+
+    // (0) int8 A, B를 1회만 tile-major로 packing
+    gemm_pack_tiles_esz(A8, N, N, N, TILE, GEMM_TILES_ROW_MAJOR, 1, Ap);
+    gemm_pack_tiles_esz(B8, N, N, N, TILE, GEMM_TILES_COL_MAJOR, 1, Bp);
+
+    int rc = (dma_mode == DMA_SG) ? gemm_hw_sg(Ap, Bp, Cp) : gemm_hw_simple(Ap, Bp, Cp);
+    if (rc != 0) return -1;
+
+    // packed C → row-major 1회 unpack
+    static int8_t Chw8[MAXN*MAXN];
+    if (QMODE == Q_RAW)
+        gemm_unpack_tiles_esz(Cp, N, N, TILE, GEMM_TILES_ROW_MAJOR, 4, Chw, N);
+    else
+        gemm_unpack_tiles_esz(Cp, N, N, TILE, GEMM_TILES_ROW_MAJOR, 1, Chw8, N);
+
+    XTime_GetTime(&t1);
+    double hw_us=cycles_to_us(t1-t0);
+
+    // 결과 검증: HW == CPU int8 reference, dequant C vs float
+    int mismatch = 0;
+    float max_err = 0;
+    for(int i=0;i<N;i++)
+        for(int j=0;j<N;j++){
+            float deq;
+            if (QMODE == Q_RAW) {
+                if (Chw[idx(i,j)] != Cacc[idx(i,j)]) mismatch++;
+                deq = (float)Chw[idx(i,j)] * sa * sb[j];
+            } else {
+                if (Chw8[idx(i,j)] != Csw8[idx(i,j)]) mismatch++;
+                deq = (float)(Chw8[idx(i,j)] - zp_out) * sc;
+            }
+            float e = fabsf(deq - Cf[idx(i,j)]);
+            if (e > max_err) max_err = e;
+        }
+
+    double ops   = 2.0 * (double)N * (double)N * (double)N;
+    double in_mb = (double)NB*NB*KTILES * 2*TILE_BYTES / 1e6;
+
+    printf("SW(%s x%d, float) %.3f us\n", sgemm_impl_name(SGEMM_SIMD), sgemm_get_threads(), sw_us);
+    printf("SW(int8 ref) %.3f us\n", sw_q8_us);
+    printf("HW %.3f us\n", hw_us);
+    printf("Speedup %.2fx (vs float SW)\n", sw_us/hw_us);
+    printf("GOPS %.3f\n", ops/(hw_us*1e-6)/1e9);
+    printf("MM2S %.3f MB (float IP: %.3f MB)\n", in_mb, in_mb*4);
+    printf("mismatch vs int8 ref %d\n", mismatch);
+    printf("quant max_abs_err %.6f (max|C| %.3f)\n", max_err, sc*127.0f);
+
+    return 0;
+}
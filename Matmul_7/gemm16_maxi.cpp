@@ -0,0 +1,266 @@
+// ================================================================
+// gemm16_maxi.cpp  (AXI4 master version)
+//  - Target: Zynq-7000 (xc7z020) @ 100MHz class
+//  - m_axi: A, B read / C written straight from / to DDR (HP ports)
+//  - AXI-Lite control: A, B, C base addresses, M, N, K, lda, ldb, ldc
+//
+//  - C(M x N) = A(M x K) * B(K x N), all row-major with leading
+//    dimensions lda / ldb / ldc (in floats). The IP walks every
+//    output tile itself: the host does one start / done per GEMM,
+//    no packing, no DMA descriptors, no per-tile register writes
+//
+//  - Key optimizations:
+//    1) DOUBLE BUFFERING: A(bi,k) / B(k,bj) of the next k are read
+//       while the MAC works on the current pair (ping-pong +
+//       DATAFLOW, as Matmul_4)
+//    2) TWO READ PORTS: A on gmem0, B on gmem1 (separate HP ports),
+//       loaded by two concurrent DATAFLOW processes
+//    3) BURSTS: a tile row is one burst. Full tiles are read in one
+//       flattened pipeline so the 16-word row bursts are issued back
+//       to back; edge tiles use a variable-length burst per row
+//    4) A-PANEL REUSE: A(bi,0..KT-1) is kept on chip while bj walks
+//       the row (KT <= KT_MAX), so DDR reads A once per row panel
+//    5) EDGE TILES: M, N, K need not be multiples of 16. Partial
+//       blocks are zero-padded on chip, only valid C elements are
+//       written
+//
+//  - Register map (xgemm16_maxi_hw.h, 64-bit m_axi addresses):
+//      0x00 AP_CTRL
+//      0x10 A (low) / 0x14 A (high)
+//      0x1c B (low) / 0x20 B (high)
+//      0x28 C (low) / 0x2c C (high)
+//      0x34 M, 0x3c N, 0x44 K, 0x4c lda, 0x54 ldb, 0x5c ldc
+//
+//  - Pipeline structure (per output tile):
+//      clear C -> KT+1 phases of
+//        [read A(k), B(k) into buf[ping]] || [C += A*B from buf[pong]]
+//      -> write C tile (rows bursts of cols words)
+// ================================================================
+
+#include <stdint.h>
+
+#include "gemm_tile.h"   // HLS_Common: gemm_mac_tile
+
+#define TILE 16
+#define KCHUNK 8
+#define KT_MAX 48        // A panel depth in tiles (K = 768)
+
+#define AMODE_STREAM 0   // A read from DDR for every tile (KT > KT_MAX)
+#define AMODE_LOAD   1   // A read from DDR and kept in the panel (bj == 0)
+#define AMODE_REUSE  2   // A from the panel (bj > 0)
+
+// ==============================================================
+// Sub-functions
+// ==============================================================
+
+// ---- Burst-read an h x w block (row stride ld) into buf, zero padded ----
+static void read_block(
+    const float *src,
+    int          ld,
+    int          h,
+    int          w,
+    float        buf[TILE][TILE])
+{
+    if (h == TILE && w == TILE) {
+        // full block: flattened, one 16-word burst per row, back to back
+        for (int i = 0; i < TILE; i++) {
+            for (int j = 0; j < TILE; j++) {
+#pragma HLS PIPELINE II=1
+                buf[i][j] = src[(long)i * ld + j];
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < TILE; i++) {
+        for (int j = 0; j < TILE; j++) {
+#pragma HLS PIPELINE II=1
+            buf[i][j] = 0.0f;
+        }
+    }
+    for (int i = 0; i < h; i++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=16
+        for (int j = 0; j < w; j++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS LOOP_TRIPCOUNT min=1 max=16
+            buf[i][j] = src[(long)i * ld + j];
+        }
+    }
+}
+
+// ---- A(bi,k): from DDR (STREAM / LOAD) or from the panel (REUSE) ----
+// Panel <-> buffer copies move a whole row per cycle
+static void load_a(
+    const float *A,
+    int          lda,
+    int          rows,
+    int          kv,
+    float        A_buf[TILE][TILE],
+    float        A_panel[KT_MAX][TILE][TILE],
+    int          k,
+    int          a_mode)
+{
+    if (a_mode == AMODE_REUSE) {
+        for (int i = 0; i < TILE; i++) {
+#pragma HLS PIPELINE II=1
+            for (int j = 0; j < TILE; j++) {
+#pragma HLS UNROLL
+                A_buf[i][j] = A_panel[k][i][j];
+            }
+        }
+        return;
+    }
+
+    read_block(A, lda, rows, kv, A_buf);
+
+    if (a_mode == AMODE_LOAD) {
+        for (int i = 0; i < TILE; i++) {
+#pragma HLS PIPELINE II=1
+            for (int j = 0; j < TILE; j++) {
+#pragma HLS UNROLL
+                A_panel[k][i][j] = A_buf[i][j];
+            }
+        }
+    }
+}
+
+// ---- B(k,bj) from DDR ----
+static void load_b(
+    const float *B,
+    int          ldb,
+    int          kv,
+    int          cols,
+    float        B_buf[TILE][TILE])
+{
+    read_block(B, ldb, kv, cols, B_buf);
+}
+
+// ---- Burst-write the valid rows x cols of a C tile (row stride ldc) ----
+static void write_tile(
+    float *dst,
+    int    ldc,
+    int    rows,
+    int    cols,
+    float  C[TILE][TILE])
+{
+    if (rows == TILE && cols == TILE) {
+        for (int i = 0; i < TILE; i++) {
+            for (int j = 0; j < TILE; j++) {
+#pragma HLS PIPELINE II=1
+                dst[(long)i * ldc + j] = C[i][j];
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < rows; i++) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=16
+        for (int j = 0; j < cols; j++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS LOOP_TRIPCOUNT min=1 max=16
+            dst[(long)i * ldc + j] = C[i][j];
+        }
+    }
+}
+
+// ==============================================================
+// Top: whole-GEMM m_axi GEMM16
+// ==============================================================
+void gemm16_maxi(
+    const float *A,
+    const float *B,
+    float       *C,
+    int M,
+    int N,
+    int K,
+    int lda,
+    int ldb,
+    int ldc
+){
+#pragma HLS INTERFACE m_axi port=A offset=slave bundle=gmem0 max_read_burst_length=16 num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=B offset=slave bundle=gmem1 max_read_burst_length=16 num_read_outstanding=16
+#pragma HLS INTERFACE m_axi port=C offset=slave bundle=gmem0 max_write_burst_length=16
+#pragma HLS INTERFACE s_axilite port=A bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=B bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=C bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=M bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=N bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=K bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=lda bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=ldb bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=ldc bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    // ---- On-chip A row panel ----
+    static float A_panel[KT_MAX][TILE][TILE];
+#pragma HLS ARRAY_PARTITION variable=A_panel complete dim=3
+
+    if (M <= 0 || N <= 0 || K <= 0) return;
+
+    const int MT = (M + TILE-1) / TILE;
+    const int NT = (N + TILE-1) / TILE;
+    const int KT = (K + TILE-1) / TILE;
+    const int klast = K - (KT-1)*TILE;
+    const bool use_panel = (KT <= KT_MAX);
+
+    // ---- Ping-pong buffers for A and B, C accumulator ----
+    float A_buf[2][TILE][TILE];
+    float B_buf[2][TILE][TILE];
+    float Cacc[TILE][TILE];
+
+#pragma HLS ARRAY_PARTITION variable=A_buf complete dim=3
+#pragma HLS ARRAY_PARTITION variable=B_buf complete dim=2
+#pragma HLS ARRAY_PARTITION variable=Cacc  complete dim=2
+
+    TILE_ROW:
+    for (int bi = 0; bi < MT; bi++) {
+        int rows = (bi == MT-1) ? M - bi*TILE : TILE;
+
+        TILE_COL:
+        for (int bj = 0; bj < NT; bj++) {
+            int cols = (bj == NT-1) ? N - bj*TILE : TILE;
+            int mode = !use_panel ? AMODE_STREAM : ((bj == 0) ? AMODE_LOAD : AMODE_REUSE);
+
+            // Clear accumulator
+            for (int i = 0; i < TILE; i++) {
+                for (int j = 0; j < TILE; j++) {
+#pragma HLS PIPELINE II=1
+                    Cacc[i][j] = 0.0f;
+                }
+            }
+
+            // ========================================================
+            // Double-buffering loop (KT + 1 phases):
+            //  read A(k), B(k) -> buf[k & 1]  ||  MAC buf[(k-1) & 1]
+            // ========================================================
+            for (int phase = 0; phase < KT + 1; phase++) {
+
+                int recv_buf = phase & 1;
+                int comp_buf = (phase - 1) & 1;
+
+                bool do_recv    = (phase < KT);
+                bool do_compute = (phase > 0);
+                int  kv         = (phase == KT-1) ? klast : TILE;
+
+#pragma HLS DATAFLOW
+
+                // Stage 1a / 1b: A and B blocks on separate read ports
+                if (do_recv) {
+                    load_a(A + (long)bi*TILE*lda + phase*TILE, lda, rows, kv,
+                           A_buf[recv_buf], A_panel, phase, mode);
+                }
+                if (do_recv) {
+                    load_b(B + (long)phase*TILE*ldb + bj*TILE, ldb, kv, cols, B_buf[recv_buf]);
+                }
+
+                // Stage 2: MAC accumulate using previous phase's buffers
+                if (do_compute) {
+                    gemm_mac_tile<TILE, TILE, TILE, KCHUNK, float>(A_buf[comp_buf], B_buf[comp_buf], Cacc);
+                }
+            }
+
+            // ---- Write C tile ----
+            write_tile(C + (long)bi*TILE*ldc + bj*TILE, ldc, rows, cols, Cacc);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+/********************************************************************
+ * m_axi GEMM Host (gemm16_maxi IP)
+ *  - C(M x N) = A(M x K) * B(K x N), any M, N, K
+ *  - A, B, C stay row-major in DDR: no packing, no DMA, no per-tile
+ *    control. The host writes the base addresses, M / N / K and the
+ *    leading dimensions once, then one AP_START / AP_DONE per GEMM
+ *  - The IP walks all output tiles, bursts A / B sub-blocks in over
+ *    two HP ports and bursts C tiles back out
+ *  - LD_PAD: extra floats at the end of every row of A, B, C
+ *    (lda = K + LD_PAD, ...) to exercise the leading dimensions
+ *  - Cache: A, B (and C) flushed once before start, C invalidated
+ *    after done
+ ********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "xparameters.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "xil_io.h"
+
+#include "sgemm_cpu.h"
+
+#ifndef N
+#define N 128             // C의 column 수 (에뮬레이션 빌드에서는 -DN=... 로 지정)
+#endif
+#ifndef M
+#define M N               // C / A의 row 수 (기본: 정방 행렬)
+#endif
+#ifndef K
+#define K N               // A의 column 수 = B의 row 수
+#endif
+#ifndef LD_PAD
+#define LD_PAD 0          // row 끝의 여분 float 수 (leading dimension 확인용)
+#endif
+#define LDA (K+LD_PAD)
+#define LDB (N+LD_PAD)
+#define LDC (N+LD_PAD)
+#define TILE 16           // 가속기 내부 tile 크기
+
+#define MAXN 256*3        // 최대 행렬의 크기 (host buffer 기준, IP 자체는 K 제한 없음)
+#if M > MAXN || N > MAXN || K > MAXN || LD_PAD < 0 || LD_PAD > 64
+#error "M, N, K must be <= MAXN and 0 <= LD_PAD <= 64"
+#endif
+#define GEMM_CTRL_BASE XPAR_GEMM16_MAXI_0_S_AXI_CTRL_BASEADDR
+
+#define REG_AP_CTRL  0x00
+#define AP_START        0x01
+#define AP_DONE         0x02
+#define AP_IDLE         0x04
+#define REG_A        0x10    // A base address (low 32 / high 32 at +4)
+#define REG_B        0x1c    // B base address
+#define REG_C        0x28    // C base address
+#define REG_M        0x34
+#define REG_N        0x3c
+#define REG_K        0x44
+#define REG_LDA      0x4c    // leading dimension (float 단위)
+#define REG_LDB      0x54
+#define REG_LDC      0x5c
+
+#define SW_THREADS 0       // CPU SGEMM thread 수 (0: 전체 core, standalone은 1)
+
+#define DONE_TIMEOUT 1000000000
+
+static const float GUARD = -1.0e9f;       // C padding column 값 (IP가 건드리면 안 됨)
+
+static inline int idx(int r,int c,int ld){ return r*ld+c; }   // row-major 주소 index
+
+static inline double cycles_to_us(XTime c){
+    return (double)c * 2.0 * 1e6 / XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ;
+}
+
+static void flush(void* p,int sz){ Xil_DCacheFlushRange((UINTPTR)p,sz); }    // Cache Flush for READs
+static void inval(void* p,int sz){ Xil_DCacheInvalidateRange((UINTPTR)p,sz); }    // Cache Invalidate for WRITEs
+
+// 64-bit m_axi 주소 register (A9에서는 high word = 0)
+static void set_addr(u32 reg, const void *p){
+    u64 a = (u64)(UINTPTR)p;
+    Xil_Out32(GEMM_CTRL_BASE+reg,   (u32)a);
+    Xil_Out32(GEMM_CTRL_BASE+reg+4, (u32)(a >> 32));
+}
+
+// ---------------- HW GEMM: start 1회 / done 1회 ----------------
+static int gemm_hw(const float *A, const float *B, float *C){
+    // (1) IP가 DDR에서 직접 읽으므로 A, B를 flush.
+    //     C는 padding column까지 flush(clean + invalidate) → dirty line이 결과를 덮어쓰지 않게
+    flush((void*)A, M*LDA*sizeof(float));
+    flush((void*)B, K*LDB*sizeof(float));
+    flush(C, M*LDC*sizeof(float));
+
+    // (2) 주소 / shape / leading dimension
+    set_addr(REG_A, A);
+    set_addr(REG_B, B);
+    set_addr(REG_C, C);
+    Xil_Out32(GEMM_CTRL_BASE+REG_M,   M);
+    Xil_Out32(GEMM_CTRL_BASE+REG_N,   N);
+    Xil_Out32(GEMM_CTRL_BASE+REG_K,   K);
+    Xil_Out32(GEMM_CTRL_BASE+REG_LDA, LDA);
+    Xil_Out32(GEMM_CTRL_BASE+REG_LDB, LDB);
+    Xil_Out32(GEMM_CTRL_BASE+REG_LDC, LDC);
+
+    // (3) start → 모든 output tile 처리 후 done
+    Xil_Out32(GEMM_CTRL_BASE+REG_AP_CTRL, AP_START);
+
+    int t=DONE_TIMEOUT;
+    while(!(Xil_In32(GEMM_CTRL_BASE+REG_AP_CTRL) & AP_DONE) && t--);
+    if (t<=0) return -1;
+
+    // (4) IP가 쓴 C를 CPU가 읽기 전에 invalidate (speculative fill 대비)
+    inval(C, M*LDC*sizeof(float));
+    return 0;
+}
+
+int main(){
+    if (M == N && K == N && LD_PAD == 0)
+        printf("\n===== GEMM m_axi (N=%d) =====\n", N);
+    else
+        printf("\n===== GEMM m_axi (M=%d, K=%d, N=%d, ld +%d) =====\n", M, K, N, LD_PAD);
+
+    static float A[MAXN*(MAXN+64)] __attribute__((aligned(64)));
+    static float B[MAXN*(MAXN+64)] __attribute__((aligned(64)));
+    static float Csw[MAXN*MAXN] __attribute__((aligned(64)));
+    static float Chw[MAXN*(MAXN+64)] __attribute__((aligned(64)));
+
+    for(int i=0;i<M;i++)
+        for(int j=0;j<LDA;j++)
+            A[idx(i,j,LDA)] = (j < K) ? i + j*0.1f : NAN;     // padding은 읽히면 안 됨
+    for(int i=0;i<K;i++)
+        for(int j=0;j<LDB;j++)
+            B[idx(i,j,LDB)] = (j < N) ? j + i*0.2f : NAN;
+    for(int i=0;i<M*LDC;i++)
+        Chw[i] = GUARD;
+
+    // SW: packed panel + SIMD micro-kernel + threads
+    XTime t0,t1;
+    sgemm_set_impl(SGEMM_SIMD);
+    sgemm_set_threads(SW_THREADS);
+    XTime_GetTime(&t0);
+    sgemm_cpu(M,N,K, A,LDA, B,LDB, Csw,N);
+    XTime_GetTime(&t1);
+    double sw_us=cycles_to_us(t1-t0);
+
+    // HW (packing / unpack 없음: 측정 구간 = cache 관리 + 실행)
+    XTime_GetTime(&t0);
+    if (gemm_hw(A, B, Chw) != 0) {
+        printf("AP_DONE timeout\n");
+        return -1;
+    }
+    XTime_GetTime(&t1);
+    double hw_us=cycles_to_us(t1-t0);
+
+    double flops = 2.0 * (double)M * (double)N * (double)K;
+    // A: row panel 당 1회 (K <= 768), B: output tile row마다 1회, C: 1회
+    double mt = (M+TILE-1)/TILE;
+    double a_reads = (K <= 48*TILE) ? 1.0 : (double)((N+TILE-1)/TILE);
+    double ddr_mb = ((double)M*K*a_reads + mt*K*N + (double)M*N) * sizeof(float) / 1e6;
+
+    printf("SW(%s x%d) %.3f us\n", sgemm_impl_name(SGEMM_SIMD), sgemm_get_threads(), sw_us);
+    printf("HW %.3f us\n", hw_us);
+    printf("Speedup %.2fx\n", sw_us/hw_us);
+    printf("GFLOPS %.3f\n", flops/(hw_us*1e-6)/1e9);
+    printf("m_axi traffic %.3f MB\n", ddr_mb);
+
+    // 결과 검증 (SW 기준) + padding column 보존 확인
+    float max_err=0;
+    int guard_bad=0;
+    for(int i=0;i<M;i++)
+        for(int j=0;j<LDC;j++){
+            float c = Chw[idx(i,j,LDC)];
+            if (j >= N) { if (c != GUARD) guard_bad++; continue; }
+            float e=fabsf(c-Csw[idx(i,j,N)]);
+            if(e>max_err) max_err=e;
+        }
+    printf("max_abs_err %.6f\n", max_err);
+    if (guard_bad) printf("C padding overwritten: %d\n", guard_bad);
+
+    return 0;
+}
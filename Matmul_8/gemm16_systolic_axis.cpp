@@ -0,0 +1,145 @@
+// ================================================================
+// gemm16_systolic_axis.cpp  (systolic PE-grid GEMM16)
+//  - Target: Zynq-7000 (xc7z020) @ 100MHz class
+//  - AXI4-Stream in/out, 32 / 128-bit TDATA (1 / 4 floats per beat)
+//  - AXI-Lite control: Ktiles
+//
+//  - Same IP contract as Matmul_3 (drop-in for its host.c / DMA):
+//      Input:  Ktiles frames, each frame = A16(256) + B16(256) words
+//      Output: C16(256) words, TLAST asserted on last output word
+//
+//  - Compute core: SA_PR x SA_PC systolic PE grid (HLS_Common/
+//    gemm_systolic.h) instead of the adder-tree MAC of gemm_mac_tile.
+//    Each PE does one float multiply-add per cycle and only talks to
+//    its neighbours, so the fan-out / routing of the tree (16 A and
+//    16 B operands into one 16-input tree every cycle) is replaced by
+//    PR*PC short local hops
+//      SA_DF = GEMM_SA_OS : output stationary, accumulators stay in the
+//                           PEs for all Ktiles frames
+//      SA_DF = GEMM_SA_WS : weight stationary, B sub-block held in the
+//                           PEs, partial sums flow down the columns
+//
+//  - Cycles per frame (16 x 16 x 16, pipeline fill not included):
+//        PE grid      OS     WS
+//        4 x 4       262    304
+//        8 x 8        78     92      (default)
+//        16 x 16      46     31
+//    recv of a frame: 512 beats (32-bit) / 128 beats (128-bit)
+//
+//  - Pipeline structure: recv frame k+1 || PE grid on frame k
+//    (stream_of_blocks ping-pong task pipeline, as Matmul_4), so the
+//    grid is hidden behind the stream as long as its cycles stay
+//    below the recv beats
+//
+//  - Build: -cflags "-I../HLS_Common [-DSA_PR=.. -DSA_PC=.. -DSA_DF=..]"
+// ================================================================
+
+#include <hls_stream.h>
+#include <ap_int.h>
+#include <ap_axi_sdata.h>
+#include <stdint.h>
+
+#include "gemm_tile.h"       // HLS_Common: gemm_recv_frames, gemm_send_tile
+#include "gemm_systolic.h"   // HLS_Common: systolic PE grid
+
+#define N 16
+
+#ifndef SA_PR
+#define SA_PR 8              // PE rows
+#endif
+#ifndef SA_PC
+#define SA_PC 8              // PE columns
+#endif
+#ifndef SA_DF
+#define SA_DF GEMM_SA_OS     // GEMM_SA_OS / GEMM_SA_WS
+#endif
+
+typedef axis_w<32> axis_t;
+typedef gemm_sa_shape<N, N, SA_PR, SA_PC> sa_shape;
+typedef gemm_blocks<N, N, N, float> blk;
+
+// ------------------------------
+// PE grid over all Ktiles frames (DATAFLOW process): the OS
+// accumulators live here for the whole run
+// ------------------------------
+static void sa_frames(
+    hls::stream_of_blocks<blk::a_t>& a_blocks,
+    hls::stream_of_blocks<blk::b_t>& b_blocks,
+    float                            C[N][N],
+    int                              Ktiles)
+{
+    float acc[sa_shape::KS][sa_shape::NBLK][SA_PR][SA_PC];
+
+    if (SA_DF == GEMM_SA_OS) {
+        gemm_sa_os_clear<N, N, SA_PR, SA_PC, float>(acc);
+    } else {
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+#pragma HLS PIPELINE II=1
+                C[i][j] = 0.0f;
+            }
+        }
+    }
+
+    for (int k = 0; k < Ktiles; k++) {
+        hls::read_lock<blk::a_t> A(a_blocks);
+        hls::read_lock<blk::b_t> B(b_blocks);
+        if (SA_DF == GEMM_SA_OS)
+            gemm_sa_os_frame<N, N, N, SA_PR, SA_PC, float>(A, B, acc);
+        else
+            gemm_sa_ws_frame<N, N, N, SA_PR, SA_PC, float>(A, B, C);
+    }
+
+    if (SA_DF == GEMM_SA_OS) gemm_sa_os_drain<N, N, SA_PR, SA_PC, float>(acc, C);
+}
+
+// ------------------------------
+// GEMM16 on the PE grid, W-bit stream:
+//   gemm_recv_frames --[A / B blocks]--> sa_frames --[C]--> gemm_send_tile
+// ------------------------------
+template<int W>
+static void gemm16_systolic_w(
+    hls::stream<axis_w<W> >& s_in,
+    hls::stream<axis_w<W> >& s_out,
+    int Ktiles
+){
+#pragma HLS DATAFLOW
+    hls::stream_of_blocks<blk::a_t> a_blocks;     // depth 2 = ping-pong
+    hls::stream_of_blocks<blk::b_t> b_blocks;
+    float C[N][N];
+
+    gemm_recv_frames<N, N, N, W, float>(s_in, a_blocks, b_blocks, Ktiles);
+    sa_frames(a_blocks, b_blocks, C, Ktiles);
+    gemm_send_tile<N, N, W, float>(s_out, C);
+}
+
+// ------------------------------
+// Top functions (one per stream width)
+// ------------------------------
+void gemm16_systolic_axis(
+    hls::stream<axis_t>& s_in,
+    hls::stream<axis_t>& s_out,
+    int Ktiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    if (Ktiles <= 0) return;
+    gemm16_systolic_w<32>(s_in, s_out, Ktiles);
+}
+
+void gemm16_systolic_axis_x128(
+    hls::stream<axis_w<128> >& s_in,
+    hls::stream<axis_w<128> >& s_out,
+    int Ktiles
+){
+#pragma HLS INTERFACE axis register_mode=both port=s_in
+#pragma HLS INTERFACE axis register_mode=both port=s_out
+#pragma HLS INTERFACE s_axilite port=Ktiles bundle=CTRL
+#pragma HLS INTERFACE s_axilite port=return bundle=CTRL
+
+    if (Ktiles <= 0) return;
+    gemm16_systolic_w<128>(s_in, s_out, Ktiles);
+}
@@ -0,0 +1,619 @@
+// ================================================================
+// gemm_perf_model.cpp  (cycle-approximate Zybo timing model)
+//  - Predicts per-tile and end-to-end latency of the Matmul_3/4
+//    host.c protocol without hardware:
+//      per output tile: S2MM submit, AP start,
+//                       Ktiles x [extract/memcpy, flush, MM2S, poll],
+//                       S2MM wait, ap_done poll, inval, store_block
+//  - Host protocols (-p):
+//      extract : extract_block + memcpy into frame_buf per frame (README runs)
+//      packed  : A/B packed once (gemm_pack), frame = A tile + B tile
+//                transfers from the packed buffers, C unpacked once
+//      async   : packed + IRQ-chained simple transfers, IP in auto-restart:
+//                each transfer waits for the previous one's ISR + submit
+//      sg      : packed + scatter-gather BD rings, IP in auto-restart:
+//                the stream never waits on the host, unless filling
+//                BDs is slower than the PL consumes them
+//  - --set multi_tile=1 (m4, async / sg): one Ntiles run for the whole
+//    C instead of auto-restart; send_result of tile t overlaps tile
+//    t+1 (two C accumulators), only the last tile's send is exposed
+//  - --set cblock=2 (with multi_tile): cblock x cblock C tile blocks,
+//    per K step cblock A + cblock B tiles feed cblock^2 mac_tile runs;
+//    results are reported per output tile (block / cblock^2)
+//  - Kernel stages use trip count / II / depth of the HLS loops
+//    (CLEAR_C, recv_tile, mac_tile, send_result)
+//  - extract / store costs are fitted to the README tables at
+//    N = 128, 512 only; N = 32, 64, 256, 768 are held out for validation
+//  - Reports the critical path of one output tile stage by stage
+//
+//  Build: g++ -O2 -o gemm_perf_model gemm_perf_model.cpp
+//  Usage: gemm_perf_model                      (validation table)
+//         gemm_perf_model -v m4 -n 512         (breakdown)
+//         gemm_perf_model -v m3 -n 256 --set pl_mhz=150 --set beats_per_cycle=2
+//         gemm_perf_model -v m4 -n 512 -p packed
+// ================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// ------------------------------
+// Model parameters
+// ------------------------------
+struct LoopSpec {
+    const char *name;
+    int trip;       // iterations
+    int ii;         // initiation interval
+    int depth;      // pipeline depth (cycles)
+};
+
+struct Params {
+    // PL / interconnect
+    double pl_mhz;              // kernel + AXIS clock
+    double beats_per_cycle;     // AXIS beats accepted per PL cycle (32-bit words)
+    double dma_latency_us;      // MM2S submit -> first beat at s_in
+    double dma_submit_us;       // XAxiDma_SimpleTransfer() call (driver + 3 reg writes)
+    double axil_write_us;       // Xil_Out32 over M_AXI_GP0
+    double axil_read_us;        // Xil_In32 / XAxiDma_Busy poll round trip
+    double df_overhead_cyc;     // DATAFLOW region start/stop per run (Matmul_4)
+    double multi_tile;          // != 0: Matmul_4 Ntiles run, async / sg hosts
+    double cblock;              // Ntiles run: C block side in tiles (register blocking)
+
+    // host (Cortex-A9 @ 667 MHz, standalone BSP)
+    double extract_ns_per_word; // extract_block strided gather
+    double memcpy_ns_per_word;  // frame_buf memcpy
+    double store_ns_per_word;   // store_block strided scatter
+    double pack_ns_per_word;    // gemm_pack_tiles (64 B row memcpy), once per GEMM
+    double unpack_ns_per_word;  // gemm_unpack_tiles, once per GEMM
+    double bd_fill_us;          // SG: fill one BD (addr/len/ctrl) + amortised ToHw / reclaim
+    double irq_us;              // async: IRQ entry + GIC dispatch + ack, before the next submit
+    double flush_ns_per_line;   // Xil_DCacheFlushRange, L1+L2 by MVA
+    double inval_ns_per_line;   // Xil_DCacheInvalidateRange
+    double cacheline;           // bytes
+
+    // HLS loops (per frame / per tile)
+    LoopSpec clear_c;
+    LoopSpec recv_tile;
+    LoopSpec mac_tile;
+    LoopSpec send_result;
+};
+
+static Params default_params(void){
+    Params p;
+    p.pl_mhz              = 100.0;
+    p.beats_per_cycle     = 1.0;
+    p.dma_latency_us      = 0.5;
+    p.dma_submit_us       = 3.0;
+    p.axil_write_us       = 0.3;
+    p.axil_read_us        = 0.3;
+    p.df_overhead_cyc     = 4;
+    p.multi_tile          = 0;
+    p.cblock              = 1;
+
+    p.extract_ns_per_word = 78.7;   // calibrate() on N = 128, 512
+    p.memcpy_ns_per_word  = 4.0;
+    p.store_ns_per_word   = 154.0;  // calibrate() on N = 128, 512
+    p.pack_ns_per_word    = 12.0;
+    p.unpack_ns_per_word  = 12.0;
+    p.bd_fill_us          = 0.4;
+    p.irq_us              = 1.0;
+    p.flush_ns_per_line   = 110.0;
+    p.inval_ns_per_line   = 110.0;
+    p.cacheline           = 32;
+
+    p.clear_c     = LoopSpec{ "CLEAR_C",     256, 1,  2 };
+    p.recv_tile   = LoopSpec{ "recv_tile",   512, 1,  3 };
+    p.mac_tile    = LoopSpec{ "mac_tile",    256, 1, 28 };
+    p.send_result = LoopSpec{ "send_result", 256, 1,  3 };
+    return p;
+}
+
+static int set_param(Params &p, const char *kv){
+    char key[64];
+    const char *eq = strchr(kv, '=');
+    if (!eq || eq - kv >= (long)sizeof(key)) return -1;
+    memcpy(key, kv, eq - kv);
+    key[eq - kv] = 0;
+    double v = atof(eq + 1);
+
+    struct { const char *name; double *dst; } scalars[] = {
+        { "pl_mhz",              &p.pl_mhz },
+        { "beats_per_cycle",     &p.beats_per_cycle },
+        { "dma_latency_us",      &p.dma_latency_us },
+        { "dma_submit_us",       &p.dma_submit_us },
+        { "axil_write_us",       &p.axil_write_us },
+        { "axil_read_us",        &p.axil_read_us },
+        { "df_overhead_cyc",     &p.df_overhead_cyc },
+        { "multi_tile",          &p.multi_tile },
+        { "cblock",              &p.cblock },
+        { "extract_ns_per_word", &p.extract_ns_per_word },
+        { "memcpy_ns_per_word",  &p.memcpy_ns_per_word },
+        { "store_ns_per_word",   &p.store_ns_per_word },
+        { "pack_ns_per_word",    &p.pack_ns_per_word },
+        { "unpack_ns_per_word",  &p.unpack_ns_per_word },
+        { "bd_fill_us",          &p.bd_fill_us },
+        { "irq_us",              &p.irq_us },
+        { "flush_ns_per_line",   &p.flush_ns_per_line },
+        { "inval_ns_per_line",   &p.inval_ns_per_line },
+        { "cacheline",           &p.cacheline },
+    };
+    for (size_t i = 0; i < sizeof(scalars)/sizeof(scalars[0]); i++)
+        if (!strcmp(key, scalars[i].name)) { *scalars[i].dst = v; return 0; }
+
+    // <loop>.ii / <loop>.depth / <loop>.trip
+    LoopSpec *loops[] = { &p.clear_c, &p.recv_tile, &p.mac_tile, &p.send_result };
+    const char *dot = strchr(key, '.');
+    if (!dot) return -1;
+    for (size_t i = 0; i < sizeof(loops)/sizeof(loops[0]); i++) {
+        if (strncmp(key, loops[i]->name, dot - key) || strlen(loops[i]->name) != (size_t)(dot - key))
+            continue;
+        if (!strcmp(dot + 1, "ii"))    { loops[i]->ii    = (int)v; return 0; }
+        if (!strcmp(dot + 1, "depth")) { loops[i]->depth = (int)v; return 0; }
+        if (!strcmp(dot + 1, "trip"))  { loops[i]->trip  = (int)v; return 0; }
+    }
+    return -1;
+}
+
+// ------------------------------
+// Kernel variants
+// ------------------------------
+enum Variant {
+    VAR_M3,     // Matmul_3 gemm16_accum_axis   : recv A,B -> mac, sequential
+    VAR_M4      // Matmul_4 gemm16_accum_axis_db: task pipeline, recv(k+1) || mac(k)
+                //   through two ping-pong blocks, CLEAR_C || recv(0)
+};
+
+static const char *variant_name(Variant v){
+    return (v == VAR_M3) ? "m3" : "m4";
+}
+
+// ------------------------------
+// Host protocols
+// ------------------------------
+enum HostProto {
+    HOST_EXTRACT,   // extract_block x2 + memcpy -> frame_buf, 1 MM2S per frame
+    HOST_PACKED,    // packed A/B tiles, 2 MM2S (A tile, B tile) per frame
+    HOST_ASYNC,     // packed A/B tiles, 2 MM2S per frame started from the DMA IRQ
+    HOST_SG         // packed A/B tiles, 2 BDs per frame, BD chains + auto-restart
+};
+
+static const char *proto_name(HostProto h){
+    switch (h) {
+    case HOST_EXTRACT: return "extract";
+    case HOST_PACKED:  return "packed";
+    case HOST_ASYNC:   return "async";
+    default:           return "sg";
+    }
+}
+
+// ------------------------------
+// Critical path bookkeeping
+// ------------------------------
+struct CritPath {
+    std::vector<std::string> stage;
+    std::vector<double>      us;
+
+    void add(const char *name, double d){
+        if (d <= 0) return;
+        for (size_t i = 0; i < stage.size(); i++)
+            if (stage[i] == name) { us[i] += d; return; }
+        stage.push_back(name);
+        us.push_back(d);
+    }
+
+    void scale(double f){
+        for (size_t i = 0; i < us.size(); i++) us[i] *= f;
+    }
+};
+
+struct TileResult {
+    double tile_us;       // one output tile, host view
+    double pl_busy_us;    // kernel busy (recv + mac + clear + send)
+    double axis_busy_us;  // MM2S/S2MM beats on the wire
+    CritPath crit;
+};
+
+static double loop_us(const Params &p, const LoopSpec &l){
+    return ((double)(l.trip - 1) * l.ii + l.depth) / p.pl_mhz;
+}
+
+static double recv_us(const Params &p){
+    // the kernel accepts one beat per II, the link delivers beats_per_cycle
+    double cyc_kernel = (double)(p.recv_tile.trip - 1) * p.recv_tile.ii;
+    double cyc_link   = (double)p.recv_tile.trip / p.beats_per_cycle;
+    return (std::max(cyc_kernel, cyc_link) + p.recv_tile.depth) / p.pl_mhz;
+}
+
+// Matmul_4 Ntiles run: tiles follow each other inside one DATAFLOW region
+static bool multi_run(const Params &p, Variant v, HostProto h){
+    return p.multi_tile != 0 && v == VAR_M4 && (h == HOST_SG || h == HOST_ASYNC);
+}
+
+// tiles per C block (cblock^2) of an Ntiles run, 1 otherwise
+static int block_tiles(const Params &p, Variant v, HostProto h){
+    int cb = multi_run(p, v, h) ? std::max(1, (int)p.cblock) : 1;
+    return cb * cb;
+}
+
+// ------------------------------
+// One output tile, SG / async mode: the PL restarts itself and the
+// host only has to keep the queue ahead. SG streams frames back to
+// back; async loses one IRQ + submit between consecutive transfers.
+// Ntiles run: no restart, and send_result of this tile runs in the
+// next tile's frames (other C accumulator); its tail is counted once
+// per GEMM (model_total_us). With cblock the loop models one C block
+// and the result is scaled back to one output tile
+// ------------------------------
+static TileResult model_tile_sg(const Params &p, Variant v, HostProto h, int Ktiles){
+    TileResult r = TileResult();
+    CritPath &cp = r.crit;
+
+    // C block of nt = cb x cb tiles: cb A + cb B tiles per K step
+    const int    nt = block_tiles(p, v, h);
+    const int    cb = (nt > 1) ? (int)p.cblock : 1;
+
+    const double t_clear = loop_us(p, p.clear_c) * nt;
+    const double t_recv  = recv_us(p) * cb;
+    const double t_mac   = loop_us(p, p.mac_tile) * nt;
+    const double t_send  = loop_us(p, p.send_result) * nt;
+    const double t_df    = p.df_overhead_cyc / p.pl_mhz;
+
+    // auto-restart: the run starts right after the previous send_result.
+    // m3 clears C before the first recv, m4 clears it in mac_frames
+    const bool multi = multi_run(p, v, h);
+    double kr      = (v == VAR_M3) ? t_clear : (multi ? 0 : t_df);
+    double mac_end = (v == VAR_M3) ? 0 : kr + t_clear;
+    double blk_free[2] = { 0, 0 };     // m4: ping / pong block released by mac
+    cp.add((v == VAR_M3) ? "CLEAR_C" : "DATAFLOW region start", kr);
+
+    // async: every A and B tile transfer starts from the previous IRQ
+    const double gap = (h == HOST_ASYNC) ? 2 * cb * (p.irq_us + p.dma_submit_us) : 0;
+
+    for (int k = 0; k < Ktiles; k++) {
+        if (v == VAR_M4 && blk_free[k & 1] > kr) {
+            cp.add("ping-pong full (mac_tile)", blk_free[k & 1] - kr);
+            kr = blk_free[k & 1];
+        }
+        double recv_end = kr + gap + t_recv;
+        cp.add("IRQ + DMA submit (transfer gap)", gap);
+        cp.add("MM2S stream (recv_tile)", t_recv);
+        r.axis_busy_us += t_recv;
+        r.pl_busy_us   += t_recv + t_mac;
+
+        if (v == VAR_M3) {
+            kr = recv_end + t_mac;
+            cp.add("mac_tile (kernel not receiving)", t_mac);
+        } else {
+            // mac(k) needs block k and mac(k-1) done; recv(k+1) goes on
+            mac_end = std::max(recv_end, mac_end) + t_mac;
+            blk_free[k & 1] = mac_end;
+            kr = recv_end;
+        }
+    }
+
+    double kernel_done;
+    if (v == VAR_M3) kernel_done = kr + t_send;
+    else if (multi)  kernel_done = std::max(kr, mac_end);
+    else             kernel_done = std::max(kr, mac_end) + t_send + t_df;
+    cp.add(multi ? "mac_tile (tail)" : "mac_tile + send_result (tail)", kernel_done - kr);
+    r.pl_busy_us   += t_clear + t_send;
+    r.axis_busy_us += t_send;
+
+    // host: 2*cb MM2S BDs per K step + 1 S2MM BD per tile (async: queue entries, negligible)
+    double host = (h == HOST_SG) ? (2.0 * cb * Ktiles + nt) * p.bd_fill_us : 0;
+    if (host > kernel_done) cp.add("host BD fill (ring refill)", host - kernel_done);
+
+    r.tile_us       = std::max(kernel_done, host) / nt;
+    r.pl_busy_us   /= nt;
+    r.axis_busy_us /= nt;
+    cp.scale(1.0 / nt);
+    return r;
+}
+
+// ------------------------------
+// One output tile (bi,bj) of the Matmul_3/4 host.c protocol
+// ------------------------------
+static TileResult model_tile(const Params &p, Variant v, HostProto h, int Ktiles){
+    if (h == HOST_SG || h == HOST_ASYNC) return model_tile_sg(p, v, h, Ktiles);
+
+    TileResult r = TileResult();
+    CritPath &cp = r.crit;
+
+    const double words_tile  = 256;
+    const double words_frame = 512;
+    const double lines_tile  = words_tile  * 4 / p.cacheline;
+    const int    nxfer       = (h == HOST_EXTRACT) ? 1 : 2;   // MM2S transfers per frame
+    const double words_xfer  = words_frame / nxfer;
+    const double lines_xfer  = words_xfer * 4 / p.cacheline;
+
+    const double t_clear = loop_us(p, p.clear_c);
+    const double t_recv  = recv_us(p);
+    const double t_mac   = loop_us(p, p.mac_tile);
+    const double t_send  = loop_us(p, p.send_result);
+    const double t_df    = p.df_overhead_cyc / p.pl_mhz;
+
+    double t = 0;           // host clock
+    double kr;              // kernel ready to accept the next frame
+    double kernel_done;     // last C word written to S2MM
+
+    // (1) S2MM submit (out_buf invalidate + SimpleTransfer)
+    t += lines_tile * p.inval_ns_per_line * 1e-3;  cp.add("cache flush/inval",  lines_tile * p.inval_ns_per_line * 1e-3);
+    t += p.dma_submit_us;                          cp.add("DMA submit",         p.dma_submit_us);
+
+    // (2) IP start
+    t += p.axil_write_us;                          cp.add("AXI-Lite start/poll", p.axil_write_us);
+    kr = t + ((v == VAR_M3) ? t_clear : t_df);      // m4: CLEAR_C runs in mac_frames
+
+    // (3) Ktiles frames
+    double mac_end = kr + ((v == VAR_M3) ? 0 : t_clear);   // Matmul_4: mac(k-1) completion
+    double blk_free[2] = { 0, 0 };                           // Matmul_4: ping / pong block released
+    for (int k = 0; k < Ktiles; k++) {
+        if (h == HOST_EXTRACT) {
+            double pack = words_frame * p.extract_ns_per_word * 1e-3
+                        + words_frame * p.memcpy_ns_per_word  * 1e-3;
+            t += pack;        cp.add("host pack (extract_block+memcpy)", pack);
+        }
+
+        // one frame = nxfer MM2S transfers, each flushed / submitted / polled
+        double recv_end = 0;
+        for (int x = 0; x < nxfer; x++) {
+            double flush = lines_xfer * p.flush_ns_per_line * 1e-3;
+            double seg   = t_recv * words_xfer / words_frame;
+            t += flush;           cp.add("cache flush/inval", flush);
+            t += p.dma_submit_us; cp.add("DMA submit", p.dma_submit_us);
+
+            double data_ready = t + p.dma_latency_us;
+            double gate  = (x == 0) ? ((v == VAR_M3) ? kr : std::max(kr, blk_free[k & 1])) : recv_end;
+            double start = std::max(data_ready, gate);
+            if (gate > data_ready) {
+                cp.add((v == VAR_M3) ? "mac_tile (kernel not receiving)" : "ping-pong full (mac_tile)", gate - data_ready);
+                cp.add("DMA latency", p.dma_latency_us - std::min(p.dma_latency_us, gate - t));
+            } else {
+                cp.add("DMA latency", p.dma_latency_us);
+            }
+            recv_end = start + seg;
+            cp.add("MM2S stream (recv_tile)", seg);
+            r.axis_busy_us += seg;
+            r.pl_busy_us   += seg;
+
+            // host busy-waits on MM2S: resolves at recv_end, one poll granularity
+            t = recv_end + p.axil_read_us;         cp.add("DMA poll", p.axil_read_us);
+        }
+
+        if (v == VAR_M3) {
+            kr = recv_end + t_mac;
+            r.pl_busy_us += t_mac;
+        } else {
+            // mac(k) after recv(k) and mac(k-1); recv(k+1) needs block k+1 free
+            mac_end = std::max(recv_end, mac_end) + t_mac;
+            blk_free[k & 1] = mac_end;
+            kr = recv_end;
+            r.pl_busy_us += t_mac;
+        }
+    }
+
+    // (4) kernel tail: last mac and send_result (+ region end)
+    if (v == VAR_M3) kernel_done = kr + t_send;
+    else             kernel_done = std::max(kr, mac_end) + t_send + t_df;
+    r.pl_busy_us   += t_clear + t_send;
+    r.axis_busy_us += t_send;
+
+    if (kernel_done > t) {
+        cp.add("mac_tile + send_result (tail)", kernel_done - t);
+        t = kernel_done;
+    }
+    t += p.axil_read_us;                           cp.add("DMA poll", p.axil_read_us);
+
+    // (5) ap_done poll
+    t += p.axil_read_us;                           cp.add("AXI-Lite start/poll", p.axil_read_us);
+
+    // (6) invalidate (+ store_block)
+    t += lines_tile * p.inval_ns_per_line * 1e-3;  cp.add("cache flush/inval", lines_tile * p.inval_ns_per_line * 1e-3);
+    if (h == HOST_EXTRACT) {
+        t += words_tile * p.store_ns_per_word * 1e-3;
+        cp.add("host unpack (store_block)", words_tile * p.store_ns_per_word * 1e-3);
+    }
+
+    r.tile_us = t;
+    return r;
+}
+
+// one-time gemm_pack_tiles (A, B) + gemm_unpack_tiles (C)
+// (SG / async: + whole-matrix flush of packed A, B and invalidate of packed C;
+//  async overlaps A packing / C unpacking with the stream but keeps B)
+static double model_once_us(const Params &p, HostProto h, int n){
+    if (h == HOST_EXTRACT) return 0;
+    double nn = (double)n * n;
+    double us = (2 * nn * p.pack_ns_per_word + nn * p.unpack_ns_per_word) * 1e-3;
+    if (h == HOST_ASYNC)
+        us = (nn * p.pack_ns_per_word + 16.0 * n * (p.pack_ns_per_word + p.unpack_ns_per_word)) * 1e-3;
+    if (h == HOST_SG || h == HOST_ASYNC) {
+        double lines = nn * 4 / p.cacheline;
+        us += (2 * lines * p.flush_ns_per_line + 2 * lines * p.inval_ns_per_line) * 1e-3;
+    }
+    return us;
+}
+
+// Ntiles run: send_result of the last tile + region end, once per GEMM
+static double model_last_send_us(const Params &p, Variant v, HostProto h){
+    if (!multi_run(p, v, h)) return 0;
+    return loop_us(p, p.send_result) * block_tiles(p, v, h) + p.df_overhead_cyc / p.pl_mhz;
+}
+
+static double model_total_us(const Params &p, Variant v, HostProto h, int n){
+    int nb = n / 16;
+    TileResult r = model_tile(p, v, h, nb);
+    return r.tile_us * (double)nb * (double)nb + model_last_send_us(p, v, h) + model_once_us(p, h, n);
+}
+
+// ------------------------------
+// Published numbers (README, Zybo Z7-20)
+// ------------------------------
+struct Published { Variant v; int n; double hw_us; };
+
+static const Published published[] = {
+    { VAR_M3,  32,     733.920 }, { VAR_M3,  64,    4755.468 },
+    { VAR_M3, 128,   33771.578 }, { VAR_M3, 256,  252812.164 },
+    { VAR_M3, 512, 1974236.946 }, { VAR_M3, 768, 6980534.175 },
+    { VAR_M4,  32,     689.484 }, { VAR_M4,  64,    4584.267 },
+    { VAR_M4, 128,   33089.075 }, { VAR_M4, 256,  250098.724 },
+    { VAR_M4, 512, 1963059.060 }, { VAR_M4, 768, 6956165.734 },
+};
+
+// ------------------------------
+// Calibration: the two host costs that set the slope are least-squares
+// fitted (relative error) on FIT_N only; the other sizes are held out
+// ------------------------------
+static const int FIT_N[] = { 128, 512 };
+
+static bool is_fit_point(int n){
+    for (size_t i = 0; i < sizeof(FIT_N)/sizeof(FIT_N[0]); i++)
+        if (FIT_N[i] == n) return true;
+    return false;
+}
+
+// Fits extract_ns_per_word (per frame) and store_ns_per_word (per tile).
+// The README runs are host-bound, so the model is linear in both:
+// finite-difference slopes + 2x2 normal equations, repeated once
+static Params calibrate(Params p){
+    const double d = 1.0;
+    for (int iter = 0; iter < 2; iter++) {
+        double aa = 0, ab = 0, bb = 0, ar = 0, br = 0;
+        for (size_t i = 0; i < sizeof(published)/sizeof(published[0]); i++) {
+            const Published &b = published[i];
+            if (!is_fit_point(b.n)) continue;
+            Params pe = p; pe.extract_ns_per_word += d;
+            Params ps = p; ps.store_ns_per_word   += d;
+            double m0 = model_total_us(p,  b.v, HOST_EXTRACT, b.n);
+            double ga = (model_total_us(pe, b.v, HOST_EXTRACT, b.n) - m0) / d / b.hw_us;
+            double gb = (model_total_us(ps, b.v, HOST_EXTRACT, b.n) - m0) / d / b.hw_us;
+            double r  = (b.hw_us - m0) / b.hw_us;
+            aa += ga * ga; ab += ga * gb; bb += gb * gb;
+            ar += ga * r;  br += gb * r;
+        }
+        double det = aa * bb - ab * ab;
+        if (det == 0) break;
+        p.extract_ns_per_word += (bb * ar - ab * br) / det;
+        p.store_ns_per_word   += (aa * br - ab * ar) / det;
+    }
+    return p;
+}
+
+static void print_validation(const Params &p0){
+    Params p = calibrate(p0);
+    printf("\n===== Validation vs README (Matmul_3 / Matmul_4) =====\n");
+    printf("fit on N =");
+    for (size_t i = 0; i < sizeof(FIT_N)/sizeof(FIT_N[0]); i++) printf(" %d", FIT_N[i]);
+    printf(": extract_ns_per_word %.1f, store_ns_per_word %.1f\n",
+           p.extract_ns_per_word, p.store_ns_per_word);
+    printf("%-4s %5s %-8s %14s %14s %8s %8s\n", "var", "N", "set", "model(us)", "board(us)", "err%", "GFLOPS");
+    double worst = 0;
+    for (size_t i = 0; i < sizeof(published)/sizeof(published[0]); i++) {
+        const Published &b = published[i];
+        bool   fit = is_fit_point(b.n);
+        double us  = model_total_us(p, b.v, HOST_EXTRACT, b.n);
+        double err = (us - b.hw_us) / b.hw_us * 100.0;
+        double gf  = 2.0 * b.n * (double)b.n * b.n / (us * 1e-6) / 1e9;
+        printf("%-4s %5d %-8s %14.1f %14.1f %+8.2f %8.3f\n",
+               variant_name(b.v), b.n, fit ? "fit" : "held-out", us, b.hw_us, err, gf);
+        if (!fit) worst = std::max(worst, err < 0 ? -err : err);
+    }
+    printf("held-out max |err| %.2f%%\n", worst);
+}
+
+static void print_breakdown(const Params &p, Variant v, HostProto h, int n){
+    int nb = n / 16;
+    TileResult r = model_tile(p, v, h, nb);
+    double once  = model_once_us(p, h, n);
+    double last  = model_last_send_us(p, v, h);
+    double total = r.tile_us * (double)nb * (double)nb + last + once;
+    double flops = 2.0 * n * (double)n * n;
+
+    printf("\n===== %s / %s host, N=%d (Ktiles=%d, %d output tiles) =====\n",
+           variant_name(v), proto_name(h), n, nb, nb*nb);
+    printf("PL %.1f MHz, %.2f beats/cycle\n", p.pl_mhz, p.beats_per_cycle);
+    printf("\nKernel stages (per frame / per tile):\n");
+    printf("  %-12s %6.2f us\n", p.clear_c.name,     loop_us(p, p.clear_c));
+    printf("  %-12s %6.2f us\n", p.recv_tile.name,   recv_us(p));
+    printf("  %-12s %6.2f us\n", p.mac_tile.name,    loop_us(p, p.mac_tile));
+    printf("  %-12s %6.2f us\n", p.send_result.name, loop_us(p, p.send_result));
+
+    printf("\nPer output tile : %.2f us\n", r.tile_us);
+    printf("  PL busy       : %.2f us (%.1f%%)\n", r.pl_busy_us,   100.0 * r.pl_busy_us   / r.tile_us);
+    printf("  AXIS busy     : %.2f us (%.1f%%)\n", r.axis_busy_us, 100.0 * r.axis_busy_us / r.tile_us);
+
+    printf("\nCritical path (one output tile):\n");
+    std::vector<size_t> order(r.crit.stage.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b){ return r.crit.us[a] > r.crit.us[b]; });
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t k = order[i];
+        printf("  %-36s %10.2f us  %5.1f%%\n",
+               r.crit.stage[k].c_str(), r.crit.us[k], 100.0 * r.crit.us[k] / r.tile_us);
+    }
+
+    if (last > 0)
+    printf("\nLast send_result (once)    : %.2f us\n", last);
+    if (once > 0)
+    printf("\nPack A,B + unpack C (once) : %.2f us\n", once);
+    printf("\nEnd-to-end     : %.3f ms\n", total * 1e-3);
+    printf("GFLOPS         : %.3f\n", flops / (total * 1e-6) / 1e9);
+}
+
+static void usage(const char *prog){
+    printf("usage: %s [-v m3|m4] [-p extract|packed|async|sg] [-n N] [--set key=value]... [--validate]\n", prog);
+    printf("  keys: pl_mhz beats_per_cycle dma_latency_us dma_submit_us axil_write_us axil_read_us\n");
+    printf("        df_overhead_cyc multi_tile cblock extract_ns_per_word memcpy_ns_per_word store_ns_per_word\n");
+    printf("        pack_ns_per_word unpack_ns_per_word bd_fill_us irq_us\n");
+    printf("        flush_ns_per_line inval_ns_per_line cacheline\n");
+    printf("        <loop>.trip|ii|depth  (CLEAR_C recv_tile mac_tile send_result)\n");
+}
+
+int main(int argc, char **argv){
+    Params p = default_params();
+    Variant v = VAR_M4;
+    HostProto h = HOST_EXTRACT;
+    int n = 0;
+    bool validate = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v") && i + 1 < argc) {
+            const char *s = argv[++i];
+            if      (!strcmp(s, "m3")) v = VAR_M3;
+            else if (!strcmp(s, "m4")) v = VAR_M4;
+            else { usage(argv[0]); return 1; }
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            const char *s = argv[++i];
+            if      (!strcmp(s, "extract")) h = HOST_EXTRACT;
+            else if (!strcmp(s, "packed"))  h = HOST_PACKED;
+            else if (!strcmp(s, "async"))   h = HOST_ASYNC;
+            else if (!strcmp(s, "sg"))      h = HOST_SG;
+            else { usage(argv[0]); return 1; }
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            n = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--set") && i + 1 < argc) {
+            if (set_param(p, argv[++i]) != 0) {
+                printf("unknown parameter: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--validate")) {
+            validate = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (n > 0 && n % 16 != 0) {
+        printf("N must be a multiple of 16\n");
+        return 1;
+    }
+
+    if (n > 0) print_breakdown(p, v, h, n);
+    if (n == 0 || validate) print_validation(p);
+    return 0;
+}